@@ -0,0 +1,104 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "../include/Shared.hpp"
+#include "../include/GameCommon.hpp"
+#include "../client/Interpolation.hpp"
+#include "../client/Prediction.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+using namespace CoinCollector;
+
+/**
+ * One world state per iteration on a synthetic clock: every remote
+ * entity gets a snapshot, then the frame samples all of them
+ */
+static void BM_InterpolationSnapshotAndSample(benchmark::State& state) {
+    const int entities = static_cast<int>(state.range(0));
+    InterpolationEngine engine;
+    std::vector<PlayerState> out(static_cast<size_t>(entities));
+
+    TimePoint base = std::chrono::steady_clock::now();
+    auto tickDuration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(FIXED_DT));
+    uint32_t tick = 0;
+
+    for (auto _ : state) {
+        TimePoint now = base + tickDuration * tick;
+        engine.observeServerTick(tick, now);
+        for (int i = 0; i < entities; ++i) {
+            PlayerState player(static_cast<PlayerID>(i + 1), Vec2(static_cast<float>(tick % 900), static_cast<float>(i)));
+            player.velocity = Vec2(MAX_PLAYER_SPEED, 0.0f);
+            engine.addSnapshot(player, tick);
+        }
+        engine.advance(now);
+        size_t written = engine.interpolateAll(out.data(), out.size());
+        benchmark::DoNotOptimize(written);
+        tick++;
+    }
+    state.SetItemsProcessed(state.iterations() * entities);
+}
+BENCHMARK(BM_InterpolationSnapshotAndSample)->Arg(1)->Arg(16)->Arg(255);
+
+/**
+ * A predicted input per iteration, then a snapshot that acknowledges the
+ * input `pending` steps back. With a mismatch the pending inputs are
+ * replayed; without one reconcile only moves the ack.
+ *
+ * The mismatch alternates sides every iteration. A correction shifts the
+ * whole stored history, so a repeated offset would soon match it and the
+ * replay would converge after a few inputs; alternating keeps every replay
+ * diverging over the full pending window.
+ */
+static void reconcileLoop(benchmark::State& state, float mismatchPx) {
+    const SequenceID pending = static_cast<SequenceID>(state.range(0));
+    PredictionEngine engine;
+    PlayerState player(1, Vec2(WORLD_WIDTH / 2, WORLD_HEIGHT / 2));
+    std::vector<PlayerState> predicted(PredictionEngine::HISTORY_CAPACITY);
+
+    InputState input;
+    input.right = true;
+    for (SequenceID i = 0; i < pending; ++i) {
+        SequenceID seq = engine.applyInput(player, input, FIXED_DT);
+        predicted[seq & (PredictionEngine::HISTORY_CAPACITY - 1)] = player;
+    }
+
+    uint32_t step = 0;
+    size_t shortestReplay = pending;
+    for (auto _ : state) {
+        input.up = (step & 8) != 0;
+        input.down = !input.up;
+        SequenceID seq = engine.applyInput(player, input, FIXED_DT);
+        predicted[seq & (PredictionEngine::HISTORY_CAPACITY - 1)] = player;
+
+        SequenceID acked = seq - pending;
+        PlayerState server = predicted[acked & (PredictionEngine::HISTORY_CAPACITY - 1)];
+        server.position.y += (step & 1) ? -mismatchPx : mismatchPx;
+        GameCommon::clampPosition(server.position);
+        server.lastProcessedSeq = acked;
+        engine.reconcile(server, acked, player, FIXED_DT);
+        benchmark::DoNotOptimize(player.position);
+        shortestReplay = std::min(shortestReplay, engine.getStats().lastReplayLength);
+        step++;
+    }
+
+    if (mismatchPx > 0.0f && shortestReplay != pending) {
+        state.SkipWithError("a replay converged before the end of the pending window");
+    }
+    state.counters["replayed_per_reconcile"] = static_cast<double>(engine.getStats().lastReplayLength);
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_PredictionReconcileMatch(benchmark::State& state) {
+    reconcileLoop(state, 0.0f);
+}
+BENCHMARK(BM_PredictionReconcileMatch)->Arg(6)->Arg(60);
+
+static void BM_PredictionReconcileReplay(benchmark::State& state) {
+    reconcileLoop(state, 25.0f);
+}
+BENCHMARK(BM_PredictionReconcileReplay)->Arg(6)->Arg(60);
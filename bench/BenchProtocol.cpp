@@ -0,0 +1,114 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "../include/Shared.hpp"
+#include "../include/GameCommon.hpp"
+#include "../include/GameProtocol.hpp"
+#include "../include/Random.hpp"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+using namespace CoinCollector;
+
+// A world state counts its players and coins in one byte each
+static constexpr int MAX_WIRE_ENTITIES = 255;
+
+static void makeWorld(int players, int coins, std::vector<PlayerState>& outPlayers, std::vector<CoinState>& outCoins) {
+    Pcg32 rng(42);
+    outPlayers.clear();
+    outCoins.clear();
+    for (int i = 0; i < players; ++i) {
+        PlayerState player(static_cast<PlayerID>(i + 1), GameCommon::randomCoinPosition(rng));
+        player.velocity = Vec2(MAX_PLAYER_SPEED, 0.0f);
+        player.score = static_cast<uint32_t>(i);
+        player.lastProcessedSeq = static_cast<SequenceID>(i * 3);
+        outPlayers.push_back(player);
+    }
+    for (int i = 0; i < coins; ++i) {
+        outCoins.emplace_back(static_cast<uint32_t>(i), GameCommon::randomCoinPosition(rng), i % 2 == 0);
+    }
+}
+
+static void BM_ByteBufferWrite(benchmark::State& state) {
+    const int fields = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        ByteBuffer buffer;
+        for (int i = 0; i < fields; ++i) {
+            buffer.writeUint32(static_cast<uint32_t>(i));
+            buffer.writeFloat(static_cast<float>(i) * 0.5f);
+        }
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.SetItemsProcessed(state.iterations() * fields * 2);
+    state.SetBytesProcessed(state.iterations() * fields * 8);
+}
+BENCHMARK(BM_ByteBufferWrite)->Arg(16)->Arg(256)->Arg(4096);
+
+static void BM_ByteBufferRead(benchmark::State& state) {
+    const int fields = static_cast<int>(state.range(0));
+    ByteBuffer source;
+    for (int i = 0; i < fields; ++i) {
+        source.writeUint32(static_cast<uint32_t>(i));
+        source.writeFloat(static_cast<float>(i) * 0.5f);
+    }
+    std::vector<uint8_t> bytes(source.data(), source.data() + source.size());
+
+    for (auto _ : state) {
+        ByteBuffer buffer(bytes);
+        uint32_t sum = 0;
+        float total = 0.0f;
+        for (int i = 0; i < fields; ++i) {
+            sum += buffer.readUint32();
+            total += buffer.readFloat();
+        }
+        benchmark::DoNotOptimize(sum);
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * fields * 2);
+    state.SetBytesProcessed(state.iterations() * fields * 8);
+}
+BENCHMARK(BM_ByteBufferRead)->Arg(16)->Arg(256)->Arg(4096);
+
+static void BM_SerializeWorldState(benchmark::State& state) {
+    std::vector<PlayerState> players;
+    std::vector<CoinState> coins;
+    makeWorld(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)), players, coins);
+
+    uint32_t tick = 0;
+    size_t packetSize = 0;
+    for (auto _ : state) {
+        ByteBuffer packet = GameProtocol::serializeWorldState(0, tick++, players, coins);
+        packetSize = packet.size();
+        benchmark::DoNotOptimize(packet.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(players.size() + coins.size()));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(packetSize));
+    state.counters["packet_bytes"] = static_cast<double>(packetSize);
+}
+
+static void BM_DeserializeWorldState(benchmark::State& state) {
+    std::vector<PlayerState> players;
+    std::vector<CoinState> coins;
+    makeWorld(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)), players, coins);
+    ByteBuffer packet = GameProtocol::serializeWorldState(0, 7, players, coins);
+    std::vector<uint8_t> bytes(packet.data(), packet.data() + packet.size());
+
+    for (auto _ : state) {
+        ByteBuffer buffer(bytes);
+        GameProtocol::deserializeHeader(buffer);
+        uint32_t tick = 0;
+        GameProtocol::deserializeWorldState(buffer, tick, players, coins);
+        benchmark::DoNotOptimize(players.data());
+        benchmark::DoNotOptimize(coins.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(players.size() + coins.size()));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bytes.size()));
+}
+
+// {players, coins}: a small match up to the largest packet the format can carry
+#define WORLD_SIZES ->Args({1, MAX_COINS})->Args({8, MAX_COINS})->Args({64, 64}) \
+                    ->Args({MAX_WIRE_ENTITIES, MAX_WIRE_ENTITIES})
+BENCHMARK(BM_SerializeWorldState) WORLD_SIZES;
+BENCHMARK(BM_DeserializeWorldState) WORLD_SIZES;
+#undef WORLD_SIZES
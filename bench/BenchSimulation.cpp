@@ -0,0 +1,92 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "../include/Shared.hpp"
+#include "../include/GameCommon.hpp"
+#include "../include/LagSimulator.hpp"
+#include "../server/GameWorld.hpp"
+#include "../server/ServerPlayer.hpp"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vector>
+
+using namespace CoinCollector;
+
+static InputState inputFor(uint32_t step) {
+    InputState input;
+    input.up = (step & 1) != 0;
+    input.right = (step & 2) != 0;
+    input.left = (step & 12) == 4;
+    input.down = (step & 12) == 8;
+    return input;
+}
+
+static void BM_ApplyInput(benchmark::State& state) {
+    PlayerState player(1, Vec2(WORLD_WIDTH / 2, WORLD_HEIGHT / 2));
+    uint32_t step = 0;
+    for (auto _ : state) {
+        GameCommon::applyInput(player, inputFor(step++), FIXED_DT);
+        benchmark::DoNotOptimize(player.position);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ApplyInput);
+
+/**
+ * One tick of pickups: every player moves once, then GameWorld checks
+ * every player against every coin and records the tick for rewind
+ */
+static void BM_CheckCollisions(benchmark::State& state) {
+    const int playerCount = static_cast<int>(state.range(0));
+    const int coinCount = static_cast<int>(state.range(1));
+
+    GameWorld world(12345);
+    world.setLogPickups(false);
+    world.setRegion(0.0f, WORLD_WIDTH, coinCount, 0);
+
+    std::vector<std::unique_ptr<ServerPlayer>> owned;
+    std::vector<ServerPlayer*> players;
+    for (int i = 0; i < playerCount; ++i) {
+        owned.push_back(std::make_unique<ServerPlayer>(static_cast<PlayerID>(i + 1)));
+        owned.back()->getState().position = world.spawnPlayerPosition(players);
+        players.push_back(owned.back().get());
+    }
+    world.spawnCoins(players);
+
+    uint32_t tick = 0;
+    for (auto _ : state) {
+        for (ServerPlayer* player : players) {
+            GameCommon::applyInput(player->getState(), inputFor(tick + player->getId()), FIXED_DT);
+        }
+        world.checkCollisions(players, tick++);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * playerCount * coinCount);
+    uint64_t score = 0;
+    for (ServerPlayer* player : players) score += player->getState().score;
+    state.counters["pickups_per_tick"] = static_cast<double>(score) / static_cast<double>(tick);
+}
+BENCHMARK(BM_CheckCollisions)->Args({1, MAX_COINS})->Args({8, MAX_COINS})->Args({64, 64})->Args({256, 256});
+
+/**
+ * Steady traffic through the lag simulator: with zero latency every
+ * pushed item is ready at once
+ */
+static void BM_LatencyBufferPushPop(benchmark::State& state) {
+    const int burst = static_cast<int>(state.range(0));
+    LatencyBuffer<std::vector<uint8_t>> buffer(0);
+    std::vector<uint8_t> packet(64, 0xAB);
+    std::vector<uint8_t> out;
+
+    for (auto _ : state) {
+        for (int i = 0; i < burst; ++i) {
+            buffer.push(packet);
+        }
+        while (buffer.popReady(out)) {
+            benchmark::DoNotOptimize(out.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * burst);
+}
+BENCHMARK(BM_LatencyBufferPushPop)->Arg(1)->Arg(32);
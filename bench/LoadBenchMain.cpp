@@ -0,0 +1,372 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "../include/Shared.hpp"
+#include "../include/Connection.hpp"
+#include "../include/GameProtocol.hpp"
+#include "../include/Log.hpp"
+#include "../server/GameServer.hpp"
+#include "../server/ServerMetrics.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <netinet/tcp.h>
+
+using namespace CoinCollector;
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        std::vector<size_t> playerCounts{32};
+        int coins = MAX_COINS;
+        int latencyMs = SIMULATED_LATENCY_MS;
+        uint32_t ticks = 600;       // measured
+        uint32_t warmupTicks = 120; // after every client has joined
+        size_t threads = 0;
+        uint16_t port = 39687;
+        std::string outPath = "loadbench.json";
+    };
+
+    double cpuSeconds(clockid_t clock) {
+        timespec now{};
+        clock_gettime(clock, &now);
+        return static_cast<double>(now.tv_sec) + static_cast<double>(now.tv_nsec) / 1e9;
+    }
+
+    /**
+     * A client without rendering or prediction: sends one input per tick
+     * and times how long the server takes to acknowledge it in a world state
+     */
+    class HeadlessClient {
+    public:
+        bool connect(uint16_t port) {
+            SocketType sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+            if (sock == INVALID_SOCKET_VALUE) return false;
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(port);
+            inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+            if (::connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+                close(sock);
+                return false;
+            }
+            fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+            int noDelay = 1;
+            setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+
+            connection_ = std::make_unique<SocketConnection>(sock);
+            ByteBuffer handshake = GameProtocol::serializeHandshake(0, 0, 0);
+            return connection_->send(handshake.data(), handshake.size());
+        }
+
+        void sendInput(uint32_t step) {
+            if (playerId_ == 0) return;
+            InputState input;
+            // Wander: a new direction every half second, different per client
+            uint32_t phase = (step / (TICK_RATE / 2) + playerId_) % 4;
+            input.up = phase == 0;
+            input.right = phase == 1;
+            input.down = phase == 2;
+            input.left = phase == 3;
+
+            SequenceID seq = nextSeq_++;
+            sentAt_[seq & (IN_FLIGHT - 1)] = Clock::now();
+            ByteBuffer packet = GameProtocol::serializeInput(seq, input, viewTick_);
+            connection_->send(packet.data(), packet.size());
+        }
+
+        // Read everything pending; false once the server closed the connection
+        bool poll(LatencyHistogram& ackLatency, LatencyHistogram& snapshotBytes) {
+            uint8_t buffer[16384];
+            int received;
+            while ((received = connection_->receive(buffer, sizeof(buffer))) > 0) {
+                received_.insert(received_.end(), buffer, buffer + received);
+            }
+            if (received < 0) return false;
+
+            size_t offset = 0;
+            while (received_.size() - offset >= 7) {
+                ByteBuffer headerBuf(std::vector<uint8_t>(received_.begin() + offset,
+                                                          received_.begin() + offset + 7));
+                PacketHeader header = GameProtocol::deserializeHeader(headerBuf);
+                size_t total = 7u + header.payloadSize;
+                if (received_.size() - offset < total) break;
+
+                ByteBuffer payload(std::vector<uint8_t>(received_.begin() + offset + 7,
+                                                        received_.begin() + offset + total));
+                if (header.type == PacketType::Handshake) {
+                    uint64_t token = 0;
+                    bool resumed = false;
+                    uint32_t roomId = 0;
+                    playerId_ = GameProtocol::deserializeHandshakeResponse(payload, token, resumed, roomId);
+                } else if (header.type == PacketType::WorldState) {
+                    onWorldState(payload, total, ackLatency, snapshotBytes);
+                } else if (header.type == PacketType::Ping) {
+                    ByteBuffer pong = GameProtocol::serializePong(header.sequenceId);
+                    connection_->send(pong.data(), pong.size());
+                }
+                offset += total;
+            }
+            received_.erase(received_.begin(), received_.begin() + static_cast<std::ptrdiff_t>(offset));
+            return true;
+        }
+
+        PlayerID getPlayerId() const { return playerId_; }
+
+    private:
+        void onWorldState(ByteBuffer& payload, size_t packetBytes,
+                          LatencyHistogram& ackLatency, LatencyHistogram& snapshotBytes) {
+            uint32_t tick = 0;
+            GameProtocol::deserializeWorldState(payload, tick, players_, coins_);
+            viewTick_ = std::max(viewTick_, tick);
+            snapshotBytes.record(packetBytes);
+
+            auto now = Clock::now();
+            for (const PlayerState& player : players_) {
+                if (player.id != playerId_) continue;
+                SequenceID ack = player.lastProcessedSeq;
+                if (ack > lastAck_ && nextSeq_ - ack <= IN_FLIGHT) {
+                    ackLatency.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        now - sentAt_[ack & (IN_FLIGHT - 1)]).count()));
+                }
+                lastAck_ = std::max(lastAck_, ack);
+                break;
+            }
+        }
+
+        static constexpr SequenceID IN_FLIGHT = 1024; // inputs remembered for timing
+
+        std::unique_ptr<SocketConnection> connection_;
+        std::vector<uint8_t> received_;
+        std::vector<PlayerState> players_;
+        std::vector<CoinState> coins_;
+        std::array<Clock::time_point, IN_FLIGHT> sentAt_{};
+        PlayerID playerId_ = 0;
+        SequenceID nextSeq_ = 1;
+        SequenceID lastAck_ = 0;
+        uint32_t viewTick_ = 0;
+    };
+
+    void appendQuantiles(std::ostringstream& out, const LatencyHistogram& histogram, double scale) {
+        out << "{\"p50\":" << static_cast<double>(histogram.percentile(0.5)) * scale
+            << ",\"p90\":" << static_cast<double>(histogram.percentile(0.9)) * scale
+            << ",\"p99\":" << static_cast<double>(histogram.percentile(0.99)) * scale
+            << ",\"p999\":" << static_cast<double>(histogram.percentile(0.999)) * scale
+            << ",\"max\":" << static_cast<double>(histogram.getMax()) * scale
+            << ",\"mean\":" << (histogram.getCount() > 0
+                                    ? static_cast<double>(histogram.getSum()) * scale /
+                                      static_cast<double>(histogram.getCount())
+                                    : 0.0)
+            << ",\"samples\":" << histogram.getCount() << "}";
+    }
+
+    /**
+     * One configuration: fresh server, players join, warm up, measure.
+     * Returns the result as a JSON object, or an empty string on failure.
+     */
+    std::string runOnce(const Options& options, size_t playerCount, uint16_t port) {
+        GameServer server(port, 12345, 0, 1, options.threads);
+        server.setCoinCount(options.coins);
+        server.setSimulatedLatency(options.latencyMs);
+        if (!server.start()) return "";
+
+        std::atomic<bool> running(true);
+        std::thread loop([&] { server.run(running); });
+        auto finish = [&](const std::string& result) {
+            running = false;
+            loop.join();
+            server.stop();
+            return result;
+        };
+
+        LatencyHistogram ackLatency;
+        LatencyHistogram snapshotBytes;
+        std::vector<HeadlessClient> clients(playerCount);
+        size_t connected = 0;
+
+        const ServerMetrics& metrics = server.getMetrics();
+        auto stepDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(FIXED_DT));
+        auto joinDeadline = Clock::now() + std::chrono::seconds(10 + playerCount / 30);
+        auto nextStep = Clock::now();
+        uint32_t step = 0;
+
+        uint64_t startTick = 0;      // first measured tick, set once everyone joined and warmed up
+        uint64_t joinedAtTick = 0;
+        double processCpuStart = 0.0;
+        double clientCpuStart = 0.0;
+        uint64_t bytesOutStart = 0;
+        uint64_t overBudgetStart = 0;
+        uint64_t missedStart = 0;
+        uint64_t catchUpStart = 0;
+        Clock::time_point wallStart;
+
+        for (;;) {
+            // One new client per step: the server accepts one connection per tick
+            if (connected < clients.size()) {
+                if (!clients[connected].connect(port)) {
+                    std::cerr << "[LoadBench] Cannot connect to port " << port << std::endl;
+                    return finish("");
+                }
+                connected++;
+            }
+
+            for (size_t i = 0; i < connected; ++i) {
+                HeadlessClient& client = clients[i];
+                client.sendInput(step);
+                if (!client.poll(ackLatency, snapshotBytes)) {
+                    std::cerr << "[LoadBench] Server closed a client connection" << std::endl;
+                    return finish("");
+                }
+            }
+            step++;
+
+            uint64_t ticks = metrics.ticks.load(std::memory_order_relaxed);
+            if (joinedAtTick == 0) {
+                size_t joined = static_cast<size_t>(std::count_if(clients.begin(), clients.end(),
+                    [](const HeadlessClient& c) { return c.getPlayerId() != 0; }));
+                if (joined == clients.size()) {
+                    joinedAtTick = ticks;
+                } else if (Clock::now() > joinDeadline) {
+                    std::cerr << "[LoadBench] Only " << joined << " of " << clients.size() << " clients joined" << std::endl;
+                    return finish("");
+                }
+            } else if (startTick == 0 && ticks >= joinedAtTick + options.warmupTicks) {
+                server.resetTimings();
+                ackLatency.reset();
+                snapshotBytes.reset();
+                startTick = ticks;
+                wallStart = Clock::now();
+                processCpuStart = cpuSeconds(CLOCK_PROCESS_CPUTIME_ID);
+                clientCpuStart = cpuSeconds(CLOCK_THREAD_CPUTIME_ID);
+                bytesOutStart = server.getTrafficStats().bytesOut.load(std::memory_order_relaxed);
+                overBudgetStart = metrics.overBudgetTicks.load(std::memory_order_relaxed);
+                missedStart = metrics.missedTicks.load(std::memory_order_relaxed);
+                catchUpStart = metrics.catchUpTicks.load(std::memory_order_relaxed);
+            } else if (startTick != 0 && ticks >= startTick + options.ticks) {
+                break;
+            }
+
+            nextStep += stepDuration;
+            std::this_thread::sleep_until(nextStep);
+        }
+
+        double wallSeconds = std::chrono::duration<double>(Clock::now() - wallStart).count();
+        // Everything but this (client) thread is the server: its tick thread, workers and the log writer
+        double serverCpu = (cpuSeconds(CLOCK_PROCESS_CPUTIME_ID) - processCpuStart) -
+                           (cpuSeconds(CLOCK_THREAD_CPUTIME_ID) - clientCpuStart);
+        uint64_t measuredTicks = metrics.ticks.load(std::memory_order_relaxed) - startTick;
+        uint64_t bytesOut = server.getTrafficStats().bytesOut.load(std::memory_order_relaxed) - bytesOutStart;
+        double players = static_cast<double>(playerCount);
+
+        std::ostringstream out;
+        out << "{\"players\":" << playerCount
+            << ",\"coins\":" << options.coins
+            << ",\"latency_ms\":" << options.latencyMs
+            << ",\"threads\":" << options.threads
+            << ",\"ticks\":" << measuredTicks
+            << ",\"wall_seconds\":" << wallSeconds
+            << ",\"tick_ms\":";
+        appendQuantiles(out, metrics.phase(TickPhase::Tick), 1e-6);
+        out << ",\"rooms_ms\":";
+        appendQuantiles(out, metrics.phase(TickPhase::Rooms), 1e-6);
+        out << ",\"over_budget_ticks\":" << metrics.overBudgetTicks.load(std::memory_order_relaxed) - overBudgetStart
+            << ",\"missed_ticks\":" << metrics.missedTicks.load(std::memory_order_relaxed) - missedStart
+            << ",\"catch_up_ticks\":" << metrics.catchUpTicks.load(std::memory_order_relaxed) - catchUpStart
+            << ",\"input_ack_ms\":";
+        appendQuantiles(out, ackLatency, 1e-6);
+        out << ",\"snapshot_bytes\":";
+        appendQuantiles(out, snapshotBytes, 1.0);
+        out << ",\"bytes_out_per_player_per_second\":" << static_cast<double>(bytesOut) / players / wallSeconds
+            << ",\"server_cpu_seconds\":" << serverCpu
+            << ",\"server_cores\":" << serverCpu / wallSeconds
+            << ",\"server_cpu_us_per_player_tick\":"
+            << serverCpu * 1e6 / players / static_cast<double>(std::max<uint64_t>(measuredTicks, 1))
+            << "}";
+
+        std::cout << "[LoadBench] " << playerCount << " players: tick p50 "
+                  << static_cast<double>(metrics.phase(TickPhase::Tick).percentile(0.5)) / 1e6 << " ms, p99 "
+                  << static_cast<double>(metrics.phase(TickPhase::Tick).percentile(0.99)) / 1e6 << " ms; ack p50 "
+                  << static_cast<double>(ackLatency.percentile(0.5)) / 1e6 << " ms; "
+                  << serverCpu / wallSeconds << " cores" << std::endl;
+        return finish(out.str());
+    }
+
+    std::vector<size_t> parseCounts(const std::string& list) {
+        std::vector<size_t> counts;
+        std::stringstream in(list);
+        std::string item;
+        while (std::getline(in, item, ',')) {
+            int count = std::atoi(item.c_str());
+            if (count > 0) counts.push_back(static_cast<size_t>(std::min(count, 255)));
+        }
+        return counts;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    // Usage: LoadBench [--players 8,32,128] [--coins <n>] [--latency <ms>] [--ticks <n>]
+    //                  [--warmup <ticks>] [--threads <n>] [--port <port>] [--out <results.json>]
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--players" && i + 1 < argc) {
+            options.playerCounts = parseCounts(argv[++i]);
+        } else if (arg == "--coins" && i + 1 < argc) {
+            options.coins = std::max(0, std::min(std::atoi(argv[++i]), 255));
+        } else if (arg == "--latency" && i + 1 < argc) {
+            options.latencyMs = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--ticks" && i + 1 < argc) {
+            options.ticks = static_cast<uint32_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--warmup" && i + 1 < argc) {
+            options.warmupTicks = static_cast<uint32_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--threads" && i + 1 < argc) {
+            options.threads = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--port" && i + 1 < argc) {
+            options.port = static_cast<uint16_t>(std::atoi(argv[++i]));
+        } else if (arg == "--out" && i + 1 < argc) {
+            options.outPath = argv[++i];
+        } else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (options.playerCounts.empty()) {
+        std::cerr << "--players expects a comma-separated list of counts" << std::endl;
+        return 1;
+    }
+
+    std::string results = "[";
+    for (size_t i = 0; i < options.playerCounts.size(); ++i) {
+        // A fresh port per run; the previous server's sockets may linger
+        std::string result = runOnce(options, options.playerCounts[i], static_cast<uint16_t>(options.port + i));
+        Log::flush();
+        if (result.empty()) {
+            std::cerr << "[LoadBench] Run with " << options.playerCounts[i] << " players failed" << std::endl;
+            return 1;
+        }
+        results += (i > 0 ? ",\n" : "\n") + result;
+    }
+    results += "\n]\n";
+
+    std::FILE* file = std::fopen(options.outPath.c_str(), "w");
+    if (!file || std::fputs(results.c_str(), file) < 0 || std::fclose(file) != 0) {
+        std::cerr << "[LoadBench] Cannot write " << options.outPath << std::endl;
+        return 1;
+    }
+    std::cout << "[LoadBench] Results written to " << options.outPath << std::endl;
+    return 0;
+}
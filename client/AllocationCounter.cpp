@@ -0,0 +1,69 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "AllocationCounter.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace {
+    std::atomic<uint64_t> allocations{0};
+}
+
+namespace CoinCollector {
+namespace AllocationCounter {
+
+    uint64_t total() {
+        return allocations.load(std::memory_order_relaxed);
+    }
+
+} // namespace AllocationCounter
+} // namespace CoinCollector
+
+// The array and nothrow forms of operator new forward to this one...
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* block = std::malloc(size == 0 ? 1 : size)) return block;
+    throw std::bad_alloc();
+}
+
+// ...and their over-aligned (std::align_val_t) forms to this one
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    std::size_t align = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+#ifdef _WIN32
+    if (void* block = _aligned_malloc(size == 0 ? 1 : size, align)) return block;
+#else
+    void* block = nullptr;
+    if (posix_memalign(&block, align, size == 0 ? 1 : size) == 0) return block;
+#endif
+    throw std::bad_alloc();
+}
+
+void operator delete(void* block) noexcept {
+    std::free(block);
+}
+
+void operator delete(void* block, std::size_t) noexcept {
+    std::free(block);
+}
+
+void operator delete(void* block, std::align_val_t) noexcept {
+#ifdef _WIN32
+    _aligned_free(block);
+#else
+    std::free(block);
+#endif
+}
+
+void operator delete(void* block, std::size_t, std::align_val_t alignment) noexcept {
+    operator delete(block, alignment);
+}
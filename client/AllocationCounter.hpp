@@ -0,0 +1,24 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#ifndef KRAFTON_ALLOCATIONCOUNTER_HPP
+#define KRAFTON_ALLOCATIONCOUNTER_HPP
+#pragma once
+
+#include <cstdint>
+
+namespace CoinCollector {
+namespace AllocationCounter {
+
+    /**
+     * Heap allocations (operator new) made by the client process so far.
+     * AllocationCounter.cpp replaces the global operator new to count them;
+     * take the difference of two reads to count a frame's allocations.
+     */
+    uint64_t total();
+
+} // namespace AllocationCounter
+} // namespace CoinCollector
+
+#endif //KRAFTON_ALLOCATIONCOUNTER_HPP
@@ -4,20 +4,39 @@
 
 #include "GameClient.hpp"
 #include "Shared.hpp"
+#include "Trace.hpp"
 #include <iostream>
 #include <cstdint>
+#include <string>
+#include <vector>
 
 int main(int argc, char* argv[]) {
     using namespace CoinCollector;
 
+    // Usage: GameClient [host|shm] [port] [room] [--trace <frames.json>]
+    std::vector<std::string> positional;
+    std::string tracePath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--trace" && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
     std::string serverHost = "127.0.0.1";
     uint16_t serverPort = SERVER_PORT;
+    uint32_t roomId = 0; // any room
 
-    if (argc > 1) {
-        serverHost = argv[1];
+    if (positional.size() > 0) {
+        serverHost = positional[0];
+    }
+    if (positional.size() > 1) {
+        serverPort = static_cast<uint16_t>(std::atoi(positional[1].c_str()));
     }
-    if (argc > 2) {
-        serverPort = static_cast<uint16_t>(std::atoi(argv[2]));
+    if (positional.size() > 2) {
+        roomId = static_cast<uint32_t>(std::atoi(positional[2].c_str()));
     }
 
     std::cout << "=== Coin Collector Multiplayer Client ===" << std::endl;
@@ -27,18 +46,32 @@ int main(int argc, char* argv[]) {
     std::cout << "==========================================" << std::endl;
 
     try {
-        GameClient client(serverHost, serverPort);
+        GameClient client(serverHost, serverPort, roomId);
 
         if (!client.connect()) {
             std::cerr << "Failed to connect to server" << std::endl;
             return 1;
         }
 
-        std::cout << "Connected to server successfully" << std::endl;
+        // The join finishes inside run(); GameClient logs once the server answers
+        std::cout << "Connecting..." << std::endl;
+
+        if (!tracePath.empty()) {
+            Trace::setThreadName("client");
+            Trace::start();
+        }
 
         // Main client loop (handles input, prediction, reconciliation, rendering)
         client.run();
 
+        if (!tracePath.empty()) {
+            if (Trace::stop(tracePath)) {
+                std::cout << "Trace written to " << tracePath << std::endl;
+            } else {
+                std::cerr << "Failed to write trace " << tracePath << std::endl;
+            }
+        }
+
         client.disconnect();
         std::cout << "Disconnected from server" << std::endl;
 
@@ -4,16 +4,22 @@
 
 #include "ClientNetwork.hpp"
 #include "GameProtocol.hpp"
+#include "Log.hpp"
 #include "Shared.hpp"
+#include "ShmTransport.hpp"
+#include <cerrno>
+#include <cstring>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <netinet/tcp.h>
+#include <poll.h>
 
 
 namespace CoinCollector {
 
 ClientNetwork::ClientNetwork(const std::string& host, uint16_t port)
-    : host_(host), port_(port), socket_(INVALID_SOCKET_VALUE),
+    : host_(host), port_(port),
       outgoingBuffer_(SIMULATED_LATENCY_MS),
       incomingWorldStates_(SIMULATED_LATENCY_MS),
       connected_(false) {
@@ -25,6 +31,30 @@ ClientNetwork::~ClientNetwork() {
     disconnect();
 }
 
+bool ClientNetwork::join(uint32_t requestedRoom) {
+    dropConnection();
+
+    // Partial packets and inputs queued while offline belong to the old connection
+    receiveBuffer_.clear();
+    outgoingBuffer_.clear();
+    assignedPlayerId_ = 0;
+    resumed_ = false;
+
+    if (!connect()) {
+        link_ = Link::Offline;
+        return false;
+    }
+
+    // Queued now, sent once the connection is up. A token from an earlier
+    // connection asks to resume that session, and a fresh session after a
+    // reconnect asks for the room we were in.
+    uint32_t roomId = roomId_ != 0 ? roomId_ : requestedRoom;
+    send(GameProtocol::serializeHandshake(0, sessionToken_, roomId));
+    link_ = Link::Joining;
+    joinDeadline_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(JOIN_TIMEOUT_MS);
+    return true;
+}
+
 bool ClientNetwork::connect() {
 #ifdef _WIN32
     WSADATA wsaData;
@@ -33,11 +63,28 @@ bool ClientNetwork::connect() {
         return false;
     }
 #endif
-    socket_ = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
-    if (socket_ == INVALID_SOCKET_VALUE) {
+#ifndef _WIN32
+    if (host_ == "shm") {
+        connection_ = Shm::connect(Shm::nameForPort(port_));
+        if (!connection_) {
+            std::cerr << "[ClientNetwork] No shared-memory server on port " << port_ << std::endl;
+            return false;
+        }
+        connected_ = true;
+        std::cout << "[ClientNetwork] Connected to " << host_ << ":" << port_ << std::endl;
+        return true;
+    }
+#endif
+    return connectSocket();
+}
+
+bool ClientNetwork::connectSocket() {
+    SocketType sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (sock == INVALID_SOCKET_VALUE) {
         std::cerr << "[ClientNetwork] Failed to create socket" << std::endl;
         return false;
     }
+    auto connection = std::make_unique<SocketConnection>(sock);
 
     sockaddr_in serverAddr{};
     serverAddr.sin_family = AF_INET;
@@ -46,71 +93,125 @@ bool ClientNetwork::connect() {
         std::cerr << "Invalid address/ Address not supported" << std::endl;
         return false;
     }
-    if (::connect(socket_, reinterpret_cast<sockaddr*>(&serverAddr),
-                  sizeof(serverAddr)) < 0) {
-        std::cerr << "[ClientNetwork] Connection failed" << std::endl;
-        return false;
+
+    // Non-blocking first, so connect() returns at once and update() finishes it
+    setNonBlocking(sock);
+    setTcpNoDelay(sock);
+    if (::connect(sock, reinterpret_cast<sockaddr*>(&serverAddr), sizeof(serverAddr)) < 0) {
+#ifdef _WIN32
+        bool inProgress = WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+        bool inProgress = errno == EINPROGRESS;
+#endif
+        if (!inProgress) {
+            std::cerr << "[ClientNetwork] Connection failed: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        connectingSocket_ = sock;
+    } else {
+        connected_ = true;
+        std::cout << "[ClientNetwork] Connected to " << host_ << ":" << port_ << std::endl;
     }
 
-    setNonBlocking();
-    setTcpNoDelay();
+    connection_ = std::move(connection);
+    return true;
+}
 
+void ClientNetwork::finishConnect() {
+    pollfd pending{};
+    pending.fd = connectingSocket_;
+    pending.events = POLLOUT;
+#ifdef _WIN32
+    int ready = WSAPoll(&pending, 1, 0);
+#else
+    int ready = poll(&pending, 1, 0);
+#endif
+    if (ready == 0) return; // still in progress
+
+    int error = 0;
+    socklen_t length = sizeof(error);
+    if (ready < 0 || getsockopt(connectingSocket_, SOL_SOCKET, SO_ERROR,
+                                reinterpret_cast<char*>(&error), &length) != 0) {
+        error = errno;
+    }
+    connectingSocket_ = INVALID_SOCKET_VALUE;
+
+    if (error != 0) {
+        LOG_WARN("ClientNetwork", "Connection to " << host_ << ":" << port_ << " failed: " << std::strerror(error));
+        dropConnection();
+        link_ = Link::Offline;
+        return;
+    }
     connected_ = true;
     std::cout << "[ClientNetwork] Connected to " << host_ << ":" << port_ << std::endl;
-    return true;
 }
 
-void ClientNetwork::disconnect() {
-    if (socket_ != INVALID_SOCKET_VALUE) {
-        closesocket(socket_);
-        close(socket_);
-        socket_ = INVALID_SOCKET_VALUE;
-    }
+void ClientNetwork::dropConnection() {
+    connection_.reset();
+    connectingSocket_ = INVALID_SOCKET_VALUE;
     connected_ = false;
+}
+
+void ClientNetwork::disconnect() {
+    dropConnection();
+    link_ = Link::Offline;
 #ifdef _WIN32
     WSACleanup();
 #endif
 }
 
+bool ClientNetwork::pollJoined() {
+    bool joined = joined_;
+    joined_ = false;
+    return joined;
+}
+
 void ClientNetwork::update() {
+    if (connectingSocket_ != INVALID_SOCKET_VALUE) {
+        finishConnect();
+    }
+    if (link_ == Link::Joining && std::chrono::steady_clock::now() >= joinDeadline_) {
+        LOG_WARN("ClientNetwork", "No answer from " << host_ << ":" << port_ << " in " << JOIN_TIMEOUT_MS << " ms");
+        dropConnection();
+        link_ = Link::Offline;
+    }
     if (!connected_) return;
 
     receive();
     processPackets();
+    if (!connected_) return; // closed, or redirected and connecting elsewhere
 
     // Send buffered packets
     ByteBuffer packet;
     while (outgoingBuffer_.popReady(packet)) {
-        ::send(socket_, reinterpret_cast<const char*>(packet.data()),
-              packet.size(), 0);
+        connection_->send(packet.data(), packet.size());
     }
 }
 
-void ClientNetwork::send(const ByteBuffer& data) {
-    outgoingBuffer_.push(data);
+void ClientNetwork::send(ByteBuffer data) {
+    outgoingBuffer_.push(std::move(data));
 }
 
-bool ClientNetwork::popWorldState(WorldStatePacket& out) {
-    return incomingWorldStates_.popReady(out);
+bool ClientNetwork::popWorldState(WorldStatePacket& inOut) {
+    return incomingWorldStates_.swapReady(inOut);
 }
 
 void ClientNetwork::receive() {
     uint8_t buffer[4096];
-    int received = recv(socket_, reinterpret_cast<char*>(buffer),
-                       sizeof(buffer), 0);
+    int received = connection_->receive(buffer, sizeof(buffer));
 
     if (received > 0) {
         receiveBuffer_.insert(receiveBuffer_.end(), buffer, buffer + received);
-    } else if (received == 0) {
-        std::cout << "[ClientNetwork] Server closed connection" << std::endl;
-        connected_ = false;
+    } else if (received < 0) {
+        LOG_INFO("ClientNetwork", "Server closed connection");
+        dropConnection();
+        link_ = Link::Offline;
     }
 }
 
 void ClientNetwork::processPackets() {
     while (receiveBuffer_.size() >= 7) {
-        ByteBuffer headerBuf(std::vector<uint8_t>(
-            receiveBuffer_.begin(), receiveBuffer_.begin() + 7));
+        ByteBuffer headerBuf(receiveBuffer_.data(), 7);
         PacketHeader header = GameProtocol::deserializeHeader(headerBuf);
 
         size_t totalSize = 7 + header.payloadSize;
@@ -118,24 +219,39 @@ void ClientNetwork::processPackets() {
             break;
         }
 
-        std::vector<uint8_t> packetData(
-            receiveBuffer_.begin() + 7,
-            receiveBuffer_.begin() + totalSize);
-        ByteBuffer payloadBuf(packetData);
+        ByteBuffer payloadBuf(receiveBuffer_.data() + 7, header.payloadSize);
         if (header.type == PacketType::Handshake) {
-            std::cout << "[ClientNetwork] RECEIVED HANDSHAKE PACKET!" << std::endl;
+            LOG_DEBUG("ClientNetwork", "Received handshake packet");
             // Verify the ID inside
-            assignedPlayerId_ = GameProtocol::deserializeHandshakeResponse(payloadBuf);
-            std::cout << "[ClientNetwork] Server assigned me ID: " << assignedPlayerId_ << std::endl;
+            assignedPlayerId_ = GameProtocol::deserializeHandshakeResponse(payloadBuf, sessionToken_,
+                                                                           resumed_, roomId_);
+            LOG_INFO("ClientNetwork", "Server assigned me ID: " << assignedPlayerId_ << " in room " << roomId_
+                     << (resumed_ ? " (session resumed)" : ""));
+            link_ = Link::Online;
+            joined_ = true;
         }
 
-        if (header.type == PacketType::WorldState) {
-            WorldStatePacket worldState;
-            GameProtocol::deserializeWorldState(
-                payloadBuf, worldState.tick,
-                worldState.players, worldState.coins);
+        if (header.type == PacketType::Redirect) {
+            // Handed to another shard: resume there right away. World states
+            // already in the latency queue still play out meanwhile.
+            port_ = GameProtocol::deserializeRedirect(payloadBuf);
+            LOG_INFO("ClientNetwork", "Redirected to port " << port_);
+            join(roomId_);
+            return;
+        }
 
-            incomingWorldStates_.push(worldState);
+        if (header.type == PacketType::Ping) {
+            // Answer liveness probes so an idle window isn't reaped as dead
+            send(GameProtocol::serializePong(header.sequenceId));
+        }
+
+        if (header.type == PacketType::WorldState) {
+            // Straight into a recycled slot of the latency queue
+            incomingWorldStates_.emplace([&payloadBuf](WorldStatePacket& worldState) {
+                GameProtocol::deserializeWorldState(
+                    payloadBuf, worldState.tick,
+                    worldState.players, worldState.coins);
+            });
         }
 
         receiveBuffer_.erase(receiveBuffer_.begin(),
@@ -143,20 +259,20 @@ void ClientNetwork::processPackets() {
     }
 }
 
-bool ClientNetwork::setNonBlocking() {
+bool ClientNetwork::setNonBlocking(SocketType socket) {
 #ifdef _WIN32
     u_long mode = 1;
-    return ioctlsocket(socket_, FIONBIO, &mode) == 0;
+    return ioctlsocket(socket, FIONBIO, &mode) == 0;
 #else
-    int flags = fcntl(socket_, F_GETFL, 0);
+    int flags = fcntl(socket, F_GETFL, 0);
     if (flags == -1) return false;
-    return fcntl(socket_, F_SETFL, flags | O_NONBLOCK) == 0;
+    return fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
 #endif
 }
 
-bool ClientNetwork::setTcpNoDelay() {
+bool ClientNetwork::setTcpNoDelay(SocketType socket) {
     int flag = 1;
-    return setsockopt(socket_, IPPROTO_TCP, TCP_NODELAY,
+    return setsockopt(socket, IPPROTO_TCP, TCP_NODELAY,
                      reinterpret_cast<const char*>(&flag), sizeof(flag)) == 0;
 }
 
@@ -7,56 +7,96 @@
 
 
 #pragma once
+#include <chrono>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "NetTypes.hpp"
 #include "Shared.hpp"
 #include "LagSimulator.hpp"
+#include "Connection.hpp"
 
 
-typedef int SocketType;
-
 namespace CoinCollector {
 
     struct WorldStatePacket {
-        uint32_t tick;
+        uint32_t tick = 0;
         std::vector<PlayerState> players;
         std::vector<CoinState> coins;
     };
 
+    /**
+     * Client side of the protocol. Host "shm" attaches to a server on the
+     * same machine through shared memory instead of TCP.
+     *
+     * Joining never blocks: join() starts a non-blocking connect and queues
+     * the handshake, and update() moves the link from Joining to Online when
+     * the server answers (or back to Offline if it does not within
+     * JOIN_TIMEOUT_MS). A redirect from the server starts joining the new
+     * port at once, resuming the same session.
+     */
     class ClientNetwork {
     public:
+        enum class Link { Offline, Joining, Online };
+
         ClientNetwork(const std::string& host, uint16_t port);
         ~ClientNetwork();
 
-        bool connect();
+        /**
+         * Connect (again) and ask for a session: the one we hold a token for,
+         * else a new one in our last room or requestedRoom. Returns false only
+         * if the connection could not even be started.
+         */
+        bool join(uint32_t requestedRoom);
         void disconnect();
         void update();
 
-        void send(const ByteBuffer& data);
-        bool popWorldState(WorldStatePacket& out);
+        Link getLink() const { return link_; }
+        bool isConnected() const { return connected_; }
+        // True once after each handshake the server answers, redirects included
+        bool pollJoined();
+
+        void send(ByteBuffer data);
+        // Swaps the next due world state into inOut; inOut's old contents are
+        // recycled as storage for a later one, so keep passing the same packet
+        bool popWorldState(WorldStatePacket& inOut);
 
         PlayerID getPlayerId() const { return assignedPlayerId_; }
+        uint64_t getSessionToken() const { return sessionToken_; }
+        bool wasResumed() const { return resumed_; }
+        uint32_t getRoomId() const { return roomId_; }
+        uint16_t getPort() const { return port_; }
 
     private:
+        bool connect();
+        void finishConnect();
         void receive();
         void processPackets();
-        bool setNonBlocking();
-        bool setTcpNoDelay();
+        bool connectSocket();
+        void dropConnection();
+        bool setNonBlocking(SocketType socket);
+        bool setTcpNoDelay(SocketType socket);
 
         std::string host_;
         uint16_t port_;
-        SocketType socket_;
+        std::unique_ptr<Connection> connection_;
+        SocketType connectingSocket_ = INVALID_SOCKET_VALUE; // TCP connect in progress
 
         std::vector<uint8_t> receiveBuffer_;
         LatencyBuffer<ByteBuffer> outgoingBuffer_;
         LatencyBuffer<WorldStatePacket> incomingWorldStates_;
 
         bool connected_;
+        Link link_ = Link::Offline;
+        std::chrono::steady_clock::time_point joinDeadline_;
+        bool joined_ = false;
 
         PlayerID assignedPlayerId_ = 0;
+        uint64_t sessionToken_ = 0;
+        bool resumed_ = false;
+        uint32_t roomId_ = 0;
     };
 
 } // namespace CoinCollector
@@ -3,23 +3,26 @@
 //
 
 #include "GameClient.hpp"
+#include "AllocationCounter.hpp"
 #include "ClientNetwork.hpp"
 #include "Render.hpp"
 #include "GameProtocol.hpp"
 #include "Prediction.hpp"
 #include "Interpolation.hpp"
+#include "Log.hpp"
+#include "TickScheduler.hpp"
+#include "Trace.hpp"
 
 #include <SFML/Graphics.hpp>
 #include <SFML/Window.hpp>
 
+#include <algorithm>
 #include <chrono>
-#include <thread>
-#include <iostream>
 
 namespace CoinCollector {
 
-GameClient::GameClient(const std::string& serverHost, uint16_t serverPort)
-    : serverHost_(serverHost), serverPort_(serverPort), myPlayerId_(0),
+GameClient::GameClient(const std::string& serverHost, uint16_t serverPort, uint32_t roomId)
+    : serverHost_(serverHost), serverPort_(serverPort), requestedRoom_(roomId), myPlayerId_(0),
       lastReceivedTick_(0) {
 
     network_ = std::make_unique<ClientNetwork>(serverHost, serverPort);
@@ -27,6 +30,9 @@ GameClient::GameClient(const std::string& serverHost, uint16_t serverPort)
 
     localPlayer_.id = 0;
     localPlayer_.position = Vec2(WORLD_WIDTH / 2, WORLD_HEIGHT / 2);
+
+    backoffRng_.reseed(static_cast<uint64_t>(
+        std::chrono::steady_clock::now().time_since_epoch().count()));
 }
 
 GameClient::~GameClient() {
@@ -34,33 +40,20 @@ GameClient::~GameClient() {
 }
 
 bool GameClient::connect() {
-    if (!network_->connect()) {
-        return false;
-    }
-
-    // Send handshake
-    ByteBuffer handshake = GameProtocol::serializeHandshake(0);
-    network_->send(handshake);
-    std::cout << "Waiting for Player ID..." << std::endl;
-    for(int i=0; i<100; i++) {
-        network_->update();
-        PlayerID id = network_->getPlayerId();
-        if (id != 0) {
-            myPlayerId_ = id; // <--- SUCCESS! Update the GameClient ID
-            std::cout << "GameClient initialized with ID: " << myPlayerId_ << std::endl;
-            return true;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-    }
-    std::cerr << "Timed out waiting for Player ID" << std::endl;
-    return false;
+    // The handshake completes inside run(), which renders meanwhile
+    return network_->join(requestedRoom_);
 }
 
 void GameClient::run() {
     auto lastTime = std::chrono::steady_clock::now();
     float accumulator = 0.0f;
+    TickScheduler frameScheduler(std::chrono::duration_cast<TickScheduler::Clock::duration>(
+        std::chrono::duration<double>(1.0 / CLIENT_FRAME_RATE)));
+    frameScheduler.reset();
 
     while (renderer_->isOpen()) {
+        TRACE_SCOPE("client", "frame");
+        uint64_t frameAllocations = AllocationCounter::total();
         auto currentTime = std::chrono::steady_clock::now();
         float frameTime = std::chrono::duration<float>(currentTime - lastTime).count();
         lastTime = currentTime;
@@ -76,42 +69,106 @@ void GameClient::run() {
             }
         }
 
+        updateConnection();
+
         // Fixed timestep for game logic
         while (accumulator >= FIXED_DT) {
+            TRACE_SCOPE("client", "fixed_step");
             processInput();
             updatePrediction(FIXED_DT);
             network_->update();
 
             // Process incoming world state
-            WorldStatePacket worldState;
-            if (network_->popWorldState(worldState)) {
-                lastReceivedTick_ = worldState.tick;
+            if (network_->popWorldState(worldState_)) {
+                lastReceivedTick_ = worldState_.tick;
+                interpolation_.observeServerTick(worldState_.tick);
 
                 // Find local player in world state
-                for (const auto& player : worldState.players) {
+                for (const auto& player : worldState_.players) {
                     if (player.id == myPlayerId_) {
                         // Reconcile with server
                         localPlayer_.score = player.score;
-                        prediction_.reconcile(player, worldState.tick,
+                        prediction_.reconcile(player, player.lastProcessedSeq,
                                              localPlayer_, FIXED_DT);
                     } else {
                         // Add to interpolation
-                        interpolation_.addSnapshot(player, worldState.tick);
+                        interpolation_.addSnapshot(player, worldState_.tick);
                     }
                 }
 
-                coins_ = worldState.coins;
+                // The old coin list goes back to the network queue with worldState_
+                coins_.swap(worldState_.coins);
             }
 
-            updateInterpolation();
             accumulator -= FIXED_DT;
         }
 
+        // Remote players follow the server tick timeline, once per frame
+        updateInterpolation();
+
+        // Glide out any reconciliation error on the local player
+        prediction_.decayError(frameTime);
+
+        uint64_t afterUpdate = AllocationCounter::total();
+        updateAllocations_ = afterUpdate - frameAllocations;
+
         // Render with interpolation alpha
         float alpha = accumulator / FIXED_DT;
         render(alpha);
+        renderAllocations_ = AllocationCounter::total() - afterUpdate;
+
+        // A slow frame just starts the next one late; the accumulator absorbs it
+        frameScheduler.waitForNextTick();
+    }
+}
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+void GameClient::updateConnection() {
+    if (network_->pollJoined()) {
+        onJoined();
+        return;
+    }
+
+    // Online or still joining (a redirect joins on its own): keep playing
+    if (network_->getLink() != ClientNetwork::Link::Offline) return;
+
+    auto now = std::chrono::steady_clock::now();
+    if (now < nextReconnectAt_) return;
+
+    if (!network_->join(requestedRoom_)) {
+        LOG_WARN("GameClient", "Reconnect failed");
+    }
+    // A join the server never answers falls back to Offline by itself
+    scheduleReconnect(now);
+}
+
+void GameClient::scheduleReconnect(std::chrono::steady_clock::time_point now) {
+    // Wait somewhere in [delay/2, delay), then double the delay
+    int waitMs = reconnectDelayMs_ / 2 +
+                 static_cast<int>(backoffRng_.nextBounded(static_cast<uint32_t>(reconnectDelayMs_ / 2)));
+    nextReconnectAt_ = now + std::chrono::milliseconds(waitMs);
+    reconnectDelayMs_ = std::min(reconnectDelayMs_ * 2, RECONNECT_BACKOFF_MAX_MS);
+}
+
+void GameClient::onJoined() {
+    PlayerID previousId = myPlayerId_;
+    myPlayerId_ = network_->getPlayerId();
+    reconnectDelayMs_ = RECONNECT_BACKOFF_MIN_MS;
+    nextReconnectAt_ = std::chrono::steady_clock::time_point();
+
+    if (previousId == 0) {
+        LOG_INFO("GameClient", "Connected to server, joined as player " << myPlayerId_);
+        localPlayer_.id = myPlayerId_;
+    } else if (network_->wasResumed()) {
+        // Same player; the full snapshot that follows reconciles any drift,
+        // and the interpolation timeline resets itself if the server's tick went back
+        LOG_INFO("GameClient", "Session resumed as player " << myPlayerId_);
+    } else {
+        // Grace period ran out: start over as a new player
+        LOG_INFO("GameClient", "Session lost, joined as player " << myPlayerId_ << " (was " << previousId << ")");
+        prediction_.clear();
+        interpolation_.clear();
+        remotePlayers_.clear();
+        localPlayer_ = PlayerState(myPlayerId_, Vec2(WORLD_WIDTH / 2, WORLD_HEIGHT / 2));
     }
 }
 
@@ -149,8 +206,7 @@ void GameClient::processInput() {
         // Apply prediction and send to server
         SequenceID seq = prediction_.applyInput(localPlayer_, currentInput_, FIXED_DT);
 
-        ByteBuffer packet = GameProtocol::serializeInput(seq, currentInput_);
-        network_->send(packet);
+        network_->send(GameProtocol::serializeInput(seq, currentInput_, lastReceivedTick_));
 
 }
 
@@ -160,23 +216,23 @@ void GameClient::updatePrediction(float dt) {
 }
 
 void GameClient::updateInterpolation() {
-    remotePlayers_.clear();
+    interpolation_.advance();
 
-    // Get interpolated positions for all remote players
-    for (const auto& player : interpolation_.getAllPlayers()) {
-        PlayerState interpolated;
-        if (interpolation_.getInterpolatedState(player, interpolated)) {
-            remotePlayers_.push_back(interpolated);
-        }
-    }
+    // Interpolate all remote players in one pass; resize only grows capacity
+    remotePlayers_.resize(interpolation_.entityCount());
+    size_t count = interpolation_.interpolateAll(remotePlayers_.data(), remotePlayers_.size());
+    remotePlayers_.resize(count);
 }
 
 void GameClient::render(float alpha) {
+    TRACE_SCOPE("render", "draw");
     (void)alpha;
     renderer_->clear();
 
-    // Draw local player (green)
-    renderer_->drawPlayer(localPlayer_, sf::Color::Green, true);
+    // Draw local player (green), offset by the decaying correction error
+    PlayerState shownPlayer = localPlayer_;
+    shownPlayer.position = prediction_.getRenderPosition(localPlayer_);
+    renderer_->drawPlayer(shownPlayer, sf::Color::Green, true);
 
     // Draw remote players (red)
     for (const auto& player : remotePlayers_) {
@@ -191,7 +247,7 @@ void GameClient::render(float alpha) {
     }
 
     // Draw HUD
-    renderer_->drawHUD(localPlayer_, lastReceivedTick_);
+    renderer_->drawHUD(localPlayer_, lastReceivedTick_, updateAllocations_, renderAllocations_);
 
     renderer_->display();
 }
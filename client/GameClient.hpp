@@ -9,12 +9,15 @@
 #pragma once
 #include "Shared.hpp"
 #include <string>
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <vector>
 
+#include "ClientNetwork.hpp"
 #include "Prediction.hpp"
 #include "Interpolation.hpp"
+#include "Random.hpp"
 
 namespace CoinCollector {
     class ClientNetwork;
@@ -24,7 +27,8 @@ namespace CoinCollector {
 
     class GameClient {
     public:
-        GameClient(const std::string& serverHost, uint16_t serverPort);
+        // roomId 0 lets the server pick a room
+        GameClient(const std::string& serverHost, uint16_t serverPort, uint32_t roomId = 0);
         ~GameClient();
 
         bool connect();
@@ -32,6 +36,10 @@ namespace CoinCollector {
         void disconnect();
 
     private:
+        // Once per frame: notice a finished join, or start the next one when offline
+        void updateConnection();
+        void scheduleReconnect(std::chrono::steady_clock::time_point now);
+        void onJoined();
         void processInput();
         void updatePrediction(float dt);
         void updateInterpolation();
@@ -39,6 +47,7 @@ namespace CoinCollector {
 
         std::string serverHost_;
         uint16_t serverPort_;
+        uint32_t requestedRoom_;
         PlayerID myPlayerId_;
 
         std::unique_ptr<ClientNetwork> network_;
@@ -51,8 +60,20 @@ namespace CoinCollector {
         std::vector<PlayerState> remotePlayers_;
         std::vector<CoinState> coins_;
 
+        // Latest world state; swapped with the network's queue, never reallocated
+        WorldStatePacket worldState_;
+
+        // Heap allocations in the last frame, for the HUD
+        uint64_t updateAllocations_ = 0;
+        uint64_t renderAllocations_ = 0;
+
         InputState currentInput_;
         uint32_t lastReceivedTick_;
+
+        // Jittered exponential backoff so a server blip doesn't bring every client back at once
+        std::chrono::steady_clock::time_point nextReconnectAt_;
+        int reconnectDelayMs_ = RECONNECT_BACKOFF_MIN_MS;
+        Pcg32 backoffRng_;
     };
 
 } // namespace CoinCollector
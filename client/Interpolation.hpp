@@ -8,28 +8,125 @@
 
 #include "Shared.hpp"
 #include "GameCommon.hpp"
-#include <map>
-#include <deque>
+#include <array>
+#include <unordered_map>
+#include <vector>
 #include <chrono>
+#include <cmath>
+#include <algorithm>
 
 namespace CoinCollector {
 
 /**
  * Entity interpolation for remote players
  *
- * Maintains a buffer of snapshots and interpolates between them
- * with a small delay to ensure smooth movement.
+ * Snapshots are placed on the server's tick timeline rather than stamped
+ * with their arrival time. Arrival times are only used to estimate a
+ * smoothed client-to-server clock offset, from which a render time is
+ * derived that trails the server by an adaptive, jitter-based delay.
+ *
+ * When a packet is late, entities are dead-reckoned from their last
+ * velocity for a bounded time, and the correction is blended in once
+ * the real snapshot arrives.
  */
 class InterpolationEngine {
 public:
     struct Snapshot {
         PlayerState state;
-        TimePoint timestamp;
         uint32_t tick;
     };
 
+    // Snapshots kept per entity (~3 seconds at the 20Hz broadcast rate)
+    static constexpr size_t SNAPSHOT_CAPACITY = 64;
+    static_assert((SNAPSHOT_CAPACITY & (SNAPSHOT_CAPACITY - 1)) == 0,
+                  "SNAPSHOT_CAPACITY must be a power of two");
+
+    /**
+     * Fixed-capacity ring of snapshots ordered by tick, oldest first.
+     * Pushing into a full ring overwrites the oldest snapshot.
+     */
+    class SnapshotRing {
+    public:
+        void push(const Snapshot& snapshot) {
+            entries_[(head_ + count_) & (SNAPSHOT_CAPACITY - 1)] = snapshot;
+            if (count_ < SNAPSHOT_CAPACITY) {
+                ++count_;
+            } else {
+                head_ = (head_ + 1) & (SNAPSHOT_CAPACITY - 1);
+            }
+        }
+
+        const Snapshot& operator[](size_t i) const {
+            return entries_[(head_ + i) & (SNAPSHOT_CAPACITY - 1)];
+        }
+
+        const Snapshot& back() const { return (*this)[count_ - 1]; }
+        size_t size() const { return count_; }
+        bool empty() const { return count_ == 0; }
+
+        /**
+         * Index of the first snapshot whose tick is greater than renderTick
+         * (binary search, returns size() if there is none)
+         */
+        size_t upperBound(double renderTick) const {
+            size_t lo = 0;
+            size_t hi = count_;
+            while (lo < hi) {
+                size_t mid = (lo + hi) / 2;
+                if ((*this)[mid].tick <= renderTick) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            return lo;
+        }
+
+    private:
+        std::array<Snapshot, SNAPSHOT_CAPACITY> entries_{};
+        size_t head_ = 0;
+        size_t count_ = 0;
+    };
+
     InterpolationEngine()
-        : interpolationDelay_(std::chrono::milliseconds(INTERPOLATION_DELAY_MS)) {}
+        : interpolationDelay_(INTERPOLATION_DELAY_MS / 1000.0) {}
+
+    /**
+     * Feed the arrival of a world state into the clock estimate.
+     * Call once per received world state, before adding its snapshots.
+     */
+    void observeServerTick(uint32_t tick,
+                           TimePoint arrival = std::chrono::steady_clock::now()) {
+        // The server's clock went backwards (restart from a checkpoint):
+        // every ring is ahead of it and would drop its snapshots, so start over
+        if (clockSynced_ && tick + MAX_TICK_REGRESSION < latestTick_) {
+            clear();
+        }
+
+        double localTime = toSeconds(arrival);
+        double serverTime = tick * static_cast<double>(FIXED_DT);
+        double sample = localTime - serverTime;
+
+        if (!clockSynced_) {
+            clockOffset_ = sample;
+            jitter_ = 0.0;
+            renderTime_ = serverTime - interpolationDelay_;
+            lastAdvance_ = arrival;
+            clockSynced_ = true;
+        } else {
+            double deviation = sample - clockOffset_;
+            clockOffset_ += deviation * CLOCK_SMOOTHING;
+            jitter_ += (std::abs(deviation) - jitter_) * JITTER_SMOOTHING;
+
+            if (tick > latestTick_) {
+                double interval = (tick - latestTick_) * static_cast<double>(FIXED_DT);
+                snapshotInterval_ += (interval - snapshotInterval_) * JITTER_SMOOTHING;
+            }
+        }
+
+        latestTick_ = std::max(latestTick_, tick);
+        updateInterpolationDelay();
+    }
 
     /**
      * Add a new snapshot for a player
@@ -37,107 +134,279 @@ public:
     void addSnapshot(const PlayerState& state, uint32_t tick) {
         Snapshot snapshot;
         snapshot.state = state;
-        snapshot.timestamp = std::chrono::steady_clock::now();
         snapshot.tick = tick;
 
-        auto& buffer = snapshots_[state.id];
-        buffer.push_back(snapshot);
+        Entity& entity = findOrCreate(state.id);
+        SnapshotRing& buffer = entity.snapshots;
+
+        // Drop duplicates and out-of-order snapshots; the timeline is monotonic
+        if (!buffer.empty() && tick <= buffer.back().tick) {
+            return;
+        }
+        buffer.push(snapshot);
 
-        // Keep buffer size reasonable (1 second worth at 60Hz = 60 snapshots)
-        if (buffer.size() > 60) {
-            buffer.pop_front();
+        // A real snapshot replaces dead reckoning; blend out the difference
+        if (entity.extrapolating) {
+            entity.extrapolating = false;
+            entity.correctionPending = true;
         }
     }
 
     /**
-     * Get interpolated position for a player
+     * Configure dead reckoning past the newest snapshot
      *
-     * @param playerId The player to interpolate
-     * @param outState Output interpolated state
-     * @return true if interpolation was successful
+     * @param maxExtrapolationMs Longest span to extrapolate with the last velocity
+     * @param correctionBlendMs Time over which a late snapshot's correction is blended in
      */
-    bool getInterpolatedState(PlayerID playerId, PlayerState& outState) {
-        auto it = snapshots_.find(playerId);
-        if (it == snapshots_.end() || it->second.size() < 2) {
-            return false; // Need at least 2 snapshots to interpolate
-        }
+    void setExtrapolation(int maxExtrapolationMs, int correctionBlendMs) {
+        maxExtrapolation_ = std::max(0, maxExtrapolationMs) / 1000.0;
+        correctionBlendTime_ = std::max(0, correctionBlendMs) / 1000.0;
+    }
 
-        auto& buffer = it->second;
-        auto renderTime = std::chrono::steady_clock::now() - interpolationDelay_;
+    /**
+     * Advance the render timeline. Call once per rendered frame.
+     *
+     * Playback is nudged slightly faster or slower to converge on the
+     * target render time, and only snaps when it is far off.
+     */
+    void advance(TimePoint now = std::chrono::steady_clock::now()) {
+        if (!clockSynced_) return;
 
-        // Find two snapshots surrounding the render time
-        Snapshot* before = nullptr;
-        Snapshot* after = nullptr;
+        double frameTime = std::chrono::duration<double>(now - lastAdvance_).count();
+        lastAdvance_ = now;
+        if (frameTime < 0.0) frameTime = 0.0;
 
-        for (size_t i = 0; i < buffer.size() - 1; ++i) {
-            if (buffer[i].timestamp <= renderTime && buffer[i + 1].timestamp >= renderTime) {
-                before = &buffer[i];
-                after = &buffer[i + 1];
-                break;
-            }
-        }
+        double targetTime = (toSeconds(now) - clockOffset_) - interpolationDelay_;
+        double error = targetTime - renderTime_;
 
-        if (!before || !after) {
-            // Render time is outside buffer range, use latest
-            outState = buffer.back().state;
-            return true;
+        if (std::abs(error) > MAX_TIMELINE_ERROR) {
+            renderTime_ = targetTime;
+            timeScale_ = 1.0;
+            return;
         }
 
-        // Interpolate between the two snapshots
-        auto timeDiff = std::chrono::duration_cast<std::chrono::milliseconds>(
-            after->timestamp - before->timestamp
-        ).count();
-
-        auto timeFromBefore = std::chrono::duration_cast<std::chrono::milliseconds>(
-            renderTime - before->timestamp
-        ).count();
+        timeScale_ = 1.0 + std::max(-MAX_TIME_SCALE_ADJUST,
+                                    std::min(MAX_TIME_SCALE_ADJUST, error * TIME_SCALE_GAIN));
 
-        float alpha = (timeDiff > 0) ? (static_cast<float>(timeFromBefore) / timeDiff) : 0.0f;
-        alpha = std::max(0.0f, std::min(1.0f, alpha)); // Clamp to [0, 1]
+        // Buffer drained: we are already rendering past the newest snapshot
+        double newestTime = latestTick_ * static_cast<double>(FIXED_DT);
+        if (renderTime_ >= newestTime) {
+            timeScale_ = std::min(timeScale_, 1.0 - MAX_TIME_SCALE_ADJUST);
+        }
 
-        // Interpolate position
-        outState = before->state;
-        outState.position = GameCommon::lerp(before->state.position, after->state.position, alpha);
-        outState.score = after->state.score; // Don't interpolate score
+        renderTime_ += frameTime * timeScale_;
+    }
 
-        return true;
+    /**
+     * Get interpolated position for a player
+     *
+     * @param playerId The player to interpolate
+     * @param outState Output interpolated state
+     * @return true if interpolation was successful
+     */
+    bool getInterpolatedState(PlayerID playerId, PlayerState& outState) {
+        auto it = index_.find(playerId);
+        if (it == index_.end()) {
+            return false;
+        }
+        return sample(entities_[it->second], getRenderTick(), outState);
     }
 
-    std::vector<PlayerID> getAllPlayers() const {
-        std::vector<PlayerID> ids;
-        // CHANGE 'buffer' TO 'snapshots_'
-        for (const auto& pair : snapshots_) {
-            ids.push_back(pair.first);
+    /**
+     * Interpolate every remote entity into a caller-provided array.
+     * Does not allocate; use entityCount() to size the output.
+     *
+     * @return Number of states written (at most capacity)
+     */
+    size_t interpolateAll(PlayerState* out, size_t capacity) {
+        double renderTick = getRenderTick();
+        size_t written = 0;
+        for (auto& entity : entities_) {
+            if (written == capacity) break;
+            if (sample(entity, renderTick, out[written])) {
+                ++written;
+            }
         }
-        return ids;
+        return written;
     }
 
+    size_t entityCount() const { return entities_.size(); }
+
     /**
      * Remove all snapshots for a player (when they disconnect)
      */
     void removePlayer(PlayerID playerId) {
-        snapshots_.erase(playerId);
+        auto it = index_.find(playerId);
+        if (it == index_.end()) return;
+
+        // Swap-remove to keep entity storage dense
+        size_t slot = it->second;
+        index_.erase(it);
+        if (slot != entities_.size() - 1) {
+            entities_[slot] = entities_.back();
+            index_[entities_[slot].id] = slot;
+        }
+        entities_.pop_back();
     }
 
     /**
-     * Clear all snapshots
+     * Clear all snapshots and reset the clock estimate
      */
     void clear() {
-        snapshots_.clear();
+        entities_.clear();
+        index_.clear();
+        clockSynced_ = false;
+        latestTick_ = 0;
+        timeScale_ = 1.0;
+        interpolationDelay_ = INTERPOLATION_DELAY_MS / 1000.0;
     }
 
     /**
      * Get buffer size for a player (debugging)
      */
     size_t getBufferSize(PlayerID playerId) const {
-        auto it = snapshots_.find(playerId);
-        return (it != snapshots_.end()) ? it->second.size() : 0;
+        auto it = index_.find(playerId);
+        return (it != index_.end()) ? entities_[it->second].snapshots.size() : 0;
     }
 
+    // Timeline diagnostics
+    double getRenderTick() const { return renderTime_ / static_cast<double>(FIXED_DT); }
+    double getInterpolationDelay() const { return interpolationDelay_; }
+    double getJitter() const { return jitter_; }
+    double getTimeScale() const { return timeScale_; }
+
 private:
-    std::map<PlayerID, std::deque<Snapshot>> snapshots_;
-    std::chrono::milliseconds interpolationDelay_;
+    // Smoothing factors for the clock offset and jitter estimates (EWMA)
+    static constexpr double CLOCK_SMOOTHING = 0.05;
+    static constexpr double JITTER_SMOOTHING = 0.1;
+    // Delay = snapshot interval + JITTER_DELAY_SCALE * jitter. Late packets
+    // beyond that are covered by extrapolation, so the margin stays small.
+    static constexpr double JITTER_DELAY_SCALE = 2.0;
+    // Playback speed correction (fraction of real time)
+    static constexpr double TIME_SCALE_GAIN = 0.5;
+    static constexpr double MAX_TIME_SCALE_ADJUST = 0.05;
+    // Beyond this the timeline snaps instead of converging (seconds)
+    static constexpr double MAX_TIMELINE_ERROR = 0.25;
+    // A tick this far behind the newest one resets the timeline; a resumed
+    // session's full snapshot may repeat a tick, which is not a regression
+    static constexpr uint32_t MAX_TICK_REGRESSION = 2 * BROADCAST_INTERVAL_TICKS;
+
+    static double toSeconds(TimePoint t) {
+        return std::chrono::duration<double>(t.time_since_epoch()).count();
+    }
+
+    void updateInterpolationDelay() {
+        double target = snapshotInterval_ + JITTER_DELAY_SCALE * jitter_;
+        interpolationDelay_ = std::max(MIN_INTERPOLATION_DELAY_MS / 1000.0,
+                                       std::min(MAX_INTERPOLATION_DELAY_MS / 1000.0, target));
+    }
+
+    struct Entity {
+        PlayerID id;
+        SnapshotRing snapshots;
+
+        // Dead reckoning / correction blending
+        bool extrapolating = false;
+        bool correctionPending = false;
+        bool hasRendered = false;
+        Vec2 lastRendered;
+        Vec2 correctionOffset;
+        double correctionStartTick = 0.0;
+    };
+
+    Entity& findOrCreate(PlayerID playerId) {
+        auto it = index_.find(playerId);
+        if (it != index_.end()) {
+            return entities_[it->second];
+        }
+        Entity entity;
+        entity.id = playerId;
+        index_.emplace(playerId, entities_.size());
+        entities_.push_back(entity);
+        return entities_.back();
+    }
+
+    /**
+     * Position an entity at the render tick: interpolate inside the buffer,
+     * extrapolate (bounded) past its end, and blend any pending correction.
+     */
+    bool sample(Entity& entity, double renderTick, PlayerState& outState) {
+        const SnapshotRing& buffer = entity.snapshots;
+        if (buffer.size() < 2) {
+            return false; // Need at least 2 snapshots to interpolate
+        }
+
+        // Find two snapshots surrounding the render tick
+        size_t afterIdx = buffer.upperBound(renderTick);
+        if (afterIdx == 0) {
+            // Render time precedes the buffer, hold the oldest
+            outState = buffer[0].state;
+        } else if (afterIdx == buffer.size()) {
+            // Render time is past the newest snapshot, dead-reckon from it
+            const Snapshot& latest = buffer.back();
+            double ahead = std::min((renderTick - latest.tick) * FIXED_DT, maxExtrapolation_);
+
+            outState = latest.state;
+            outState.position = latest.state.position + latest.state.velocity * static_cast<float>(ahead);
+            GameCommon::clampPosition(outState.position);
+            entity.extrapolating = ahead > 0.0;
+        } else {
+            const Snapshot& before = buffer[afterIdx - 1];
+            const Snapshot& after = buffer[afterIdx];
+
+            // Interpolate between the two snapshots
+            double tickDiff = static_cast<double>(after.tick - before.tick);
+            double ticksFromBefore = renderTick - before.tick;
+
+            float alpha = (tickDiff > 0.0) ? static_cast<float>(ticksFromBefore / tickDiff) : 0.0f;
+            alpha = std::max(0.0f, std::min(1.0f, alpha)); // Clamp to [0, 1]
+
+            // Interpolate position
+            outState = before.state;
+            outState.position = GameCommon::lerp(before.state.position, after.state.position, alpha);
+            outState.score = after.state.score; // Don't interpolate score
+        }
+
+        // Start blending from where the entity was last drawn
+        if (entity.correctionPending) {
+            entity.correctionPending = false;
+            if (entity.hasRendered && correctionBlendTime_ > 0.0) {
+                entity.correctionOffset = entity.lastRendered - outState.position;
+                entity.correctionStartTick = renderTick;
+            }
+        }
+
+        if (correctionBlendTime_ > 0.0) {
+            double elapsed = (renderTick - entity.correctionStartTick) * FIXED_DT;
+            float weight = static_cast<float>(1.0 - elapsed / correctionBlendTime_);
+            if (weight > 0.0f) {
+                outState.position = outState.position + entity.correctionOffset * std::min(1.0f, weight);
+            } else {
+                entity.correctionOffset = Vec2();
+            }
+        }
+
+        entity.lastRendered = outState.position;
+        entity.hasRendered = true;
+        return true;
+    }
+
+    // Dense entity storage; index_ maps player id to slot
+    std::vector<Entity> entities_;
+    std::unordered_map<PlayerID, size_t> index_;
+
+    bool clockSynced_ = false;
+    double clockOffset_ = 0.0;      // local time - server time (seconds)
+    double jitter_ = 0.0;           // mean absolute deviation of arrivals (seconds)
+    double snapshotInterval_ = BROADCAST_INTERVAL_TICKS * static_cast<double>(FIXED_DT);
+    double interpolationDelay_;     // seconds
+    double renderTime_ = 0.0;       // server time being rendered (seconds)
+    double timeScale_ = 1.0;
+    double maxExtrapolation_ = MAX_EXTRAPOLATION_MS / 1000.0;
+    double correctionBlendTime_ = EXTRAPOLATION_BLEND_MS / 1000.0;
+    uint32_t latestTick_ = 0;
+    TimePoint lastAdvance_;
 };
 
 } // namespace CoinCollector
-#endif //KRAFTON_INTERPOLATION_HPP
\ No newline at end of file
+#endif //KRAFTON_INTERPOLATION_HPP
@@ -10,27 +10,48 @@
 
 #include "Shared.hpp"
 #include "GameCommon.hpp"
-#include <deque>
-#include <iostream>
+#include "Trace.hpp"
+#include <array>
 #include <algorithm>
+#include <cmath>
 
 namespace CoinCollector {
 
 /**
  * Client-side prediction with server reconciliation
  *
- * Maintains a history of inputs and predicted states.
- * When server state arrives, reconciles and replays inputs if necessary.
+ * Maintains a history of inputs and predicted states in a fixed-size ring
+ * indexed by sequence number. When server state arrives, reconciles and
+ * replays inputs if necessary.
+ *
+ * Corrections move the simulation state immediately, but the visible
+ * jump is kept in a render-space error offset that decays exponentially,
+ * so the player never sees a snap.
  */
 class PredictionEngine {
 public:
     struct HistoryEntry {
-        SequenceID sequenceId;
+        SequenceID sequenceId = 0; // 0 = empty slot
         InputState input;
         PlayerState predictedState;
     };
 
-    PredictionEngine() : nextSequenceId_(1) {}
+    struct Stats {
+        uint64_t corrections = 0;       // reconciles that exceeded the threshold
+        uint64_t replayedInputs = 0;    // inputs re-simulated across all corrections
+        uint64_t convergedReplays = 0;  // replays cut short once they rejoined the prediction
+        size_t lastReplayLength = 0;    // inputs re-simulated by the latest correction
+        size_t maxReplayLength = 0;
+        float lastError = 0.0f;         // pixels
+        float maxError = 0.0f;          // pixels
+    };
+
+    // ~2 seconds of inputs at 120Hz, ~1 second at 240Hz
+    static constexpr size_t HISTORY_CAPACITY = 256;
+    static_assert((HISTORY_CAPACITY & (HISTORY_CAPACITY - 1)) == 0,
+                  "HISTORY_CAPACITY must be a power of two");
+
+    PredictionEngine() : nextSequenceId_(1), oldestPendingSeq_(1) {}
 
     /**
      * Apply input with client-side prediction
@@ -43,16 +64,14 @@ public:
         GameCommon::applyInput(localPlayer, input, dt);
 
         // Store in history for reconciliation
-        HistoryEntry entry;
+        HistoryEntry& entry = slot(seqId);
         entry.sequenceId = seqId;
         entry.input = input;
         entry.predictedState = localPlayer;
 
-        history_.push_back(entry);
-
-        // Limit history size (keep last 2 seconds worth at 60Hz = 120 entries)
-        if (history_.size() > 120) {
-            history_.pop_front();
+        // Ring full: the oldest unacknowledged input is overwritten
+        if (nextSequenceId_ - oldestPendingSeq_ > HISTORY_CAPACITY) {
+            oldestPendingSeq_ = nextSequenceId_ - HISTORY_CAPACITY;
         }
 
         return seqId;
@@ -72,59 +91,167 @@ public:
         PlayerState& currentPlayer,
         float dt
     ) {
-        // Remove acknowledged inputs from history
-        while (!history_.empty() && history_.front().sequenceId <= lastProcessedSeq) {
-            history_.pop_front();
+        // Ack older than one we already reconciled against
+        if (lastProcessedSeq + 1 < oldestPendingSeq_) {
+            return;
         }
 
+        // Acknowledged inputs leave the pending range (O(1), no erase)
+        oldestPendingSeq_ = std::max(oldestPendingSeq_, lastProcessedSeq + 1);
+
         // Check if we need to reconcile
-        if (history_.empty()) {
+        if (oldestPendingSeq_ >= nextSequenceId_) {
             // Server is caught up, just use server state
+            oldestPendingSeq_ = nextSequenceId_;
+            Vec2 shownPos = currentPlayer.position;
             currentPlayer = serverState;
+            absorbCorrection(shownPos, currentPlayer.position);
             return;
         }
 
-        // Find the history entry for lastProcessedSeq
-        auto it = std::find_if(history_.begin(), history_.end(),
-            [lastProcessedSeq](const HistoryEntry& e) {
-                return e.sequenceId == lastProcessedSeq;
-            });
+        // What we predicted for the acknowledged input
+        HistoryEntry* acked = find(lastProcessedSeq);
+        Vec2 predictedPos = acked ? acked->predictedState.position : currentPlayer.position;
 
         // Calculate prediction error
-        Vec2 predictedPos = (it != history_.end()) ? it->predictedState.position : currentPlayer.position;
         Vec2 serverPos = serverState.position;
         float errorMagnitude = (predictedPos - serverPos).length();
 
-        const float RECONCILIATION_THRESHOLD = 5.0f; // pixels
-
-        if (errorMagnitude > RECONCILIATION_THRESHOLD) {
+        if (errorMagnitude > reconciliationThreshold_) {
             // Significant mismatch - need to reconcile
-            std::cout << "[Reconciliation] Error: " << errorMagnitude
-                      << "px, replaying " << history_.size() << " inputs" << std::endl;
+            TRACE_SCOPE("client", "reconcile_replay");
+            Vec2 shownPos = currentPlayer.position;
+            size_t replayed = replayFrom(serverState, currentPlayer, dt);
+            if (acked) {
+                acked->predictedState = serverState;
+            }
 
-            // Start from server state
-            currentPlayer = serverState;
+            stats_.corrections++;
+            stats_.replayedInputs += replayed;
+            stats_.lastReplayLength = replayed;
+            stats_.maxReplayLength = std::max(stats_.maxReplayLength, replayed);
+            stats_.lastError = errorMagnitude;
+            stats_.maxError = std::max(stats_.maxError, errorMagnitude);
 
-            // Replay all unacknowledged inputs
-            for (const auto& entry : history_) {
-                GameCommon::applyInput(currentPlayer, entry.input, dt);
-            }
+            absorbCorrection(shownPos, currentPlayer.position);
         } else {
             // Small error or no error - keep prediction
             // This avoids visible snapping for minor discrepancies
         }
     }
 
+    /**
+     * Decay the visual error offset. Call once per rendered frame.
+     */
+    void decayError(float dt) {
+        float factor = std::exp(-errorDecayRate_ * dt);
+        errorOffset_ = errorOffset_ * factor;
+        if (errorOffset_.lengthSquared() < 0.01f * 0.01f) {
+            errorOffset_ = Vec2();
+        }
+    }
+
+    /**
+     * Position to draw the local player at: simulation plus error offset
+     */
+    Vec2 getRenderPosition(const PlayerState& localPlayer) const {
+        return localPlayer.position + errorOffset_;
+    }
+
+    Vec2 getErrorOffset() const { return errorOffset_; }
+
+    /**
+     * @param thresholdPx Prediction error below which corrections are ignored
+     */
+    void setReconciliationThreshold(float thresholdPx) { reconciliationThreshold_ = thresholdPx; }
+
+    /**
+     * @param ratePerSecond Exponential decay rate of the visual error offset
+     */
+    void setErrorDecayRate(float ratePerSecond) { errorDecayRate_ = ratePerSecond; }
+
+    const Stats& getStats() const { return stats_; }
+
     void clear() {
-        history_.clear();
+        history_.fill(HistoryEntry());
         nextSequenceId_ = 1;
+        oldestPendingSeq_ = 1;
+        errorOffset_ = Vec2();
+        stats_ = Stats();
     }
 
-    size_t historySize() const { return history_.size(); }
+    // Number of unacknowledged inputs
+    size_t historySize() const { return nextSequenceId_ - oldestPendingSeq_; }
 
 private:
-    std::deque<HistoryEntry> history_;
+    // Replay stops early once a step lands this close to the old prediction
+    static constexpr float CONVERGENCE_EPSILON = 0.001f;
+
+    HistoryEntry& slot(SequenceID seq) { return history_[seq & (HISTORY_CAPACITY - 1)]; }
+
+    HistoryEntry* find(SequenceID seq) {
+        HistoryEntry& entry = slot(seq);
+        return (seq != 0 && entry.sequenceId == seq) ? &entry : nullptr;
+    }
+
+    /**
+     * Re-simulate pending inputs on top of the server state, overwriting
+     * their stored predictions. Once a step matches the old prediction the
+     * rest of the history is still valid, so the replay ends there.
+     *
+     * @return Number of inputs re-simulated
+     */
+    size_t replayFrom(const PlayerState& serverState, PlayerState& currentPlayer, float dt) {
+        PlayerState state = serverState;
+        size_t replayed = 0;
+
+        for (SequenceID seq = oldestPendingSeq_; seq < nextSequenceId_; ++seq) {
+            HistoryEntry& entry = slot(seq);
+            GameCommon::applyInput(state, entry.input, dt);
+            ++replayed;
+
+            bool converged =
+                (state.position - entry.predictedState.position).lengthSquared() <
+                    CONVERGENCE_EPSILON * CONVERGENCE_EPSILON &&
+                (state.velocity - entry.predictedState.velocity).lengthSquared() <
+                    CONVERGENCE_EPSILON * CONVERGENCE_EPSILON;
+
+            entry.predictedState = state;
+
+            if (converged && seq + 1 < nextSequenceId_) {
+                // Later predictions are unchanged; resume from the newest one
+                stats_.convergedReplays++;
+                state = slot(nextSequenceId_ - 1).predictedState;
+                state.score = serverState.score;
+                break;
+            }
+        }
+
+        currentPlayer = state;
+        return replayed;
+    }
+
+    /**
+     * Keep the player drawn where it was: the simulation jumped from
+     * shownPos to newPos, so the offset takes up the difference.
+     */
+    void absorbCorrection(const Vec2& shownPos, const Vec2& newPos) {
+        errorOffset_ = errorOffset_ + (shownPos - newPos);
+
+        // Too far to glide (e.g. respawn); let it snap
+        if (errorOffset_.lengthSquared() > MAX_ERROR_OFFSET * MAX_ERROR_OFFSET) {
+            errorOffset_ = Vec2();
+        }
+    }
+
+    std::array<HistoryEntry, HISTORY_CAPACITY> history_{};
     SequenceID nextSequenceId_;
+    SequenceID oldestPendingSeq_; // first unacknowledged input
+
+    float reconciliationThreshold_ = RECONCILIATION_THRESHOLD;
+    float errorDecayRate_ = ERROR_DECAY_RATE;
+    Vec2 errorOffset_;
+    Stats stats_;
 };
 
 } // namespace CoinCollector
@@ -4,27 +4,59 @@
 
 #include "Render.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
-#include <sstream>
 #include <memory>
+#include <string>
 #include <SFML/Graphics/Color.hpp>
 #include <SFML/Graphics/RenderWindow.hpp>
 
 #include "Shared.hpp"
+#include "Trace.hpp"
 
 namespace CoinCollector {
 
-Renderer::Renderer() : fontLoaded_(false) {
+namespace {
+    // Two triangles covering one glyph, its pen (baseline) position at x, y
+    void glyphQuad(const sf::Glyph& glyph, float x, float y, const sf::Color& color, sf::Vertex (&quad)[6]) {
+        float left = x + glyph.bounds.left;
+        float top = y + glyph.bounds.top;
+        float right = left + glyph.bounds.width;
+        float bottom = top + glyph.bounds.height;
+        float u0 = static_cast<float>(glyph.textureRect.left);
+        float v0 = static_cast<float>(glyph.textureRect.top);
+        float u1 = u0 + static_cast<float>(glyph.textureRect.width);
+        float v1 = v0 + static_cast<float>(glyph.textureRect.height);
+
+        quad[0] = sf::Vertex(sf::Vector2f(left, top), color, sf::Vector2f(u0, v0));
+        quad[1] = sf::Vertex(sf::Vector2f(right, top), color, sf::Vector2f(u1, v0));
+        quad[2] = sf::Vertex(sf::Vector2f(left, bottom), color, sf::Vector2f(u0, v1));
+        quad[3] = sf::Vertex(sf::Vector2f(left, bottom), color, sf::Vector2f(u0, v1));
+        quad[4] = sf::Vertex(sf::Vector2f(right, top), color, sf::Vector2f(u1, v0));
+        quad[5] = sf::Vertex(sf::Vector2f(right, bottom), color, sf::Vector2f(u1, v1));
+    }
+}
+
+Renderer::Renderer()
+    : fontLoaded_(false), shapes_(sf::Triangles), labels_(sf::Triangles), hud_(sf::Triangles) {
     window_ = std::make_unique<sf::RenderWindow>(
         sf::VideoMode(static_cast<unsigned int>(WORLD_WIDTH),
                      static_cast<unsigned int>(WORLD_HEIGHT)),
         "Coin Collector Multiplayer"
     );
-    window_->setFramerateLimit(144);
+    // Frames are paced by GameClient::run, not by SFML's coarse sleep
 
     // Try to load default font (may not work on all systems)
     fontLoaded_ = font_.loadFromFile("/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf") ||
                   font_.loadFromFile("C:\\Windows\\Fonts\\arial.ttf");
+
+    for (size_t i = 0; i < CIRCLE_POINTS; ++i) {
+        float angle = 2.0f * 3.14159265f * static_cast<float>(i) / static_cast<float>(CIRCLE_POINTS);
+        unitCircle_[i] = sf::Vector2f(std::cos(angle), std::sin(angle));
+    }
 }
 
 Renderer::~Renderer() {
@@ -49,9 +81,37 @@ void Renderer::close() {
 
 void Renderer::clear() {
     window_->clear(sf::Color(30, 30, 30));
+    // Keeps the arrays' capacity, so a steady scene appends without allocating
+    shapes_.clear();
+    labels_.clear();
+    hudVisible_ = false;
+
+    // Players who left (other room, other shard, lost session) stop costing memory
+    frame_++;
+    if (frame_ % LABEL_EXPIRY_FRAMES == 0) {
+        for (auto it = labelCache_.begin(); it != labelCache_.end();) {
+            if (frame_ - it->second.lastDrawnFrame > LABEL_EXPIRY_FRAMES) {
+                it = labelCache_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
 }
 
 void Renderer::display() {
+    {
+        TRACE_SCOPE("render", "submit");
+        window_->draw(shapes_);
+        if (labels_.getVertexCount() > 0) {
+            window_->draw(labels_, sf::RenderStates(&font_.getTexture(LABEL_SIZE)));
+        }
+        if (hudVisible_) {
+            window_->draw(hud_, sf::RenderStates(&font_.getTexture(HUD_SIZE)));
+        }
+    }
+
+    TRACE_SCOPE("render", "present"); // includes any vsync wait
     window_->display();
 }
 
@@ -60,67 +120,131 @@ bool Renderer::hasFocus() const {
 }
 
 void Renderer::drawPlayer(const PlayerState& player, const sf::Color& color, bool isLocal) {
-    // 1. Draw the Player Circle (Existing Code)
-    sf::CircleShape circle(PLAYER_RADIUS);
-    circle.setOrigin(PLAYER_RADIUS, PLAYER_RADIUS);
-    circle.setPosition(player.position.x, player.position.y);
-    circle.setFillColor(color);
+    float x = player.position.x;
+    float y = player.position.y;
 
+    // A 2px white ring: a larger white disc under the player's own
     if (isLocal) {
-        circle.setOutlineColor(sf::Color::White);
-        circle.setOutlineThickness(2);
+        appendCircle(x, y, PLAYER_RADIUS + 2.0f, sf::Color::White, 1);
     }
+    appendCircle(x, y, PLAYER_RADIUS, color, 1);
 
-    window_->draw(circle);
-
-    // 2. Draw the ID Text (New Code)
     if (fontLoaded_) {
-        sf::Text idText;
-        idText.setFont(font_);
-        idText.setString(std::to_string(player.id));
-        idText.setCharacterSize(14); // Readable size
-        idText.setFillColor(sf::Color::White);
-
-        // Make text black for remote players (red background) for better contrast
-        if (!isLocal) {
-            idText.setFillColor(sf::Color::Black); // Black text on Red player
-        } else {
-            idText.setFillColor(sf::Color::Black); // Black text on Green player
-        }
-
-        // Center the text on the player
-        sf::FloatRect textBounds = idText.getLocalBounds();
-        idText.setOrigin(textBounds.left + textBounds.width / 2.0f,
-                         textBounds.top + textBounds.height / 2.0f);
-        idText.setPosition(player.position.x, player.position.y);
-
-        window_->draw(idText);
+        appendLabel(player.id, x, y);
     }
 }
 
 void Renderer::drawCoin(const CoinState& coin) {
-    sf::CircleShape circle(COIN_RADIUS);
-    circle.setPosition(coin.position.x - COIN_RADIUS,
-                       coin.position.y - COIN_RADIUS);
-    circle.setFillColor(sf::Color::Yellow);
-    window_->draw(circle);
+    // Coins are smaller, so half the points look just as round
+    appendCircle(coin.position.x, coin.position.y, COIN_RADIUS, sf::Color::Yellow, 2);
 }
 
-void Renderer::drawHUD(const PlayerState& localPlayer, uint32_t tick) {
+void Renderer::drawHUD(const PlayerState& localPlayer, uint32_t tick,
+                       uint64_t updateAllocations, uint64_t renderAllocations) {
     if (!fontLoaded_) return;
 
-    std::ostringstream oss;
-    oss << "Score: " << localPlayer.score << "\n";
-    oss << "Tick: " << tick << "\n";
-    oss << "Latency: " << SIMULATED_LATENCY_MS << "ms (simulated)";
+    char buffer[HUD_TEXT_SIZE];
+    std::snprintf(buffer, sizeof(buffer),
+                  "Score: %u\nTick: %u\nLatency: %dms (simulated)\nAllocs/frame: %llu update, %llu render",
+                  static_cast<unsigned int>(localPlayer.score), static_cast<unsigned int>(tick),
+                  SIMULATED_LATENCY_MS, static_cast<unsigned long long>(updateAllocations),
+                  static_cast<unsigned long long>(renderAllocations));
+
+    // Re-layout the text only when it reads differently
+    if (std::strcmp(hudText_.data(), buffer) != 0) {
+        std::memcpy(hudText_.data(), buffer, sizeof(buffer));
+        layoutHUD(hudText_.data());
+    }
+    hudVisible_ = true;
+}
+
+void Renderer::layoutHUD(const char* text) {
+    // Keeps the array's capacity; the glyphs are cached in the font after first use
+    hud_.clear();
+    const float originX = 10.0f;
+    const float originY = 10.0f + static_cast<float>(HUD_SIZE);
+    const float lineSpacing = font_.getLineSpacing(HUD_SIZE);
+
+    for (float outline : {HUD_OUTLINE, 0.0f}) {
+        const sf::Color color = outline > 0.0f ? sf::Color::Black : sf::Color::White;
+        float penX = originX;
+        float penY = originY;
+        for (const char* c = text; *c != '\0'; ++c) {
+            if (*c == '\n') {
+                penX = originX;
+                penY += lineSpacing;
+                continue;
+            }
+            uint32_t codePoint = static_cast<unsigned char>(*c);
+            sf::Vertex quad[6];
+            glyphQuad(font_.getGlyph(codePoint, HUD_SIZE, false, outline), penX, penY, color, quad);
+            for (const sf::Vertex& vertex : quad) {
+                hud_.append(vertex);
+            }
+            penX += font_.getGlyph(codePoint, HUD_SIZE, false).advance;
+        }
+    }
+}
 
-    sf::Text text(oss.str(), font_, 16);
-    text.setPosition(10, 10);
-    text.setFillColor(sf::Color::White);
-    text.setOutlineColor(sf::Color::Black);
-    text.setOutlineThickness(1);
+void Renderer::appendCircle(float x, float y, float radius, const sf::Color& color, size_t step) {
+    sf::Vector2f center(x, y);
+    for (size_t i = 0; i < CIRCLE_POINTS; i += step) {
+        const sf::Vector2f& a = unitCircle_[i];
+        const sf::Vector2f& b = unitCircle_[(i + step) % CIRCLE_POINTS];
+        shapes_.append(sf::Vertex(center, color));
+        shapes_.append(sf::Vertex(sf::Vector2f(x + a.x * radius, y + a.y * radius), color));
+        shapes_.append(sf::Vertex(sf::Vector2f(x + b.x * radius, y + b.y * radius), color));
+    }
+}
 
-    window_->draw(text);
+void Renderer::appendLabel(PlayerID id, float x, float y) {
+    for (const sf::Vertex& vertex : labelFor(id)) {
+        sf::Vertex placed = vertex;
+        placed.position.x += x;
+        placed.position.y += y;
+        labels_.append(placed);
+    }
+}
+
+const std::vector<sf::Vertex>& Renderer::labelFor(PlayerID id) {
+    auto cached = labelCache_.find(id);
+    if (cached != labelCache_.end()) {
+        cached->second.lastDrawnFrame = frame_;
+        return cached->second.vertices;
+    }
+
+    // Lay the digits out once, as sf::Text would, then center them on the origin
+    CachedLabel& entry = labelCache_[id];
+    entry.lastDrawnFrame = frame_;
+    std::vector<sf::Vertex>& label = entry.vertices;
+    std::string digits = std::to_string(id);
+    float penX = 0.0f;
+    float minX = 0.0f, maxX = 0.0f, minY = 0.0f, maxY = 0.0f;
+    for (size_t c = 0; c < digits.size(); ++c) {
+        const sf::Glyph& glyph = font_.getGlyph(static_cast<uint32_t>(digits[c]), LABEL_SIZE, false);
+        sf::Vertex corners[6];
+        glyphQuad(glyph, penX, 0.0f, sf::Color::Black, corners);
+        label.insert(label.end(), corners, corners + 6);
+
+        float left = corners[0].position.x;
+        float top = corners[0].position.y;
+        float right = corners[5].position.x;
+        float bottom = corners[5].position.y;
+
+        minX = c == 0 ? left : std::min(minX, left);
+        minY = c == 0 ? top : std::min(minY, top);
+        maxX = std::max(maxX, right);
+        maxY = c == 0 ? bottom : std::max(maxY, bottom);
+        penX += glyph.advance;
+    }
+
+    float centerX = (minX + maxX) / 2.0f;
+    float centerY = (minY + maxY) / 2.0f;
+    for (sf::Vertex& vertex : label) {
+        vertex.position.x -= centerX;
+        vertex.position.y -= centerY;
+    }
+    return label;
 }
 
 } // namespace CoinCollector
\ No newline at end of file
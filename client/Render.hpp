@@ -6,7 +6,11 @@
 #define KRAFTON_RENDER_HPP
 
 #pragma once
+#include <array>
+#include <cstdint>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 #include <SFML/Graphics.hpp>
 #include <SFML/Graphics/Color.hpp>
 #include <SFML/Graphics/Font.hpp>
@@ -18,6 +22,16 @@
 
 namespace CoinCollector {
 
+    /**
+     * Draws the scene in a few batched calls.
+     *
+     * drawPlayer/drawCoin only append triangles to vertex arrays that keep
+     * their capacity between frames; display() submits them as one draw for
+     * all circles and one for all ID labels (textured from the font's glyph
+     * page), then the HUD. Label geometry is laid out once per player ID and
+     * reused while that player stays in view. The HUD is built from the same glyph quads into an array that
+     * keeps its capacity, so a changing tick never reaches the heap.
+     */
     class Renderer{
     public:
         Renderer();
@@ -27,6 +41,7 @@ namespace CoinCollector {
         bool pollEvent(sf::Event& event);
         void close();
 
+        // clear() starts a frame; display() submits everything queued since
         void clear();
         void display();
 
@@ -34,12 +49,44 @@ namespace CoinCollector {
 
         void drawPlayer(const PlayerState& player, const sf::Color& color, bool isLocal);
         void drawCoin(const CoinState& coin);
-        void drawHUD(const PlayerState& localPlayer, uint32_t tick);
+        // Allocation counts are the previous frame's, split at render()
+        void drawHUD(const PlayerState& localPlayer, uint32_t tick,
+                     uint64_t updateAllocations, uint64_t renderAllocations);
 
     private:
+        static constexpr size_t CIRCLE_POINTS = 30;
+        static constexpr unsigned int LABEL_SIZE = 14;
+        static constexpr unsigned int HUD_SIZE = 16;
+        static constexpr float HUD_OUTLINE = 1.0f;
+        static constexpr size_t HUD_TEXT_SIZE = 160;
+        // Labels not drawn for this many frames (~5 s) are dropped from the cache
+        static constexpr uint64_t LABEL_EXPIRY_FRAMES = 300;
+
+        // Triangle fan around center; step > 1 skips points for small circles
+        void appendCircle(float x, float y, float radius, const sf::Color& color, size_t step);
+        void appendLabel(PlayerID id, float x, float y);
+        const std::vector<sf::Vertex>& labelFor(PlayerID id);
+        // Outline pass, then fill pass, as sf::Text draws them
+        void layoutHUD(const char* text);
+
         std::unique_ptr<sf::RenderWindow> window_;
         sf::Font font_;
         bool fontLoaded_;
+
+        std::array<sf::Vector2f, CIRCLE_POINTS> unitCircle_;
+        sf::VertexArray shapes_;
+        sf::VertexArray labels_;
+        // Label triangles around the origin, keyed by player ID
+        struct CachedLabel {
+            std::vector<sf::Vertex> vertices;
+            uint64_t lastDrawnFrame = 0;
+        };
+        std::unordered_map<PlayerID, CachedLabel> labelCache_;
+        uint64_t frame_ = 0;
+
+        sf::VertexArray hud_;
+        std::array<char, HUD_TEXT_SIZE> hudText_{};
+        bool hudVisible_ = false;
     };
 
 } // namespace CoinCollector
@@ -0,0 +1,192 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#ifndef KRAFTON_ALLOCATORS_HPP
+#define KRAFTON_ALLOCATORS_HPP
+#pragma once
+
+#include "Shared.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace CoinCollector {
+
+/**
+ * Bump allocator for temporaries that live no longer than one frame
+ *
+ * allocate() moves a cursor through one block; reset() rewinds it and
+ * frees everything at once. A frame that outgrows the block spills into
+ * extra heap blocks, and the next reset() folds them into one larger
+ * block, so a steady workload stops touching the heap after its first
+ * frames. Not thread-safe: one arena per thread or per room.
+ */
+class FrameArena {
+public:
+    explicit FrameArena(size_t capacity = FRAME_ARENA_BYTES)
+        : block_(new uint8_t[capacity]), capacity_(capacity) {}
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* allocate(size_t size, size_t align) {
+        uintptr_t base = reinterpret_cast<uintptr_t>(block_.get());
+        uintptr_t start = (base + used_ + align - 1) & ~static_cast<uintptr_t>(align - 1);
+        if (start + size <= base + capacity_) {
+            used_ = start + size - base;
+            return reinterpret_cast<void*>(start);
+        }
+
+        // Out of room this frame; remembered so reset() can grow the block
+        spilled_.emplace_back(new uint8_t[size + align]);
+        spilledBytes_ += size + align;
+        uintptr_t spill = reinterpret_cast<uintptr_t>(spilled_.back().get());
+        return reinterpret_cast<void*>((spill + align - 1) & ~static_cast<uintptr_t>(align - 1));
+    }
+
+    // Invalidates everything allocated since the last reset
+    void reset() {
+        if (!spilled_.empty()) {
+            capacity_ += spilledBytes_;
+            block_.reset(new uint8_t[capacity_]);
+            spilled_.clear();
+            spilledBytes_ = 0;
+        }
+        used_ = 0;
+    }
+
+    size_t getUsed() const { return used_ + spilledBytes_; }
+    size_t getCapacity() const { return capacity_; }
+
+private:
+    std::unique_ptr<uint8_t[]> block_;
+    size_t capacity_;
+    size_t used_ = 0;
+    std::vector<std::unique_ptr<uint8_t[]>> spilled_;
+    size_t spilledBytes_ = 0;
+};
+
+/**
+ * Standard allocator over a FrameArena, for containers that die with the
+ * frame; deallocation is a no-op
+ */
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(FrameArena& arena) noexcept : arena_(&arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.arena_) {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(arena_->allocate(count * sizeof(T), alignof(T)));
+    }
+    void deallocate(T*, size_t) noexcept {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena_ == other.arena_; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena_ != other.arena_; }
+
+private:
+    template <typename U> friend class ArenaAllocator;
+    FrameArena* arena_;
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+/**
+ * Recycles packet buffers in power-of-two size classes (64 B to 64 KiB)
+ *
+ * Released blocks go on a per-class free list and come back out of the
+ * next acquire() of that class, so once the number of buffers in flight
+ * stops growing, packets no longer allocate. Thread-safe: rooms fill
+ * buffers on pool threads and the network thread releases them.
+ */
+class BufferPool {
+public:
+    static BufferPool& instance() {
+        // Never destroyed: buffers in other statics may be released during exit
+        static BufferPool* pool = new BufferPool();
+        return *pool;
+    }
+
+    /**
+     * A block of at least size bytes; capacity receives its real size,
+     * which must be passed back to release()
+     */
+    uint8_t* acquire(size_t size, size_t& capacity) {
+        size_t index = classOf(size);
+        if (index == CLASS_COUNT) {
+            capacity = size; // beyond the largest class: plain heap block
+            heapBlocks_.fetch_add(1, std::memory_order_relaxed);
+            return new uint8_t[size];
+        }
+
+        capacity = MIN_CLASS_BYTES << index;
+        FreeList& list = classes_[index];
+        {
+            std::lock_guard<std::mutex> lock(list.mutex);
+            if (FreeNode* node = list.head) {
+                list.head = node->next;
+                return reinterpret_cast<uint8_t*>(node);
+            }
+        }
+        heapBlocks_.fetch_add(1, std::memory_order_relaxed);
+        return new uint8_t[capacity];
+    }
+
+    void release(uint8_t* block, size_t capacity) {
+        if (!block) return;
+        size_t index = classOf(capacity);
+        if (index == CLASS_COUNT || (MIN_CLASS_BYTES << index) != capacity) {
+            delete[] block;
+            return;
+        }
+
+        FreeList& list = classes_[index];
+        FreeNode* node = reinterpret_cast<FreeNode*>(block);
+        std::lock_guard<std::mutex> lock(list.mutex);
+        node->next = list.head;
+        list.head = node;
+    }
+
+    // Blocks taken from the heap so far; flat once the pool has warmed up
+    uint64_t getHeapBlocks() const { return heapBlocks_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t MIN_CLASS_BYTES = 64;
+    static constexpr size_t CLASS_COUNT = 11; // up to 64 KiB
+
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    struct FreeList {
+        std::mutex mutex;
+        FreeNode* head = nullptr;
+    };
+
+    BufferPool() = default;
+
+    static size_t classOf(size_t size) {
+        size_t index = 0;
+        while (index < CLASS_COUNT && (MIN_CLASS_BYTES << index) < size) {
+            ++index;
+        }
+        return index;
+    }
+
+    std::array<FreeList, CLASS_COUNT> classes_;
+    std::atomic<uint64_t> heapBlocks_{0};
+};
+
+} // namespace CoinCollector
+#endif //KRAFTON_ALLOCATORS_HPP
@@ -0,0 +1,83 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#ifndef KRAFTON_CONNECTION_HPP
+#define KRAFTON_CONNECTION_HPP
+#pragma once
+
+#include "Shared.hpp"
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+
+namespace CoinCollector {
+
+/**
+ * Connection - one end of a byte stream between a client and the server.
+ *
+ * ServerNetwork and ClientNetwork only talk to this interface, so a
+ * player can sit behind a TCP socket or a shared-memory ring pair
+ * (ShmTransport.hpp) without the protocol code knowing.
+ */
+class Connection {
+public:
+    virtual ~Connection() = default;
+
+    /**
+     * Non-blocking read: returns the byte count, 0 when nothing is
+     * pending, or -1 once the peer closed or the connection failed
+     */
+    virtual int receive(uint8_t* buffer, size_t size) = 0;
+
+    /**
+     * Non-blocking write of a whole packet; false if it was not sent
+     */
+    virtual bool send(const uint8_t* data, size_t size) = 0;
+
+    virtual void close() = 0;
+};
+
+/**
+ * Connection over a connected, non-blocking TCP socket
+ */
+class SocketConnection : public Connection {
+public:
+    explicit SocketConnection(SocketType socket) : socket_(socket) {}
+    ~SocketConnection() override { close(); }
+
+    SocketConnection(const SocketConnection&) = delete;
+    SocketConnection& operator=(const SocketConnection&) = delete;
+
+    int receive(uint8_t* buffer, size_t size) override {
+        int received = recv(socket_, reinterpret_cast<char*>(buffer), static_cast<int>(size), 0);
+        if (received > 0) return received;
+        if (received < 0 && (errno == EWOULDBLOCK || errno == EAGAIN)) return 0;
+        return -1;
+    }
+
+    bool send(const uint8_t* data, size_t size) override {
+#ifdef MSG_NOSIGNAL
+        const int flags = MSG_NOSIGNAL; // a vanished client must not kill the process
+#else
+        const int flags = 0;
+#endif
+        return ::send(socket_, reinterpret_cast<const char*>(data), static_cast<int>(size), flags) ==
+               static_cast<int>(size);
+    }
+
+    void close() override {
+        if (socket_ != INVALID_SOCKET_VALUE) {
+            ::closesocket(socket_);
+            socket_ = INVALID_SOCKET_VALUE;
+        }
+    }
+
+    SocketType getSocket() const { return socket_; }
+
+private:
+    SocketType socket_;
+};
+
+} // namespace CoinCollector
+#endif //KRAFTON_CONNECTION_HPP
@@ -0,0 +1,60 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#ifndef KRAFTON_FIXEDMATH_HPP
+#define KRAFTON_FIXEDMATH_HPP
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+
+namespace CoinCollector {
+
+/**
+ * Fixed-point helpers for the deterministic simulation core
+ *
+ * Values are Q.12 integers (1/4096 px). Every world coordinate fits in
+ * 22 significant bits, so the conversion back to float is exact and a
+ * state that round-trips through PlayerState or the wire is unchanged.
+ * Only integer arithmetic is used, so results do not depend on compiler,
+ * optimization flags (-ffast-math, FMA contraction) or CPU.
+ */
+namespace Fixed {
+
+using Scalar = int64_t;
+
+constexpr int FRAC_BITS = 12;
+constexpr Scalar ONE = Scalar(1) << FRAC_BITS;
+
+// round(ONE / sqrt(2)), used to normalize diagonal movement
+constexpr Scalar INV_SQRT2 = 2896;
+
+// Quantize a float to the fixed grid (scaling by ONE is exact)
+inline Scalar fromFloat(float value) {
+    return static_cast<Scalar>(std::llround(value * static_cast<float>(ONE)));
+}
+
+inline float toFloat(Scalar value) {
+    return static_cast<float>(value) / static_cast<float>(ONE);
+}
+
+// a * b for two Q.12 values, rounded to nearest
+inline Scalar mul(Scalar a, Scalar b) {
+    return (a * b + (ONE / 2)) >> FRAC_BITS;
+}
+
+/**
+ * Distance covered in dt at speedPerSecond, in fixed units.
+ * dt is taken at 24 fractional bits so FIXED_DT is represented closely.
+ */
+inline Scalar displacement(float speedPerSecond, float dt) {
+    constexpr int DT_BITS = 24;
+    Scalar dtQ = static_cast<Scalar>(std::llround(dt * static_cast<float>(Scalar(1) << DT_BITS)));
+    Scalar speedQ = fromFloat(speedPerSecond);
+    return (speedQ * dtQ + (Scalar(1) << (DT_BITS - 1))) >> DT_BITS;
+}
+
+} // namespace Fixed
+} // namespace CoinCollector
+#endif //KRAFTON_FIXEDMATH_HPP
@@ -7,8 +7,15 @@
 #pragma once
 
 #include "Shared.hpp"
+#include "FixedMath.hpp"
+#include "Random.hpp"
+#include <algorithm>
 #include <cmath>
-#include <random>
+
+// Fixed-point movement and collision core (set by CMake option of the same name)
+#ifndef COINCOLLECTOR_FIXED_POINT_SIM
+#define COINCOLLECTOR_FIXED_POINT_SIM 1
+#endif
 
 namespace CoinCollector {
 
@@ -22,6 +29,56 @@ public:
      * This MUST be deterministic for client-side prediction to work
      */
     static void applyInput(PlayerState& player, const InputState& input, float dt) {
+#if COINCOLLECTOR_FIXED_POINT_SIM
+        applyInputFixed(player, input, dt);
+#else
+        applyInputFloat(player, input, dt);
+#endif
+    }
+
+    /**
+     * Fixed-point movement: bit-identical on every compiler, flag set and CPU
+     */
+    static void applyInputFixed(PlayerState& player, const InputState& input, float dt) {
+        Fixed::Scalar dirX = 0;
+        Fixed::Scalar dirY = 0;
+
+        if (input.up) dirY -= Fixed::ONE;
+        if (input.down) dirY += Fixed::ONE;
+        if (input.left) dirX -= Fixed::ONE;
+        if (input.right) dirX += Fixed::ONE;
+
+        // Normalize diagonal movement
+        if (dirX != 0 && dirY != 0) {
+            dirX = Fixed::mul(dirX, Fixed::INV_SQRT2);
+            dirY = Fixed::mul(dirY, Fixed::INV_SQRT2);
+        }
+
+        // Velocity is stored exactly; position moves by a fixed displacement
+        Fixed::Scalar speed = Fixed::fromFloat(MAX_PLAYER_SPEED);
+        Fixed::Scalar step = Fixed::displacement(MAX_PLAYER_SPEED, dt);
+
+        player.velocity = Vec2(Fixed::toFloat(Fixed::mul(dirX, speed)),
+                               Fixed::toFloat(Fixed::mul(dirY, speed)));
+
+        Fixed::Scalar x = Fixed::fromFloat(player.position.x) + Fixed::mul(dirX, step);
+        Fixed::Scalar y = Fixed::fromFloat(player.position.y) + Fixed::mul(dirY, step);
+
+        // Clamp to world bounds
+        const Fixed::Scalar minX = Fixed::fromFloat(PLAYER_RADIUS);
+        const Fixed::Scalar maxX = Fixed::fromFloat(WORLD_WIDTH - PLAYER_RADIUS);
+        const Fixed::Scalar minY = Fixed::fromFloat(PLAYER_RADIUS);
+        const Fixed::Scalar maxY = Fixed::fromFloat(WORLD_HEIGHT - PLAYER_RADIUS);
+        x = std::max(minX, std::min(maxX, x));
+        y = std::max(minY, std::min(maxY, y));
+
+        player.position = Vec2(Fixed::toFloat(x), Fixed::toFloat(y));
+    }
+
+    /**
+     * Floating-point movement (legacy path, COINCOLLECTOR_FIXED_POINT_SIM=0)
+     */
+    static void applyInputFloat(PlayerState& player, const InputState& input, float dt) {
         Vec2 acceleration(0.0f, 0.0f);
 
         if (input.up) acceleration.y -= 1.0f;
@@ -58,25 +115,24 @@ public:
      * Check collision between player and coin
      */
     static bool checkCollision(const Vec2& playerPos, const Vec2& coinPos) {
+#if COINCOLLECTOR_FIXED_POINT_SIM
+        Fixed::Scalar dx = Fixed::fromFloat(playerPos.x) - Fixed::fromFloat(coinPos.x);
+        Fixed::Scalar dy = Fixed::fromFloat(playerPos.y) - Fixed::fromFloat(coinPos.y);
+        Fixed::Scalar radiusSum = Fixed::fromFloat(PLAYER_RADIUS + COIN_RADIUS);
+        return dx * dx + dy * dy < radiusSum * radiusSum;
+#else
         float distSq = (playerPos - coinPos).lengthSquared();
         float radiusSum = PLAYER_RADIUS + COIN_RADIUS;
         return distSq < (radiusSum * radiusSum);
+#endif
     }
 
     /**
-     * Generate random position for coin spawn
+     * Uniform random position for coin spawn from a seeded generator
      */
-    static Vec2 randomCoinPosition() {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        static std::uniform_real_distribution<float> distX(
-            COIN_RADIUS, WORLD_WIDTH - COIN_RADIUS
-        );
-        static std::uniform_real_distribution<float> distY(
-            COIN_RADIUS, WORLD_HEIGHT - COIN_RADIUS
-        );
-
-        return Vec2(distX(gen), distY(gen));
+    static Vec2 randomCoinPosition(Pcg32& rng) {
+        return Vec2(rng.nextRange(COIN_RADIUS, WORLD_WIDTH - COIN_RADIUS),
+                    rng.nextRange(COIN_RADIUS, WORLD_HEIGHT - COIN_RADIUS));
     }
 
     /**
@@ -32,24 +32,60 @@ public:
         return header;
     }
 
-    // Serialize handshake packet (client -> server)
-    static ByteBuffer serializeHandshake(SequenceID seq) {
+    // Serialize handshake packet (client -> server); resumeToken 0 asks for a new session
+    // Payload: resume token (0 = new session) + requested room (0 = any)
+    static ByteBuffer serializeHandshake(SequenceID seq, uint64_t resumeToken, uint32_t roomId) {
         ByteBuffer buffer;
-        PacketHeader header(PacketType::Handshake, seq, 0);
+        PacketHeader header(PacketType::Handshake, seq, 8 + 4);
         serializeHeader(buffer, header);
+        buffer.writeUint64(resumeToken);
+        buffer.writeUint32(roomId);
         return buffer;
     }
 
-    // Serialize input packet
-    static ByteBuffer serializeInput(SequenceID seq, const InputState& input) {
+    static uint64_t deserializeHandshake(ByteBuffer& buffer, uint32_t& roomId) {
+        uint64_t resumeToken = buffer.readUint64(); // 0 when absent
+        roomId = buffer.readUint32();
+        return resumeToken;
+    }
+
+    // Reconnect to another server port on the same host and resume there
+    static ByteBuffer serializeRedirect(SequenceID seq, uint16_t port) {
+        ByteBuffer buffer;
+        serializeHeader(buffer, PacketHeader(PacketType::Redirect, seq, 2));
+        buffer.writeUint16(port);
+        return buffer;
+    }
+
+    static uint16_t deserializeRedirect(ByteBuffer& buffer) {
+        return buffer.readUint16();
+    }
+
+    // Liveness probe (server -> client) and its echo; header only
+    static ByteBuffer serializePing(SequenceID seq) {
+        ByteBuffer buffer;
+        serializeHeader(buffer, PacketHeader(PacketType::Ping, seq, 0));
+        return buffer;
+    }
+
+    static ByteBuffer serializePong(SequenceID seq) {
         ByteBuffer buffer;
-        PacketHeader header(PacketType::Input, seq, 4); // 4 bools = 4 bytes
+        serializeHeader(buffer, PacketHeader(PacketType::Pong, seq, 0));
+        return buffer;
+    }
+
+    // Serialize input packet; viewTick is the newest world state tick the
+    // client has applied, so the server can judge pickups as the client saw them
+    static ByteBuffer serializeInput(SequenceID seq, const InputState& input, uint32_t viewTick) {
+        ByteBuffer buffer;
+        PacketHeader header(PacketType::Input, seq, 4 + 4); // 4 bools + view tick
         serializeHeader(buffer, header);
 
         buffer.writeBool(input.up);
         buffer.writeBool(input.down);
         buffer.writeBool(input.left);
         buffer.writeBool(input.right);
+        buffer.writeUint32(viewTick);
 
         return buffer;
     }
@@ -63,37 +99,47 @@ public:
         input.right = buffer.readBool();
         return input;
     }
-    static ByteBuffer serializeHandshakeResponse(SequenceID seq, PlayerID playerId) {
+    static ByteBuffer serializeHandshakeResponse(SequenceID seq, PlayerID playerId,
+                                                 uint64_t sessionToken, bool resumed,
+                                                 uint32_t roomId) {
         ByteBuffer buffer;
-        // Payload: 4 bytes for PlayerID (uint32_t)
-        PacketHeader header(PacketType::Handshake, seq, sizeof(uint32_t));
+        // Payload: PlayerID + session token + resumed flag + assigned room
+        PacketHeader header(PacketType::Handshake, seq, 4 + 8 + 1 + 4);
         serializeHeader(buffer, header);
 
         buffer.writeUint32(playerId); // Write the ID into the packet
+        buffer.writeUint64(sessionToken);
+        buffer.writeBool(resumed);
+        buffer.writeUint32(roomId);
         return buffer;
     }
 
-    // NEW: Deserialize handshake response to extract the ID
-    static PlayerID deserializeHandshakeResponse(ByteBuffer& buffer) {
-        return buffer.readUint32();
+    // Deserialize handshake response to extract the ID, session and room
+    static PlayerID deserializeHandshakeResponse(ByteBuffer& buffer, uint64_t& sessionToken,
+                                                 bool& resumed, uint32_t& roomId) {
+        PlayerID playerId = buffer.readUint32();
+        sessionToken = buffer.readUint64();
+        resumed = buffer.readBool();
+        roomId = buffer.readUint32();
+        return playerId;
     }
 
-    // Serialize world state packet
+    // Serialize world state packet; any vector of players and coins (e.g. an ArenaVector)
+    template <typename Players, typename Coins>
     static ByteBuffer serializeWorldState(
         SequenceID seq,
         uint32_t tick,
-        const std::vector<PlayerState>& players,
-        const std::vector<CoinState>& coins
+        const Players& players,
+        const Coins& coins
     ) {
-        ByteBuffer buffer;
-
         // Calculate payload size
         uint16_t payloadSize = 4; // tick number
         payloadSize += 1; // player count
-        payloadSize += players.size() * (4 + 8 + 8 + 4); // id + pos + vel + score
+        payloadSize += players.size() * (4 + 8 + 8 + 4 + 4); // id + pos + vel + score + ack
         payloadSize += 1; // coin count
         payloadSize += coins.size() * (4 + 8 + 1); // id + pos + active
 
+        ByteBuffer buffer(7u + payloadSize);
         PacketHeader header(PacketType::WorldState, seq, payloadSize);
         serializeHeader(buffer, header);
 
@@ -109,6 +155,7 @@ public:
             buffer.writeFloat(player.velocity.x);
             buffer.writeFloat(player.velocity.y);
             buffer.writeUint32(player.score);
+            buffer.writeUint32(player.lastProcessedSeq);
         }
 
         // Coins
@@ -148,6 +195,7 @@ public:
             player.velocity.x = buffer.readFloat();
             player.velocity.y = buffer.readFloat();
             player.score = buffer.readUint32();
+            player.lastProcessedSeq = buffer.readUint32();
             players.push_back(player);
         }
 
@@ -7,9 +7,10 @@
 #pragma once
 
 #include "Shared.hpp"
-#include <deque>
 #include <mutex>
 #include <chrono>
+#include <utility>
+#include <vector>
 
 namespace CoinCollector {
 
@@ -17,7 +18,9 @@ namespace CoinCollector {
  * LatencyBuffer - Simulates network latency by buffering items
  * and only releasing them after a specified delay.
  *
- * Thread-safe implementation for use in network threads.
+ * Thread-safe implementation for use in network threads. Items sit in a
+ * ring that only grows when it is full, so a steady flow of packets
+ * reuses the same slots instead of allocating.
  */
 template <typename T>
 class LatencyBuffer {
@@ -29,11 +32,52 @@ public:
      * Add an item to the buffer with a release time of now + latency
      */
     void push(const T& item) {
+        push(T(item));
+    }
+
+    void push(T&& item) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (count_ == slots_.size()) {
+            grow();
+        }
+        Item& slot = slots_[(head_ + count_) % slots_.size()];
+        slot.data = std::move(item);
+        slot.releaseTime = std::chrono::steady_clock::now() + latency_;
+        count_++;
+    }
+
+    /**
+     * Add an item built in place: fill receives the slot's previous
+     * contents to overwrite, so containers inside T keep their capacity
+     */
+    template <typename Fill>
+    void emplace(Fill&& fill) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (count_ == slots_.size()) {
+            grow();
+        }
+        Item& slot = slots_[(head_ + count_) % slots_.size()];
+        fill(slot.data);
+        slot.releaseTime = std::chrono::steady_clock::now() + latency_;
+        count_++;
+    }
+
+    /**
+     * Like popReady, but the caller's old item goes into the freed slot,
+     * where the next emplace() reuses its storage. Together they
+     * double-buffer T without allocating.
+     */
+    bool swapReady(T& inOut) {
         std::lock_guard<std::mutex> lock(mutex_);
-        Item bufferedItem;
-        bufferedItem.data = item;
-        bufferedItem.releaseTime = std::chrono::steady_clock::now() + latency_;
-        buffer_.push_back(bufferedItem);
+
+        if (count_ == 0 || slots_[head_].releaseTime > std::chrono::steady_clock::now()) {
+            return false;
+        }
+
+        std::swap(inOut, slots_[head_].data);
+        head_ = (head_ + 1) % slots_.size();
+        count_--;
+        return true;
     }
 
     /**
@@ -43,14 +87,16 @@ public:
     bool popReady(T& out) {
         std::lock_guard<std::mutex> lock(mutex_);
 
-        if (buffer_.empty()) {
+        if (count_ == 0) {
             return false;
         }
 
         auto now = std::chrono::steady_clock::now();
-        if (buffer_.front().releaseTime <= now) {
-            out = std::move(buffer_.front().data);
-            buffer_.pop_front();
+        Item& front = slots_[head_];
+        if (front.releaseTime <= now) {
+            out = std::move(front.data);
+            head_ = (head_ + 1) % slots_.size();
+            count_--;
             return true;
         }
 
@@ -70,7 +116,7 @@ public:
      */
     size_t size() const {
         std::lock_guard<std::mutex> lock(mutex_);
-        return buffer_.size();
+        return count_;
     }
 
     /**
@@ -78,7 +124,11 @@ public:
      */
     void clear() {
         std::lock_guard<std::mutex> lock(mutex_);
-        buffer_.clear();
+        for (; count_ > 0; count_--) {
+            slots_[head_].data = T();
+            head_ = (head_ + 1) % slots_.size();
+        }
+        head_ = 0;
     }
 
 private:
@@ -87,7 +137,19 @@ private:
         TimePoint releaseTime;
     };
 
-    std::deque<Item> buffer_;
+    // Double the ring, unwrapping the queued items to the front
+    void grow() {
+        std::vector<Item> larger(slots_.empty() ? 16 : slots_.size() * 2);
+        for (size_t i = 0; i < count_; ++i) {
+            larger[i] = std::move(slots_[(head_ + i) % slots_.size()]);
+        }
+        slots_ = std::move(larger);
+        head_ = 0;
+    }
+
+    std::vector<Item> slots_;
+    size_t head_ = 0;
+    size_t count_ = 0;
     mutable std::mutex mutex_;
     std::chrono::milliseconds latency_;
 };
@@ -0,0 +1,445 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#ifndef KRAFTON_LOG_HPP
+#define KRAFTON_LOG_HPP
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <streambuf>
+#include <thread>
+
+#ifndef _WIN32
+    #include <pthread.h>
+#endif
+
+// Lowest level compiled in: 0 debug, 1 info, 2 warn, 3 error.
+// Calls below it vanish at compile time, arguments included.
+#ifndef COINCOLLECTOR_LOG_LEVEL
+#define COINCOLLECTOR_LOG_LEVEL 1
+#endif
+
+namespace CoinCollector {
+
+/**
+ * Asynchronous logger for everything that runs while the game does.
+ *
+ * A LOG_* call formats into a fixed thread-local buffer, checks its call
+ * site's rate limit and pushes one record into a bounded lock-free
+ * queue; a background thread does the actual console I/O. A caller never
+ * blocks and never allocates: when the queue is full the record is
+ * dropped and counted instead. The writer sleeps on a condition variable
+ * while the queue is empty, and only a push that finds it asleep pays
+ * for a notify.
+ */
+namespace Log {
+
+    enum class Level : uint8_t { Debug = 0, Info = 1, Warn = 2, Error = 3 };
+
+    constexpr size_t COMPONENT_BYTES = 24;
+    constexpr size_t MESSAGE_BYTES = 232;
+    constexpr size_t QUEUE_CAPACITY = 2048;        // records; power of two
+    constexpr uint32_t SITE_RATE_PER_SECOND = 20;  // per LOG_* call site
+
+    struct Record {
+        uint64_t timeNs;
+        uint32_t suppressed; // calls from this site dropped by the rate limit since the last record
+        uint16_t length;
+        Level level;
+        char component[COMPONENT_BYTES];
+        char message[MESSAGE_BYTES];
+    };
+
+    inline const char* toString(Level level) {
+        switch (level) {
+            case Level::Debug: return "debug";
+            case Level::Info: return "info";
+            case Level::Warn: return "warn";
+            case Level::Error: return "error";
+        }
+        return "info";
+    }
+
+    inline uint64_t nowNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    /**
+     * Bounded multi-producer queue (Vyukov): each cell's sequence number
+     * says whose turn it is, so producers only race on one CAS
+     */
+    class RecordQueue {
+    public:
+        RecordQueue() : cells_(new Cell[QUEUE_CAPACITY]) {
+            for (size_t i = 0; i < QUEUE_CAPACITY; ++i) {
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        bool push(const Record& record) {
+            size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell& cell = cells_[pos & (QUEUE_CAPACITY - 1)];
+                size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+                if (diff == 0) {
+                    if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        cell.record = record;
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false; // full
+                } else {
+                    pos = enqueuePos_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Single consumer
+        bool empty() const {
+            const Cell& cell = cells_[dequeuePos_ & (QUEUE_CAPACITY - 1)];
+            return cell.sequence.load(std::memory_order_acquire) != dequeuePos_ + 1;
+        }
+
+        bool pop(Record& out) {
+            Cell& cell = cells_[dequeuePos_ & (QUEUE_CAPACITY - 1)];
+            if (cell.sequence.load(std::memory_order_acquire) != dequeuePos_ + 1) {
+                return false;
+            }
+            out = cell.record;
+            cell.sequence.store(dequeuePos_ + QUEUE_CAPACITY, std::memory_order_release);
+            dequeuePos_++;
+            return true;
+        }
+
+    private:
+        struct Cell {
+            std::atomic<size_t> sequence;
+            Record record;
+        };
+
+        std::unique_ptr<Cell[]> cells_;
+        alignas(64) std::atomic<size_t> enqueuePos_{0};
+        alignas(64) size_t dequeuePos_ = 0;
+    };
+
+    /**
+     * Per call site limit: SITE_RATE_PER_SECOND records per wall second,
+     * the rest are counted and reported with the next one that gets through
+     */
+    class RateLimiter {
+    public:
+        explicit RateLimiter(uint32_t perSecond) : perSecond_(perSecond) {}
+
+        bool allow(uint32_t& suppressed) {
+            uint64_t second = nowNs() / 1000000000ULL;
+            uint64_t window = window_.load(std::memory_order_relaxed);
+            if (window != second && window_.compare_exchange_strong(window, second, std::memory_order_relaxed)) {
+                count_.store(0, std::memory_order_relaxed);
+            }
+            if (count_.fetch_add(1, std::memory_order_relaxed) < perSecond_) {
+                suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+                return true;
+            }
+            suppressed_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+    private:
+        uint32_t perSecond_;
+        std::atomic<uint64_t> window_{0};
+        std::atomic<uint32_t> count_{0};
+        std::atomic<uint32_t> suppressed_{0};
+    };
+
+    /**
+     * streambuf over a fixed array; output past the end is cut off
+     */
+    class MessageBuffer : public std::streambuf {
+    public:
+        MessageBuffer() { reset(); }
+
+        void reset() { setp(buffer_, buffer_ + MESSAGE_BYTES); }
+
+        const char* data() const { return buffer_; }
+        size_t size() const { return static_cast<size_t>(pptr() - pbase()); }
+
+    protected:
+        int_type overflow(int_type) override { return traits_type::eof(); }
+
+    private:
+        char buffer_[MESSAGE_BYTES];
+    };
+
+    class MessageStream : public std::ostream {
+    public:
+        MessageStream() : std::ostream(nullptr) { rdbuf(&buffer_); }
+
+        void reset() {
+            buffer_.reset();
+            clear();
+        }
+
+        const char* data() const { return buffer_.data(); }
+        size_t size() const { return buffer_.size(); }
+
+    private:
+        MessageBuffer buffer_;
+    };
+
+    inline MessageStream& threadStream() {
+        thread_local MessageStream stream;
+        stream.reset();
+        return stream;
+    }
+
+    class Logger {
+    public:
+        static Logger& instance() {
+            static Logger logger;
+            return logger;
+        }
+
+        // JSON lines ({"t":..,"level":..,"component":..,"msg":..}) instead of "[Component] message"
+        void setJson(bool json) { json_.store(json, std::memory_order_relaxed); }
+
+        void push(Level level, const char* component, const MessageStream& message, uint32_t suppressed) {
+            Record record;
+            record.timeNs = nowNs();
+            record.suppressed = suppressed;
+            record.level = level;
+            std::strncpy(record.component, component, COMPONENT_BYTES - 1);
+            record.component[COMPONENT_BYTES - 1] = '\0';
+            record.length = static_cast<uint16_t>(message.size());
+            std::memcpy(record.message, message.data(), record.length);
+
+            ensureWriter();
+            pushed_.fetch_add(1, std::memory_order_relaxed);
+            if (!queue_.push(record)) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                handled_.fetch_add(1, std::memory_order_release);
+                return;
+            }
+
+            // Pairs with the fence in parkWriter(): either the writer sees
+            // this record before it sleeps, or we see it asleep and wake it
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (writerParked_.load(std::memory_order_relaxed)) {
+                wakeWriter();
+            }
+        }
+
+        /**
+         * Wait (up to a second) until everything logged so far is written;
+         * for shutdown paths and tests, never inside a tick
+         */
+        void flush() {
+            uint64_t target = pushed_.load(std::memory_order_relaxed);
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+            while (handled_.load(std::memory_order_acquire) < target &&
+                   writerRunning_.load(std::memory_order_acquire) &&
+                   std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+
+        uint64_t getDropped() const { return dropped_.load(std::memory_order_relaxed); }
+        uint64_t getWritten() const { return written_.load(std::memory_order_relaxed); }
+
+        Logger(const Logger&) = delete;
+        Logger& operator=(const Logger&) = delete;
+
+    private:
+        Logger() : startNs_(nowNs()) {
+#ifndef _WIN32
+            // A forked child has no writer thread; it starts its own on first use
+            pthread_atfork(nullptr, nullptr, [] { Logger::instance().forgetWriter(); });
+#endif
+        }
+
+        ~Logger() {
+            if (writer_ && writer_->joinable()) {
+                stopping_.store(true, std::memory_order_release);
+                wakeWriter();
+                writer_->join();
+            }
+        }
+
+        void ensureWriter() {
+            if (writerRunning_.load(std::memory_order_acquire)) return;
+            bool expected = false;
+            if (writerStarting_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                writer_ = new std::thread(&Logger::writerLoop, this);
+                writerRunning_.store(true, std::memory_order_release);
+            }
+        }
+
+        void forgetWriter() {
+            // The parent's thread object is meaningless here; leak it. Its
+            // mutex may have been held at the fork, so start from fresh ones.
+            writer_ = nullptr;
+            writerRunning_.store(false, std::memory_order_relaxed);
+            writerStarting_.store(false, std::memory_order_relaxed);
+            writerParked_.store(false, std::memory_order_relaxed);
+            new (&wakeMutex_) std::mutex();
+            new (&wakeCondition_) std::condition_variable();
+            wakeRequested_ = false;
+        }
+
+        void wakeWriter() {
+            {
+                std::lock_guard<std::mutex> lock(wakeMutex_);
+                wakeRequested_ = true;
+            }
+            wakeCondition_.notify_one();
+        }
+
+        // Sleep until a push or shutdown wakes us, unless a record slipped in first
+        void parkWriter() {
+            writerParked_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (queue_.empty()) {
+                std::unique_lock<std::mutex> lock(wakeMutex_);
+                wakeCondition_.wait(lock, [this] {
+                    return wakeRequested_ || stopping_.load(std::memory_order_acquire);
+                });
+                wakeRequested_ = false;
+            }
+            writerParked_.store(false, std::memory_order_relaxed);
+        }
+
+        void writerLoop() {
+            Record record;
+            for (;;) {
+                bool wrote = false;
+                while (queue_.pop(record)) {
+                    write(record);
+                    written_.fetch_add(1, std::memory_order_relaxed);
+                    handled_.fetch_add(1, std::memory_order_release);
+                    wrote = true;
+                }
+                if (wrote) {
+                    std::fflush(stdout);
+                    std::fflush(stderr);
+                } else if (stopping_.load(std::memory_order_acquire)) {
+                    return;
+                } else {
+                    parkWriter();
+                }
+            }
+        }
+
+        void write(const Record& record) {
+            std::FILE* out = record.level >= Level::Warn ? stderr : stdout;
+            int length = static_cast<int>(record.length);
+
+            if (json_.load(std::memory_order_relaxed)) {
+                std::fprintf(out, "{\"t\":%.6f,\"level\":\"%s\",\"component\":\"",
+                             static_cast<double>(record.timeNs - startNs_) / 1e9, toString(record.level));
+                writeEscaped(out, record.component, std::strlen(record.component));
+                std::fputs("\",\"msg\":\"", out);
+                writeEscaped(out, record.message, record.length);
+                if (record.suppressed > 0) {
+                    std::fprintf(out, "\",\"suppressed\":%u}\n", record.suppressed);
+                } else {
+                    std::fputs("\"}\n", out);
+                }
+                return;
+            }
+
+            std::fprintf(out, "[%s] %.*s", record.component, length, record.message);
+            if (record.suppressed > 0) {
+                std::fprintf(out, " (+%u similar suppressed)", record.suppressed);
+            }
+            std::fputc('\n', out);
+        }
+
+        static void writeEscaped(std::FILE* out, const char* text, size_t length) {
+            for (size_t i = 0; i < length; ++i) {
+                char c = text[i];
+                if (c == '"' || c == '\\') {
+                    std::fputc('\\', out);
+                    std::fputc(c, out);
+                } else if (static_cast<unsigned char>(c) < 0x20) {
+                    std::fprintf(out, "\\u%04x", static_cast<unsigned>(static_cast<unsigned char>(c)));
+                } else {
+                    std::fputc(c, out);
+                }
+            }
+        }
+
+        RecordQueue queue_;
+        uint64_t startNs_;
+        std::thread* writer_ = nullptr;
+        std::atomic<bool> writerRunning_{false};
+        std::atomic<bool> writerStarting_{false};
+        std::atomic<bool> stopping_{false};
+        std::atomic<bool> writerParked_{false};
+        std::mutex wakeMutex_;
+        std::condition_variable wakeCondition_;
+        bool wakeRequested_ = false; // guarded by wakeMutex_
+        std::atomic<bool> json_{false};
+        std::atomic<uint64_t> pushed_{0};
+        std::atomic<uint64_t> handled_{0}; // written or dropped
+        std::atomic<uint64_t> written_{0};
+        std::atomic<uint64_t> dropped_{0};
+    };
+
+    inline void flush() { Logger::instance().flush(); }
+    inline void setJson(bool json) { Logger::instance().setJson(json); }
+
+} // namespace Log
+
+} // namespace CoinCollector
+
+// One limiter per call site; expr is streamed like std::cout << expr
+#define COINCOLLECTOR_LOG(level, component, expr)                                          \
+    do {                                                                                   \
+        static ::CoinCollector::Log::RateLimiter coinCollectorLogLimiter_(                 \
+            ::CoinCollector::Log::SITE_RATE_PER_SECOND);                                   \
+        uint32_t coinCollectorLogSuppressed_ = 0;                                          \
+        if (coinCollectorLogLimiter_.allow(coinCollectorLogSuppressed_)) {                 \
+            ::CoinCollector::Log::MessageStream& coinCollectorLogStream_ =                 \
+                ::CoinCollector::Log::threadStream();                                      \
+            coinCollectorLogStream_ << expr;                                               \
+            ::CoinCollector::Log::Logger::instance().push(level, component,                \
+                coinCollectorLogStream_, coinCollectorLogSuppressed_);                     \
+        }                                                                                  \
+    } while (0)
+
+#define COINCOLLECTOR_LOG_DISABLED() do {} while (0)
+
+#if COINCOLLECTOR_LOG_LEVEL <= 0
+    #define LOG_DEBUG(component, expr) COINCOLLECTOR_LOG(::CoinCollector::Log::Level::Debug, component, expr)
+#else
+    #define LOG_DEBUG(component, expr) COINCOLLECTOR_LOG_DISABLED()
+#endif
+
+#if COINCOLLECTOR_LOG_LEVEL <= 1
+    #define LOG_INFO(component, expr) COINCOLLECTOR_LOG(::CoinCollector::Log::Level::Info, component, expr)
+#else
+    #define LOG_INFO(component, expr) COINCOLLECTOR_LOG_DISABLED()
+#endif
+
+#if COINCOLLECTOR_LOG_LEVEL <= 2
+    #define LOG_WARN(component, expr) COINCOLLECTOR_LOG(::CoinCollector::Log::Level::Warn, component, expr)
+#else
+    #define LOG_WARN(component, expr) COINCOLLECTOR_LOG_DISABLED()
+#endif
+
+#define LOG_ERROR(component, expr) COINCOLLECTOR_LOG(::CoinCollector::Log::Level::Error, component, expr)
+
+#endif //KRAFTON_LOG_HPP
@@ -6,9 +6,12 @@
 #define KRAFTON_NETTYPES_HPP
 #pragma once
 
+#include "Allocators.hpp"
 #include "Shared.hpp"
 #include <vector>
 #include <cstring>
+#include <algorithm>
+#include <utility>
 
 namespace CoinCollector {
 
@@ -19,7 +22,8 @@ enum class PacketType : uint8_t {
     WorldState = 3,
     Event = 4,
     Ping = 5,
-    Pong = 6
+    Pong = 6,
+    Redirect = 7
 };
 
 // Base packet header (6 bytes)
@@ -33,28 +37,69 @@ struct PacketHeader {
         : type(t), sequenceId(seq), payloadSize(size) {}
 };
 
-// Lightweight byte buffer for serialization
+/**
+ * Lightweight byte buffer for serialization
+ *
+ * Storage comes from BufferPool and goes back to it on destruction, so
+ * building, copying and queueing packets allocates nothing once the pool
+ * holds enough blocks. Moving a buffer hands its block over.
+ */
 class ByteBuffer {
 public:
-    ByteBuffer() { data_.reserve(1024); }
-    explicit ByteBuffer(size_t capacity) { data_.reserve(capacity); }
-    explicit ByteBuffer(const std::vector<uint8_t>& buf) : data_(buf), readPos_(0) {}
+    ByteBuffer() = default; // storage is taken on the first write
+    explicit ByteBuffer(size_t capacity) { reserve(capacity); }
+    explicit ByteBuffer(const std::vector<uint8_t>& buf) : ByteBuffer(buf.data(), buf.size()) {}
+
+    // Copy of size bytes, e.g. one packet cut from a receive buffer
+    ByteBuffer(const uint8_t* bytes, size_t size) {
+        reserve(size);
+        if (size > 0) std::memcpy(data_, bytes, size);
+        size_ = size;
+    }
+
+    ByteBuffer(const ByteBuffer& other) : ByteBuffer(other.data_, other.size_) {
+        readPos_ = other.readPos_;
+    }
+
+    ByteBuffer(ByteBuffer&& other) noexcept
+        : data_(other.data_), size_(other.size_), capacity_(other.capacity_), readPos_(other.readPos_) {
+        other.data_ = nullptr;
+        other.size_ = other.capacity_ = other.readPos_ = 0;
+    }
+
+    ByteBuffer& operator=(ByteBuffer other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(readPos_, other.readPos_);
+        return *this;
+    }
+
+    ~ByteBuffer() { BufferPool::instance().release(data_, capacity_); }
 
     // Write methods
     void writeUint8(uint8_t value) {
-        data_.push_back(value);
+        reserve(size_ + 1);
+        data_[size_++] = value;
     }
 
     void writeUint16(uint16_t value) {
-        data_.push_back(static_cast<uint8_t>(value & 0xFF));
-        data_.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
+        reserve(size_ + 2);
+        data_[size_++] = static_cast<uint8_t>(value & 0xFF);
+        data_[size_++] = static_cast<uint8_t>((value >> 8) & 0xFF);
     }
 
     void writeUint32(uint32_t value) {
-        data_.push_back(static_cast<uint8_t>(value & 0xFF));
-        data_.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
-        data_.push_back(static_cast<uint8_t>((value >> 16) & 0xFF));
-        data_.push_back(static_cast<uint8_t>((value >> 24) & 0xFF));
+        reserve(size_ + 4);
+        data_[size_++] = static_cast<uint8_t>(value & 0xFF);
+        data_[size_++] = static_cast<uint8_t>((value >> 8) & 0xFF);
+        data_[size_++] = static_cast<uint8_t>((value >> 16) & 0xFF);
+        data_[size_++] = static_cast<uint8_t>((value >> 24) & 0xFF);
+    }
+
+    void writeUint64(uint64_t value) {
+        writeUint32(static_cast<uint32_t>(value & 0xFFFFFFFFu));
+        writeUint32(static_cast<uint32_t>(value >> 32));
     }
 
     void writeFloat(float value) {
@@ -69,25 +114,32 @@ public:
 
     // Read methods
     uint8_t readUint8() {
-        if (readPos_ + 1 > data_.size()) return 0;
+        if (readPos_ + 1 > size_) return 0;
         return data_[readPos_++];
     }
 
     uint16_t readUint16() {
-        if (readPos_ + 2 > data_.size()) return 0;
+        if (readPos_ + 2 > size_) return 0;
         uint16_t value = data_[readPos_] | (data_[readPos_ + 1] << 8);
         readPos_ += 2;
         return value;
     }
 
     uint32_t readUint32() {
-        if (readPos_ + 4 > data_.size()) return 0;
+        if (readPos_ + 4 > size_) return 0;
         uint32_t value = data_[readPos_] | (data_[readPos_ + 1] << 8) |
                          (data_[readPos_ + 2] << 16) | (data_[readPos_ + 3] << 24);
         readPos_ += 4;
         return value;
     }
 
+    uint64_t readUint64() {
+        if (readPos_ + 8 > size_) return 0;
+        uint64_t low = readUint32();
+        uint64_t high = readUint32();
+        return low | (high << 32);
+    }
+
     float readFloat() {
         uint32_t temp = readUint32();
         float value;
@@ -99,13 +151,26 @@ public:
         return readUint8() != 0;
     }
 
-    const uint8_t* data() const { return data_.data(); }
-    size_t size() const { return data_.size(); }
-    void clear() { data_.clear(); readPos_ = 0; }
-    size_t remaining() const { return data_.size() - readPos_; }
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    void clear() { size_ = 0; readPos_ = 0; }
+    size_t remaining() const { return size_ - readPos_; }
+
+    // Grow to hold at least capacity bytes, moving to a larger pool block
+    void reserve(size_t capacity) {
+        if (capacity <= capacity_) return;
+        size_t grown = 0;
+        uint8_t* block = BufferPool::instance().acquire(std::max(capacity, capacity_ * 2), grown);
+        if (size_ > 0) std::memcpy(block, data_, size_);
+        BufferPool::instance().release(data_, capacity_);
+        data_ = block;
+        capacity_ = grown;
+    }
 
 private:
-    std::vector<uint8_t> data_;
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
     size_t readPos_ = 0;
 };
 
@@ -0,0 +1,71 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#ifndef KRAFTON_RANDOM_HPP
+#define KRAFTON_RANDOM_HPP
+#pragma once
+
+#include <cstdint>
+
+namespace CoinCollector {
+
+/**
+ * PCG32 (XSH-RR) pseudo-random generator
+ *
+ * 16 bytes of state and a handful of integer ops per draw. The sequence
+ * depends only on the seed, so worlds seeded alike spawn alike on every
+ * platform (unlike std::uniform_real_distribution, whose output is
+ * implementation-defined).
+ */
+class Pcg32 {
+public:
+    explicit Pcg32(uint64_t seed = 0x853c49e6748fea9bULL, uint64_t stream = 0xda3e39cb94b95bdbULL) {
+        reseed(seed, stream);
+    }
+
+    void reseed(uint64_t seed, uint64_t stream = 0xda3e39cb94b95bdbULL) {
+        state_ = 0;
+        inc_ = (stream << 1) | 1;
+        next();
+        state_ += seed;
+        next();
+    }
+
+    uint32_t next() {
+        uint64_t old = state_;
+        state_ = old * 6364136223846793005ULL + inc_;
+        uint32_t xorShifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+        uint32_t rot = static_cast<uint32_t>(old >> 59);
+        return (xorShifted >> rot) | (xorShifted << ((32 - rot) & 31));
+    }
+
+    /**
+     * Uniform integer in [0, bound) without modulo bias
+     */
+    uint32_t nextBounded(uint32_t bound) {
+        uint32_t threshold = (0u - bound) % bound;
+        for (;;) {
+            uint32_t r = next();
+            if (r >= threshold) return r % bound;
+        }
+    }
+
+    /**
+     * Uniform float in [0, 1) from the top 24 bits
+     */
+    float nextFloat() {
+        return static_cast<float>(next() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    float nextRange(float lo, float hi) {
+        return lo + (hi - lo) * nextFloat();
+    }
+
+private:
+    uint64_t state_ = 0;
+    uint64_t inc_ = 1;
+};
+
+} // namespace CoinCollector
+#endif //KRAFTON_RANDOM_HPP
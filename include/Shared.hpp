@@ -6,6 +6,7 @@
 #define KRAFTON_SHARED_HPP
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <chrono>
 #include <cmath>
@@ -38,8 +39,34 @@ constexpr float MAX_PLAYER_SPEED = 300.0f; // pixels per second
 constexpr int MAX_COINS = 10;
 constexpr int TICK_RATE = 60; // Hz
 constexpr float FIXED_DT = 1.0f / TICK_RATE;
+constexpr int TICK_SPIN_US = 200; // loops busy-wait this close to a tick or frame deadline
+constexpr int CLIENT_FRAME_RATE = 144; // Hz, client render loop
 constexpr int SIMULATED_LATENCY_MS = 200;
 constexpr int INTERPOLATION_DELAY_MS = 100;
+constexpr int MIN_INTERPOLATION_DELAY_MS = 50;
+constexpr int MAX_INTERPOLATION_DELAY_MS = 250;
+constexpr int MAX_EXTRAPOLATION_MS = 200;
+constexpr int EXTRAPOLATION_BLEND_MS = 100;
+constexpr int BROADCAST_INTERVAL_TICKS = 3; // 20Hz world state at 60Hz tick
+constexpr float RECONCILIATION_THRESHOLD = 5.0f; // pixels
+constexpr float ERROR_DECAY_RATE = 10.0f; // per second, visual error offset
+constexpr float MAX_ERROR_OFFSET = 150.0f; // pixels, larger corrections snap
+constexpr int REWIND_HISTORY_MS = 1000; // server keeps this much per-tick history
+constexpr int MAX_REWIND_MS = 500; // furthest the server rewinds for a client's view
+constexpr int SESSION_GRACE_MS = 10000; // disconnected players are parked this long
+constexpr int HANDSHAKE_TIMEOUT_MS = 5000; // accepted sockets must handshake within this
+constexpr int RECONNECT_BACKOFF_MIN_MS = 250; // first client reconnect delay, doubles per attempt
+constexpr int RECONNECT_BACKOFF_MAX_MS = 4000;
+constexpr int JOIN_TIMEOUT_MS = 3000; // client gives up on a connect plus handshake after this
+constexpr int PING_INTERVAL_MS = 1000; // a silent connection is pinged this often
+constexpr int MAX_MISSED_PINGS = 3; // unanswered pings before the connection is reaped
+constexpr int IDLE_TIMEOUT_MS = 120000; // connected but no input for this long is reaped
+constexpr float SHARD_HANDOFF_MARGIN = PLAYER_RADIUS; // this far past its strip a player moves shard
+constexpr uint32_t SHARD_PLAYER_ID_BLOCK = 1u << 24; // shard i hands out ids from i * block + 1
+constexpr int SHARD_TICK_TOLERANCE = 2; // a shard this far behind another's tick jumps forward to it
+constexpr uint32_t SHM_MAX_CONNECTIONS = 64; // shared-memory client slots per server
+constexpr uint32_t SHM_RING_BYTES = 1u << 18; // per direction per slot, power of two
+constexpr size_t FRAME_ARENA_BYTES = 64 * 1024; // per-room scratch for one frame's temporaries
 
 // Type aliases
 using PlayerID = uint32_t;
@@ -111,6 +138,7 @@ struct PlayerState {
     Vec2 position;
     Vec2 velocity;
     uint32_t score = 0;
+    SequenceID lastProcessedSeq = 0; // last input the server applied (ack)
 
     PlayerState() = default;
     PlayerState(PlayerID id_, Vec2 pos) : id(id_), position(pos) {}
@@ -0,0 +1,353 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#ifndef KRAFTON_SHMTRANSPORT_HPP
+#define KRAFTON_SHMTRANSPORT_HPP
+#pragma once
+
+#include "Connection.hpp"
+#include "Shared.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+
+#ifndef _WIN32
+    #include <cerrno>
+    #include <csignal>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace CoinCollector {
+
+/**
+ * ShmRing - single-producer single-consumer byte ring in shared memory.
+ *
+ * head and tail count bytes ever written and read, so full and empty
+ * never look alike. Each lives on its own cache line; the producer only
+ * stores head and the consumer only stores tail. Packets are written
+ * whole or not at all, so a full ring drops a packet instead of
+ * splitting one.
+ */
+class ShmRing {
+public:
+    struct Indices {
+        alignas(64) std::atomic<uint64_t> head{0};
+        alignas(64) std::atomic<uint64_t> tail{0};
+    };
+
+    static size_t bytesFor(uint32_t capacity) { return sizeof(Indices) + capacity; }
+
+    ShmRing() = default;
+    ShmRing(void* memory, uint32_t capacity)
+        : indices_(static_cast<Indices*>(memory)),
+          data_(static_cast<uint8_t*>(memory) + sizeof(Indices)),
+          mask_(capacity - 1) {}
+
+    // Only while neither side is using the ring
+    void reset() {
+        new (indices_) Indices();
+    }
+
+    bool write(const uint8_t* data, size_t size) {
+        uint64_t head = indices_->head.load(std::memory_order_relaxed);
+        uint64_t tail = indices_->tail.load(std::memory_order_acquire);
+        if (size > mask_ + 1 - (head - tail)) return false;
+
+        size_t offset = static_cast<size_t>(head & mask_);
+        size_t first = std::min(size, static_cast<size_t>(mask_ + 1) - offset);
+        std::memcpy(data_ + offset, data, first);
+        std::memcpy(data_, data + first, size - first);
+        indices_->head.store(head + size, std::memory_order_release);
+        return true;
+    }
+
+    size_t read(uint8_t* out, size_t size) {
+        uint64_t tail = indices_->tail.load(std::memory_order_relaxed);
+        uint64_t head = indices_->head.load(std::memory_order_acquire);
+        size_t count = static_cast<size_t>(std::min<uint64_t>(head - tail, size));
+        if (count == 0) return 0;
+
+        size_t offset = static_cast<size_t>(tail & mask_);
+        size_t first = std::min(count, static_cast<size_t>(mask_ + 1) - offset);
+        std::memcpy(out, data_ + offset, first);
+        std::memcpy(out + first, data_, count - first);
+        indices_->tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+private:
+    Indices* indices_ = nullptr;
+    uint8_t* data_ = nullptr;
+    uint64_t mask_ = 0;
+};
+
+#ifndef _WIN32
+
+/**
+ * Shared-memory transport for clients on the same machine as the server.
+ *
+ * The server creates one POSIX shared memory segment with a fixed number
+ * of slots; a slot is a pair of rings (client to server, server to
+ * client). A client claims a free slot, which the server picks up on its
+ * next accept() poll. After that, sending and receiving are plain memory
+ * copies: no syscalls, no kernel buffers, so bots and benchmarks measure
+ * only the server's own work.
+ */
+namespace Shm {
+
+    constexpr uint32_t MAGIC = 0x43434d53; // "SMCC"
+    constexpr uint32_t VERSION = 2;
+
+    enum SlotState : uint32_t {
+        Free = 0,
+        Claiming = 1, // client is resetting the rings
+        Pending = 2,  // waiting for the server to accept
+        Open = 3
+    };
+
+    constexpr uint32_t CLIENT_CLOSED = 1;
+    constexpr uint32_t SERVER_CLOSED = 2;
+
+    struct SegmentHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t slotCount;
+        uint32_t ringBytes;
+    };
+
+    struct alignas(64) SlotControl {
+        std::atomic<uint32_t> state{Free};
+        std::atomic<uint32_t> closed{0}; // CLIENT_CLOSED | SERVER_CLOSED
+        std::atomic<int32_t> clientPid{0}; // set while claiming
+    };
+
+    // A killed client never sets CLIENT_CLOSED; its process being gone stands in for it
+    inline bool processGone(int32_t pid) {
+        return pid > 0 && ::kill(static_cast<pid_t>(pid), 0) != 0 && errno == ESRCH;
+    }
+
+    inline size_t slotBytes(uint32_t ringBytes) {
+        return sizeof(SlotControl) + 2 * ShmRing::bytesFor(ringBytes);
+    }
+
+    inline size_t segmentBytes(uint32_t slots, uint32_t ringBytes) {
+        return 64 + slots * slotBytes(ringBytes);
+    }
+
+    // Segment name a server on the given port listens on
+    inline std::string nameForPort(uint16_t port) {
+        return "/coincollector-" + std::to_string(port);
+    }
+
+    // Keeps the segment mapped while any connection still uses it
+    struct Mapping {
+        void* base = nullptr;
+        size_t size = 0;
+
+        Mapping(void* b, size_t s) : base(b), size(s) {}
+        ~Mapping() { munmap(base, size); }
+        Mapping(const Mapping&) = delete;
+        Mapping& operator=(const Mapping&) = delete;
+
+        SegmentHeader* header() const { return static_cast<SegmentHeader*>(base); }
+        uint8_t* slot(uint32_t index) const {
+            return static_cast<uint8_t*>(base) + 64 + index * slotBytes(header()->ringBytes);
+        }
+        SlotControl* control(uint32_t index) const {
+            return reinterpret_cast<SlotControl*>(slot(index));
+        }
+        ShmRing ring(uint32_t index, bool toServer) const {
+            uint32_t ringBytes = header()->ringBytes;
+            uint8_t* rings = slot(index) + sizeof(SlotControl);
+            return ShmRing(toServer ? rings : rings + ShmRing::bytesFor(ringBytes), ringBytes);
+        }
+    };
+
+    /**
+     * One side of a slot
+     */
+    class SlotConnection : public Connection {
+    public:
+        SlotConnection(std::shared_ptr<Mapping> mapping, uint32_t slot, bool serverSide)
+            : mapping_(std::move(mapping)), control_(mapping_->control(slot)),
+              rx_(mapping_->ring(slot, !serverSide)), tx_(mapping_->ring(slot, serverSide)),
+              ownBit_(serverSide ? SERVER_CLOSED : CLIENT_CLOSED),
+              peerBit_(serverSide ? CLIENT_CLOSED : SERVER_CLOSED) {}
+
+        ~SlotConnection() override { close(); }
+
+        SlotConnection(const SlotConnection&) = delete;
+        SlotConnection& operator=(const SlotConnection&) = delete;
+
+        int receive(uint8_t* buffer, size_t size) override {
+            if (closed_) return -1;
+            size_t count = rx_.read(buffer, size);
+            if (count > 0) return static_cast<int>(count);
+
+            // Drain anything written right before the peer closed
+            if (control_->closed.load(std::memory_order_acquire) & peerBit_) {
+                count = rx_.read(buffer, size);
+                return count > 0 ? static_cast<int>(count) : -1;
+            }
+            return 0;
+        }
+
+        bool send(const uint8_t* data, size_t size) override {
+            if (closed_ || (control_->closed.load(std::memory_order_acquire) & peerBit_)) return false;
+            return tx_.write(data, size);
+        }
+
+        void close() override {
+            if (closed_) return;
+            closed_ = true;
+            // The second side to close hands the slot back, and so does the
+            // server when the client died without closing
+            uint32_t before = control_->closed.fetch_or(ownBit_, std::memory_order_acq_rel);
+            bool peerClosed = (before & peerBit_) != 0 ||
+                (ownBit_ == SERVER_CLOSED && processGone(control_->clientPid.load(std::memory_order_acquire)));
+            if (peerClosed) {
+                control_->state.store(Free, std::memory_order_release);
+            }
+        }
+
+    private:
+        std::shared_ptr<Mapping> mapping_;
+        SlotControl* control_;
+        ShmRing rx_;
+        ShmRing tx_;
+        uint32_t ownBit_;
+        uint32_t peerBit_;
+        bool closed_ = false;
+    };
+
+    /**
+     * Client side: claim a free slot in the server's segment; nullptr if
+     * there is no such server or every slot is taken
+     */
+    inline std::unique_ptr<Connection> connect(const std::string& name) {
+        int fd = shm_open(name.c_str(), O_RDWR, 0);
+        if (fd < 0) return nullptr;
+
+        struct stat info{};
+        void* base = MAP_FAILED;
+        if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(SegmentHeader)) {
+            base = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        ::close(fd);
+        if (base == MAP_FAILED) return nullptr;
+
+        auto mapping = std::make_shared<Mapping>(base, static_cast<size_t>(info.st_size));
+        const SegmentHeader* header = mapping->header();
+        if (header->magic != MAGIC || header->version != VERSION ||
+            segmentBytes(header->slotCount, header->ringBytes) > mapping->size) {
+            return nullptr;
+        }
+
+        for (uint32_t slot = 0; slot < header->slotCount; ++slot) {
+            SlotControl* control = mapping->control(slot);
+            uint32_t expected = Free;
+            if (!control->state.compare_exchange_strong(expected, Claiming, std::memory_order_acq_rel)) {
+                continue;
+            }
+
+            mapping->ring(slot, true).reset();
+            mapping->ring(slot, false).reset();
+            control->closed.store(0, std::memory_order_relaxed);
+            control->clientPid.store(static_cast<int32_t>(getpid()), std::memory_order_relaxed);
+            control->state.store(Pending, std::memory_order_release);
+            return std::make_unique<SlotConnection>(std::move(mapping), slot, false);
+        }
+        return nullptr;
+    }
+
+    /**
+     * Server side: owns the segment and hands out connections for
+     * claimed slots
+     */
+    class Listener {
+    public:
+        explicit Listener(std::string name) : name_(std::move(name)) {}
+        ~Listener() { shutdown(); }
+
+        Listener(const Listener&) = delete;
+        Listener& operator=(const Listener&) = delete;
+
+        bool initialize(uint32_t slots = SHM_MAX_CONNECTIONS, uint32_t ringBytes = SHM_RING_BYTES) {
+            if (ringBytes == 0 || (ringBytes & (ringBytes - 1)) != 0) return false;
+
+            // A crashed server leaves its segment behind
+            shm_unlink(name_.c_str());
+            int fd = shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+            if (fd < 0) return false;
+
+            size_t size = segmentBytes(slots, ringBytes);
+            void* base = MAP_FAILED;
+            if (ftruncate(fd, static_cast<off_t>(size)) == 0) {
+                base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            }
+            ::close(fd);
+            if (base == MAP_FAILED) {
+                shm_unlink(name_.c_str());
+                return false;
+            }
+
+            mapping_ = std::make_shared<Mapping>(base, size);
+            SegmentHeader* header = mapping_->header();
+            header->slotCount = slots;
+            header->ringBytes = ringBytes;
+            header->version = VERSION;
+            for (uint32_t slot = 0; slot < slots; ++slot) {
+                new (mapping_->control(slot)) SlotControl();
+            }
+            // Clients check the magic last
+            std::atomic_thread_fence(std::memory_order_release);
+            header->magic = MAGIC;
+            return true;
+        }
+
+        // Next slot a client has claimed, or nullptr
+        std::unique_ptr<Connection> accept() {
+            if (!mapping_) return nullptr;
+
+            uint32_t slots = mapping_->header()->slotCount;
+            for (uint32_t i = 0; i < slots; ++i) {
+                uint32_t slot = (nextSlot_ + i) % slots;
+                uint32_t expected = Pending;
+                if (mapping_->control(slot)->state.compare_exchange_strong(expected, Open,
+                                                                            std::memory_order_acq_rel)) {
+                    nextSlot_ = slot + 1;
+                    return std::make_unique<SlotConnection>(mapping_, slot, true);
+                }
+            }
+            return nullptr;
+        }
+
+        // Unlinks the name; connections already open keep their mapping
+        void shutdown() {
+            if (mapping_) {
+                shm_unlink(name_.c_str());
+                mapping_.reset();
+            }
+        }
+
+        const std::string& getName() const { return name_; }
+
+    private:
+        std::string name_;
+        std::shared_ptr<Mapping> mapping_;
+        uint32_t nextSlot_ = 0;
+    };
+
+} // namespace Shm
+
+#endif // _WIN32
+
+} // namespace CoinCollector
+#endif //KRAFTON_SHMTRANSPORT_HPP
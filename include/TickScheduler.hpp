@@ -0,0 +1,129 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#ifndef KRAFTON_TICKSCHEDULER_HPP
+#define KRAFTON_TICKSCHEDULER_HPP
+#pragma once
+
+#include "Shared.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#ifdef __linux__
+    #include <sys/prctl.h>
+    #include <time.h>
+#endif
+
+namespace CoinCollector {
+
+/**
+ * Sleeps a loop until fixed, absolute deadlines (start + n * period).
+ *
+ * Deadlines never drift, whatever the loop body costs. The thread sleeps
+ * in the kernel until just before the deadline (clock_nanosleep with
+ * TIMER_ABSTIME on Linux) and busy-waits the last spin interval, so an
+ * idle loop wakes once per period instead of every millisecond, and the
+ * wake lands within a few microseconds of the deadline.
+ */
+class TickScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats {
+        uint64_t wakes = 0;
+        uint64_t overruns = 0;     // waits that found one or more deadlines already gone
+        uint64_t skippedTicks = 0; // deadlines passed over by those waits
+        uint64_t maxLatenessNs = 0;
+        uint64_t totalLatenessNs = 0;
+    };
+
+    explicit TickScheduler(Clock::duration period,
+                           Clock::duration spin = std::chrono::microseconds(TICK_SPIN_US))
+        : period_(period), spin_(spin), deadline_(Clock::now() + period) {}
+
+    /**
+     * Start the timeline over with the first deadline one period from now.
+     * Call on the thread that will wait: on Linux it also cuts that
+     * thread's timer slack, which otherwise delays every wake by ~50 us.
+     */
+    void reset(Clock::time_point start = Clock::now()) {
+        deadline_ = start + period_;
+#ifdef __linux__
+        prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+#endif
+    }
+
+    /**
+     * Sleep until the next deadline, then move it one period on.
+     *
+     * @return Deadlines that have passed: 1 when on time, more when the
+     *         caller overran and ticks are owed (the caller decides how
+     *         many to simulate)
+     */
+    uint32_t waitForNextTick() {
+        Clock::time_point now = Clock::now();
+        uint32_t due = 1;
+
+        if (now < deadline_) {
+            sleepUntil(deadline_);
+            now = Clock::now();
+        } else {
+            // Late already: every further period that went by is owed too
+            due += static_cast<uint32_t>((now - deadline_) / period_);
+        }
+
+        lastLatenessNs_ = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            now - (deadline_ + period_ * (due - 1))).count());
+        deadline_ += period_ * due;
+
+        stats_.wakes++;
+        if (due > 1) {
+            stats_.overruns++;
+            stats_.skippedTicks += due - 1;
+        }
+        stats_.maxLatenessNs = std::max(stats_.maxLatenessNs, lastLatenessNs_);
+        stats_.totalLatenessNs += lastLatenessNs_;
+        return due;
+    }
+
+    // How far past its deadline the last wait returned
+    uint64_t getLastLatenessNs() const { return lastLatenessNs_; }
+    Clock::time_point getNextDeadline() const { return deadline_; }
+    Clock::duration getPeriod() const { return period_; }
+    const Stats& getStats() const { return stats_; }
+
+private:
+    void sleepUntil(Clock::time_point deadline) const {
+        Clock::time_point wake = deadline - spin_;
+#ifdef __linux__
+        // steady_clock is CLOCK_MONOTONIC here, so its epoch is the kernel's
+        auto sinceEpoch = std::chrono::duration_cast<std::chrono::nanoseconds>(wake.time_since_epoch()).count();
+        if (sinceEpoch > 0) {
+            timespec target{};
+            target.tv_sec = static_cast<time_t>(sinceEpoch / 1000000000LL);
+            target.tv_nsec = static_cast<long>(sinceEpoch % 1000000000LL);
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, nullptr) == EINTR) {
+            }
+        }
+#else
+        std::this_thread::sleep_until(wake);
+#endif
+        while (Clock::now() < deadline) {
+            // Spin out the last stretch; the kernel cannot wake us this precisely
+        }
+    }
+
+    Clock::duration period_;
+    Clock::duration spin_;
+    Clock::time_point deadline_;
+    uint64_t lastLatenessNs_ = 0;
+    Stats stats_;
+};
+
+} // namespace CoinCollector
+
+#endif //KRAFTON_TICKSCHEDULER_HPP
@@ -0,0 +1,252 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#ifndef KRAFTON_TRACE_HPP
+#define KRAFTON_TRACE_HPP
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+    #include <process.h>
+#else
+    #include <unistd.h>
+#endif
+
+// Compiled in by default; the disabled cost is one relaxed load per scope.
+// Build with COINCOLLECTOR_TRACING=0 to remove every TRACE_SCOPE entirely.
+#ifndef COINCOLLECTOR_TRACING
+#define COINCOLLECTOR_TRACING 1
+#endif
+
+namespace CoinCollector {
+
+/**
+ * Opt-in event trace for individual frames and ticks.
+ *
+ * Each thread records complete (begin + duration) events into its own
+ * ring, written only by that thread, so recording takes no locks. The
+ * rings keep the most recent THREAD_CAPACITY events, which makes a
+ * capture a flight recorder: stop() writes the last few seconds before
+ * it was called as Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+ */
+namespace Trace {
+
+    struct Event {
+        const char* category; // string literals only: stored by pointer
+        const char* name;
+        uint64_t start;       // ns on the steady clock
+        uint64_t duration;    // ns
+    };
+
+    constexpr size_t THREAD_CAPACITY = 1 << 15; // 1 MB per recording thread
+
+    // The only thing a disabled Scope reads
+    inline std::atomic<bool> recording{false};
+
+    class ThreadBuffer {
+    public:
+        ThreadBuffer(uint32_t tid, std::string name)
+            : tid_(tid), name_(std::move(name)), events_(new Event[THREAD_CAPACITY]) {}
+
+        // Owner thread only
+        void push(const Event& event) {
+            uint64_t head = head_.load(std::memory_order_relaxed);
+            events_[head & (THREAD_CAPACITY - 1)] = event;
+            head_.store(head + 1, std::memory_order_release);
+        }
+
+        // Any thread; events the owner overwrote during the copy are dropped
+        void snapshot(std::vector<Event>& out) const {
+            uint64_t head = head_.load(std::memory_order_acquire);
+            uint64_t first = head > THREAD_CAPACITY ? head - THREAD_CAPACITY : 0;
+            size_t begin = out.size();
+            for (uint64_t i = first; i < head; ++i) {
+                out.push_back(events_[i & (THREAD_CAPACITY - 1)]);
+            }
+            uint64_t overwritten = head_.load(std::memory_order_acquire) - head;
+            size_t skip = static_cast<size_t>(std::min<uint64_t>(overwritten, head - first));
+            out.erase(out.begin() + static_cast<std::ptrdiff_t>(begin),
+                      out.begin() + static_cast<std::ptrdiff_t>(begin + skip));
+        }
+
+    private:
+        uint32_t tid_;
+        std::string name_;
+        std::atomic<uint64_t> head_{0};
+        std::unique_ptr<Event[]> events_;
+
+        friend class Recorder;
+    };
+
+    /**
+     * Process-wide registry of thread rings. Buffers live until exit so
+     * events from threads that already finished still reach the file.
+     */
+    class Recorder {
+    public:
+        static Recorder& instance() {
+            static Recorder recorder;
+            return recorder;
+        }
+
+        static uint64_t now() {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        void start() {
+            captureStart_.store(now(), std::memory_order_relaxed);
+            recording.store(true, std::memory_order_release);
+        }
+
+        // Stop recording and write what the rings hold; false on I/O error
+        bool stop(const std::string& path) {
+            recording.store(false, std::memory_order_release);
+            return writeChromeJson(path);
+        }
+
+        // Created on the thread's first event, so idle threads cost nothing
+        ThreadBuffer& localBuffer() {
+            ThreadBuffer*& buffer = threadBuffer();
+            if (!buffer) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                uint32_t tid = static_cast<uint32_t>(buffers_.size() + 1);
+                std::string& name = threadName();
+                buffers_.push_back(std::make_unique<ThreadBuffer>(
+                    tid, name.empty() ? "thread " + std::to_string(tid) : name));
+                buffer = buffers_.back().get();
+            }
+            return *buffer;
+        }
+
+        void setThreadName(const std::string& name) {
+            threadName() = name;
+            if (ThreadBuffer* buffer = threadBuffer()) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                buffer->name_ = name;
+            }
+        }
+
+        bool writeChromeJson(const std::string& path) {
+            std::FILE* file = std::fopen(path.c_str(), "w");
+            if (!file) return false;
+
+#ifdef _WIN32
+            int pid = _getpid();
+#else
+            int pid = static_cast<int>(getpid());
+#endif
+            uint64_t origin = captureStart_.load(std::memory_order_relaxed);
+
+            std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+            bool first = true;
+            std::vector<Event> events;
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto& buffer : buffers_) {
+                std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,"
+                             "\"args\":{\"name\":\"%s\"}}",
+                             first ? "" : ",\n", pid, buffer->tid_, escape(buffer->name_).c_str());
+                first = false;
+
+                events.clear();
+                buffer->snapshot(events);
+                for (const Event& event : events) {
+                    if (event.start < origin) continue; // before this capture
+                    std::fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%u,"
+                                 "\"ts\":%.3f,\"dur\":%.3f}",
+                                 escape(event.name).c_str(), escape(event.category).c_str(), pid, buffer->tid_,
+                                 static_cast<double>(event.start - origin) / 1000.0,
+                                 static_cast<double>(event.duration) / 1000.0);
+                }
+            }
+
+            std::fprintf(file, "\n]}\n");
+            return std::fclose(file) == 0;
+        }
+
+    private:
+        Recorder() = default;
+
+        static ThreadBuffer*& threadBuffer() {
+            thread_local ThreadBuffer* buffer = nullptr;
+            return buffer;
+        }
+
+        static std::string& threadName() {
+            thread_local std::string name;
+            return name;
+        }
+
+        static std::string escape(const std::string& text) {
+            std::string out;
+            for (char c : text) {
+                if (c == '"' || c == '\\') out.push_back('\\');
+                if (static_cast<unsigned char>(c) >= 0x20) out.push_back(c);
+            }
+            return out;
+        }
+
+        std::atomic<uint64_t> captureStart_{0};
+        std::mutex mutex_;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+    };
+
+    inline bool enabled() { return recording.load(std::memory_order_relaxed); }
+    inline void start() { Recorder::instance().start(); }
+    inline bool stop(const std::string& path) { return Recorder::instance().stop(path); }
+
+    // Label the calling thread in the trace viewer
+    inline void setThreadName(const std::string& name) { Recorder::instance().setThreadName(name); }
+
+    /**
+     * Records its own lifetime as one event; inert unless a capture is on
+     */
+    class Scope {
+    public:
+        Scope(const char* category, const char* name)
+            : category_(category), name_(name),
+              start_(enabled() ? Recorder::now() : 0) {}
+
+        ~Scope() {
+            if (start_ != 0) {
+                Recorder::instance().localBuffer().push({category_, name_, start_, Recorder::now() - start_});
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* category_;
+        const char* name_;
+        uint64_t start_;
+    };
+
+} // namespace Trace
+
+} // namespace CoinCollector
+
+#define COINCOLLECTOR_TRACE_CONCAT_INNER(a, b) a##b
+#define COINCOLLECTOR_TRACE_CONCAT(a, b) COINCOLLECTOR_TRACE_CONCAT_INNER(a, b)
+
+#if COINCOLLECTOR_TRACING
+    // Trace the rest of the enclosing block as category/name
+    #define TRACE_SCOPE(category, name) \
+        ::CoinCollector::Trace::Scope COINCOLLECTOR_TRACE_CONCAT(traceScope_, __LINE__)(category, name)
+#else
+    #define TRACE_SCOPE(category, name) ((void)0)
+#endif
+
+#endif //KRAFTON_TRACE_HPP
@@ -3,18 +3,39 @@
 //
 
 #include "GameServer.hpp"
-#include "GameCommon.hpp"
+#include <algorithm>
 #include <iostream>
-#include <thread>
 
 #include "GameProtocol.hpp"
+#include "Log.hpp"
+#include "TickScheduler.hpp"
+#include "Trace.hpp"
 
 
 namespace CoinCollector {
 
-GameServer::GameServer(uint16_t port)
-    : port_(port), currentTick_(0), lastBroadcast_(std::chrono::steady_clock::now()) {
+GameServer::GameServer(uint16_t port, uint64_t seed, size_t roomCapacity,
+                       size_t maxRooms, size_t threads)
+    : port_(port), seed_(seed), roomCapacity_(roomCapacity),
+      maxRooms_(maxRooms > 0 ? maxRooms : 1), maxRewindTicks_(MAX_REWIND_MS * TICK_RATE / 1000),
+      started_(false), pool_(threads),
+      lastBroadcast_(std::chrono::steady_clock::now()) {
     network_ = std::make_unique<ServerNetwork>(port);
+    network_->setRoomRouter([this](uint32_t requested) { return routePlayer(requested); });
+    network_->setSpawnPositionProvider([this](uint32_t roomId) {
+        Room* room = findRoom(roomId);
+        return room ? room->spawnPlayerPosition() : Vec2(WORLD_WIDTH / 2, WORLD_HEIGHT / 2);
+    });
+    network_->setConnectionCallbacks(
+        [this](ServerPlayer& player, bool resumed) {
+            if (Room* room = findRoom(player.getRoomId())) room->onPlayerConnected(player, resumed);
+        },
+        [this](const ServerPlayer& player) {
+            if (Room* room = findRoom(player.getRoomId())) room->onPlayerDisconnected(player);
+        });
+
+    // Room 1 always exists so it can be recorded and checkpointed
+    createRoom();
 }
 
 GameServer::~GameServer() {
@@ -25,141 +46,241 @@ bool GameServer::start() {
     if (!network_->initialize()) {
         return false;
     }
+    if (sharedMemory_ && !network_->enableSharedMemory()) {
+        return false;
+    }
+    if (shardLink_ && !shardLink_->initialize()) {
+        return false;
+    }
 
-    // Spawn initial coins
-    spawnCoins();
+    for (auto& room : rooms_) {
+        room->start();
+    }
+    started_ = true;
 
+    std::cout << "[Server] Rooms: up to " << maxRooms_ << ", "
+              << (roomCapacity_ > 0 ? std::to_string(roomCapacity_) : std::string("unlimited"))
+              << " players each, " << pool_.getWorkerCount() << " worker threads" << std::endl;
     return true;
 }
 
 void GameServer::run(std::atomic<bool>& running) {
-    auto lastTime = std::chrono::steady_clock::now();
-    float accumulator = 0.0f;
+    TickScheduler scheduler(std::chrono::duration_cast<TickScheduler::Clock::duration>(
+        std::chrono::duration<float>(FIXED_DT)));
+    scheduler.reset();
 
     while (running) {
-        auto currentTime = std::chrono::steady_clock::now();
-        float frameTime = std::chrono::duration<float>(currentTime - lastTime).count();
-        lastTime = currentTime;
+        uint32_t due = scheduler.waitForNextTick();
+        metrics_.wakeLateness.record(scheduler.getLastLatenessNs());
 
-        // Cap frame time to prevent spiral of death
-        if (frameTime > 0.25f) frameTime = 0.25f;
+        // Catch up at most a quarter second to prevent a spiral of death
+        if (due > MAX_CATCH_UP_TICKS) {
+            metrics_.missedTicks.fetch_add(due - MAX_CATCH_UP_TICKS, std::memory_order_relaxed);
+            due = MAX_CATCH_UP_TICKS;
+        }
 
-        accumulator += frameTime;
+        updateOverload(due);
+        gameLoop(due);
+    }
+}
 
-        // Fixed timestep update
-        while (accumulator >= FIXED_DT) {
-            gameLoop();
-            accumulator -= FIXED_DT;
-            currentTick_++;
+void GameServer::updateOverload(uint32_t due) {
+    if (due > 1) {
+        metrics_.catchUpTicks.fetch_add(due - 1, std::memory_order_relaxed);
+        onTimeFrames_ = 0;
+        if (!overloaded_) {
+            LOG_WARN("Server", "Overloaded: " << (due - 1) << " ticks behind, shedding optional work");
+            setShedding(true);
         }
+    } else if (overloaded_ && ++onTimeFrames_ >= OVERLOAD_RECOVERY_FRAMES) {
+        LOG_INFO("Server", "Caught up, resuming optional work");
+        setShedding(false);
+    }
+
+    if (overloaded_) {
+        metrics_.overloadedFrames.fetch_add(1, std::memory_order_relaxed);
+    }
+}
 
-        // Small sleep to prevent CPU spinning
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+void GameServer::setShedding(bool shedding) {
+    overloaded_ = shedding;
+    metrics_.overloaded.store(shedding ? 1 : 0, std::memory_order_relaxed);
+    for (auto& room : rooms_) {
+        room->setShedding(shedding);
     }
 }
 
 void GameServer::stop() {
-    if (network_) {
+    metricsExporter_.stop();
+    for (auto& room : rooms_) {
+        room->stop();
+    }
+    Log::flush();
+    if (network_ && network_->isRunning()) {
+        std::cout << "[Server] Ticks: " << metrics_.summary() << std::endl;
+        const ReapStats& reaped = network_->getReapStats();
+        std::cout << "[Server] Connections dropped: " << reaped.closedByPeer << " closed, "
+                  << reaped.pingTimeouts << " unresponsive, " << reaped.idleTimeouts << " idle, "
+                  << reaped.handshakeTimeouts << " no handshake; "
+                  << reaped.sessionsExpired << " sessions expired" << std::endl;
         network_->shutdown();
     }
+    if (shardLink_) {
+        shardLink_->shutdown();
+    }
 }
 
-void GameServer::gameLoop() {
-    // Update network (accept new clients, receive packets)
-    network_->update();
-
-    // Get connected players
-    players_ = network_->getPlayers();
+void GameServer::setCoinCount(int coinCount) {
+    // A world state counts its coins in one byte
+    coinCount_ = std::max(0, std::min(coinCount, 255));
+    for (auto& room : rooms_) {
+        room->setCoinCount(coinCount_);
+    }
+}
 
-    // Process client inputs
-    processInputs();
+void GameServer::setMaxRewindTicks(uint32_t ticks) {
+    maxRewindTicks_ = ticks;
+    for (auto& room : rooms_) {
+        room->setMaxRewindTicks(ticks);
+    }
+    // Rooms clamp to their history size
+    maxRewindTicks_ = rooms_.front()->getMaxRewindTicks();
+}
 
-    // Update physics
-    updatePhysics(FIXED_DT);
+bool GameServer::enableRecording(const std::string& path) {
+    return rooms_.front()->enableRecording(path);
+}
 
-    // Check collisions
-    checkCollisions();
+void GameServer::enableCheckpoints(const std::string& path) {
+    rooms_.front()->enableCheckpoints(path);
+}
 
-    // Broadcast world state (every 3 ticks = 20Hz)
-    if (currentTick_ % 3 == 0) {
-        broadcastWorldState();
+bool GameServer::enableSharding(const ShardMap& map, const std::string& socketPrefix) {
+    if (maxRooms_ != 1 || map.index >= map.count) {
+        return false;
     }
-}
 
-void GameServer::processInputs() {
-    for (auto& player : players_) {
-        InputPacket input;
-        if (player->popInput(input)) {
-            // Apply input with validation
-            GameCommon::applyInput(player->getState(), input.input, FIXED_DT);
+    // Player ids stay unique as players move between shards
+    network_->setPlayerIdBase(map.index * SHARD_PLAYER_ID_BLOCK + 1);
 
-            // Update last processed sequence
-            player->setLastProcessedSeq(input.sequenceId);
-        }
-    }
+    shardLink_ = std::make_unique<ShardLink>(map.index, map.count, socketPrefix);
+    Room& room = *rooms_.front();
+    room.enableSharding(map, *shardLink_);
+    shardLink_->setMessageHandler([&room](uint32_t fromShard, ShardMessage type, ByteBuffer& payload) {
+        room.onShardMessage(fromShard, type, payload);
+    });
+    return true;
 }
 
-void GameServer::updatePhysics(float dt) {
-    (void)dt;
-    // Physics already applied in processInputs
-    // Additional physics updates would go here
+bool GameServer::enableMetrics(uint16_t port) {
+    return metricsExporter_.start(port, [this] { return renderMetrics(); });
 }
 
-void GameServer::checkCollisions() {
-    for (auto& player : players_) {
-        PlayerState& playerState = player->getState();
+std::string GameServer::renderMetrics() const {
+    return metrics_.renderPrometheus(network_->getTrafficStats());
+}
 
-        for (auto& coin : coins_) {
-            if (!coin.active) continue;
+void GameServer::gameLoop(uint32_t steps) {
+    auto tickStart = std::chrono::steady_clock::now();
+    {
+        ScopedTimer timed(metrics_.phase(TickPhase::Tick));
+        TRACE_SCOPE("server", "tick");
+
+        // Network phase: accept, route handshakes, receive, send, reap.
+        // Once per frame; catch-up steps only drain inputs already queued.
+        {
+            ScopedTimer network(metrics_.phase(TickPhase::Network));
+            TRACE_SCOPE("server", "network");
+            network_->update();
+            if (shardLink_) {
+                shardLink_->update();
+            }
+        }
 
-            if (GameCommon::checkCollision(playerState.position, coin.position)) {
-                // Player collected coin
-                playerState.score++;
-                coin.active = false;
+        // Simulation phase: rooms share nothing but the outgoing queue
+        {
+            ScopedTimer simulation(metrics_.phase(TickPhase::Rooms));
+            TRACE_SCOPE("server", "rooms");
+            pool_.parallelFor(rooms_.size(), [this, steps](size_t i) {
+                for (uint32_t step = 1; step <= steps; ++step) {
+                    rooms_[i]->tick(step == steps);
+                }
+            });
+        }
 
-                // Respawn coin at random position
-                coin.position = GameCommon::randomCoinPosition();
-                coin.active = true;
+        if (shardLink_) {
+            ScopedTimer shards(metrics_.phase(TickPhase::Shards));
+            TRACE_SCOPE("server", "shards");
+            rooms_.front()->exchangeWithShards();
+        }
 
-                std::cout << "[Server] Player " << playerState.id
-                          << " collected coin. Score: " << playerState.score << std::endl;
-            }
+        // Snapshots are serialized by now, so the frame's temporaries are dead
+        for (auto& room : rooms_) {
+            room->resetArena();
         }
     }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - tickStart).count();
+    metrics_.lastTickNanos.store(static_cast<uint64_t>(elapsed), std::memory_order_relaxed);
+    metrics_.ticks.fetch_add(steps, std::memory_order_relaxed);
+    if (elapsed > static_cast<int64_t>(FIXED_DT * 1e9)) {
+        metrics_.overBudgetTicks.fetch_add(1, std::memory_order_relaxed);
+    }
+    sampleGauges();
 }
 
-void GameServer::broadcastWorldState() {
-    // Build player states
-    std::vector<PlayerState> playerStates;
-    for (const auto& player : players_) {
-        playerStates.push_back(player->getState());
+void GameServer::sampleGauges() {
+    size_t players = 0;
+    for (const auto& room : rooms_) {
+        players += room->getPlayerCount();
     }
+    metrics_.rooms.store(rooms_.size(), std::memory_order_relaxed);
+    metrics_.players.store(players, std::memory_order_relaxed);
+    metrics_.parkedSessions.store(network_->getParkedCount(), std::memory_order_relaxed);
+    metrics_.pendingConnections.store(network_->getPendingCount(), std::memory_order_relaxed);
+    metrics_.outgoingQueueDepth.store(network_->getOutgoingQueueDepth(), std::memory_order_relaxed);
+}
 
-    // Serialize world state
-    ByteBuffer buffer = GameProtocol::serializeWorldState(
-        currentTick_,
-        currentTick_,
-        playerStates,
-        coins_
-    );
+Room* GameServer::findRoom(uint32_t roomId) {
+    if (roomId == 0 || roomId > rooms_.size()) return nullptr;
+    return rooms_[roomId - 1].get();
+}
 
-    // Broadcast to all clients through latency buffer
-    network_->broadcast(buffer);
+Room& GameServer::createRoom() {
+    uint32_t id = static_cast<uint32_t>(rooms_.size() + 1);
+    auto room = std::make_unique<Room>(id, seed_ + (id - 1) * ROOM_SEED_STRIDE, *network_);
+    room->setMaxRewindTicks(maxRewindTicks_);
+    room->setCoinCount(coinCount_);
+    room->setMetrics(&metrics_);
+    room->setShedding(overloaded_);
+    if (started_) {
+        room->start();
+        LOG_INFO("Server", "Opened room " << id);
+    }
+    rooms_.push_back(std::move(room));
+    return *rooms_.back();
 }
 
-void GameServer::spawnCoins() {
-    coins_.clear();
-    coins_.reserve(MAX_COINS);
+bool GameServer::hasSpace(const Room& room) const {
+    return roomCapacity_ == 0 || room.getPlayerCount() < roomCapacity_;
+}
 
-    for (int i = 0; i < MAX_COINS; ++i) {
-        CoinState coin;
-        coin.id = i;
-        coin.position = GameCommon::randomCoinPosition();
-        coin.active = true;
-        coins_.push_back(coin);
+uint32_t GameServer::routePlayer(uint32_t requestedRoom) {
+    // The room the client asked for, if it is open and not full
+    Room* requested = findRoom(requestedRoom);
+    if (requested && hasSpace(*requested)) {
+        return requested->getId();
     }
 
-    std::cout << "[Server] Spawned " << MAX_COINS << " coins" << std::endl;
+    // Otherwise fill existing rooms before opening a new one
+    for (auto& room : rooms_) {
+        if (hasSpace(*room)) return room->getId();
+    }
+    if (rooms_.size() < maxRooms_) {
+        return createRoom().getId();
+    }
+    return 0;
 }
 
-} // namespace CoinCollector
\ No newline at end of file
+} // namespace CoinCollector
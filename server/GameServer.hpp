@@ -13,39 +13,119 @@
 #include <vector>
 #include <atomic>
 
+#include <string>
+
+#include "MetricsExporter.hpp"
+#include "Room.hpp"
+#include "ServerMetrics.hpp"
 #include "ServerNetwork.hpp"
 #include "ServerPlayer.hpp"
+#include "ShardLink.hpp"
+#include "ThreadPool.hpp"
 
 namespace CoinCollector {
     class ServerNetwork;
     class ServerPlayer;
 
+    /**
+     * Room manager: one listener and I/O layer shared by every room
+     *
+     * Each tick runs in two phases. The network phase (accept, handshake
+     * routing, receive, send, reaping) runs on the server thread and is
+     * the only place rooms gain or lose players. The simulation phase
+     * then ticks all rooms in parallel on the thread pool.
+     */
     class GameServer {
     public:
-        explicit GameServer(uint16_t port);
+        // roomCapacity 0 = unlimited; threads 0 = tick rooms on the server thread
+        GameServer(uint16_t port, uint64_t seed, size_t roomCapacity = 0,
+                   size_t maxRooms = 1, size_t threads = 0);
         ~GameServer();
 
         bool start();
         void run(std::atomic<bool>& running);
         void stop();
 
+        // Lag compensation window for pickups in every room; call before enableRecording()
+        void setMaxRewindTicks(uint32_t ticks);
+        uint32_t getMaxRewindTicks() const { return maxRewindTicks_; }
+
+        // Coins per room (MAX_COINS by default, at most 255); call before start()
+        void setCoinCount(int coinCount);
+
+        // One-way delay on inputs and on outgoing packets (SIMULATED_LATENCY_MS by default)
+        void setSimulatedLatency(int latencyMs) { network_->setSimulatedLatency(latencyMs); }
+
+        // Record room 1 for GameReplay; call before start()
+        bool enableRecording(const std::string& path);
+
+        // Restore from and periodically write room 1's checkpoint; call before start()
+        void enableCheckpoints(const std::string& path);
+
+        /**
+         * Run as one shard of a world split across processes on this
+         * machine; the server's port must be map.portOf(map.index). Shards
+         * link up over Unix sockets named after socketPrefix. Single room
+         * only; call before start().
+         */
+        bool enableSharding(const ShardMap& map, const std::string& socketPrefix);
+
+        // Also accept clients on this machine over shared memory (POSIX only); call before start()
+        void enableSharedMemory() { sharedMemory_ = true; }
+
+        /**
+         * Serve tick-phase timings, traffic counters and gauges in
+         * Prometheus text format on http://127.0.0.1:<port>/metrics.
+         * Timings are always collected; this only adds the endpoint.
+         */
+        bool enableMetrics(uint16_t port);
+        const ServerMetrics& getMetrics() const { return metrics_; }
+        void resetTimings() { metrics_.resetTimings(); }
+        const TrafficStats& getTrafficStats() const { return network_->getTrafficStats(); }
+        std::string renderMetrics() const;
+
+        size_t getRoomCount() const { return rooms_.size(); }
+
     private:
-        void gameLoop();
-        void processInputs();
-        void updatePhysics(float dt);
-        void checkCollisions();
-        void broadcastWorldState();
-        void spawnCoins();
+        // One real frame: a single network pass, then `steps` fixed ticks per room
+        void gameLoop(uint32_t steps);
+        void updateOverload(uint32_t due);
+        void setShedding(bool shedding);
+        void sampleGauges();
+        Room* findRoom(uint32_t roomId);
+        Room& createRoom();
+        uint32_t routePlayer(uint32_t requestedRoom);
+        bool hasSpace(const Room& room) const;
+
+        // Ticks owed after a stall that are still simulated (0.25 s); the rest are dropped
+        static constexpr uint32_t MAX_CATCH_UP_TICKS = TICK_RATE / 4;
+        // On-time frames in a row before optional work resumes (1 s)
+        static constexpr uint32_t OVERLOAD_RECOVERY_FRAMES = TICK_RATE;
+
+        // Room seeds are spread so rooms never share a coin sequence
+        static constexpr uint64_t ROOM_SEED_STRIDE = 0x9e3779b97f4a7c15ULL;
 
         uint16_t port_;
-        uint32_t currentTick_;
+        uint64_t seed_;
+        size_t roomCapacity_;
+        size_t maxRooms_;
+        uint32_t maxRewindTicks_;
+        int coinCount_ = MAX_COINS;
+        bool started_;
+        bool sharedMemory_ = false;
+        bool overloaded_ = false;
+        uint32_t onTimeFrames_ = 0;
+        ServerMetrics metrics_; // outlives the rooms that point at it
+        MetricsExporter metricsExporter_;
         std::unique_ptr<ServerNetwork> network_;
-        std::vector<ServerPlayer*> players_;
-        std::vector<CoinState> coins_;
+        std::vector<std::unique_ptr<Room>> rooms_; // index = id - 1
+        ThreadPool pool_;
+        std::unique_ptr<ShardLink> shardLink_;
+
         TimePoint lastBroadcast_;
     };
 
 } // namespace CoinCollector
 
 
-#endif //KRAFTON_GAMESERVER_HPP
\ No newline at end of file
+#endif //KRAFTON_GAMESERVER_HPP
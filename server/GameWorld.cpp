@@ -0,0 +1,206 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "GameWorld.hpp"
+#include "GameCommon.hpp"
+#include "Log.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace CoinCollector {
+
+namespace {
+    void hashBytes(uint64_t& hash, const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3ULL;
+        }
+    }
+
+    void hashFloat(uint64_t& hash, float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        hashBytes(hash, &bits, sizeof(bits));
+    }
+}
+
+GameWorld::GameWorld(uint64_t seed) : spawner_(seed) {}
+
+void GameWorld::setRegion(float minX, float maxX, int coinCount, uint32_t firstCoinId) {
+    spawner_.setBounds(minX, maxX);
+    coinCount_ = coinCount;
+    firstCoinId_ = firstCoinId;
+}
+
+void GameWorld::spawnCoins(const std::vector<ServerPlayer*>& players) {
+    coins_.clear();
+    coins_.reserve(coinCount_);
+
+    for (int i = 0; i < coinCount_; ++i) {
+        CoinState coin;
+        coin.id = firstCoinId_ + i;
+        coin.position = spawner_.coinPosition(players, coins_);
+        coin.active = true;
+        coins_.push_back(coin);
+    }
+    coinGenerations_.assign(coins_.size(), 0);
+    history_.clear();
+    claims_.clear();
+
+    if (logPickups_) {
+        LOG_INFO("Server", "Spawned " << coinCount_ << " coins (seed " << spawner_.getSeed() << ")");
+    }
+}
+
+void GameWorld::restoreCoins(const std::vector<CoinState>& coins) {
+    coins_ = coins;
+    coinGenerations_.assign(coins_.size(), 0);
+    history_.clear();
+    claims_.clear();
+}
+
+Vec2 GameWorld::spawnPlayerPosition(const std::vector<ServerPlayer*>& players) {
+    return spawner_.playerPosition(players, coins_);
+}
+
+void GameWorld::applyInput(ServerPlayer& player, const InputPacket& input) {
+    // Apply input with validation
+    GameCommon::applyInput(player.getState(), input.input, FIXED_DT);
+
+    // Update last processed sequence
+    player.setLastProcessedSeq(input.sequenceId);
+    player.setViewTick(input.viewTick);
+}
+
+void GameWorld::checkCollisions(const std::vector<ServerPlayer*>& players, uint32_t tick) {
+    // Claims older than the history can no longer match a rewound coin
+    uint32_t horizon = tick > history_.getCapacity() ? tick - history_.getCapacity() : 0;
+    claims_.erase(std::remove_if(claims_.begin(), claims_.end(),
+                                 [horizon](const PickupClaim& claim) { return claim.tick < horizon; }),
+                  claims_.end());
+
+    for (auto& player : players) {
+        PlayerState& playerState = player->getState();
+
+        for (size_t i = 0; i < coins_.size(); ++i) {
+            CoinState& coin = coins_[i];
+            if (!coin.active) continue;
+
+            if (GameCommon::checkCollision(playerState.position, coin.position)) {
+                // Player collected coin
+                awardPickup(playerState, "collected");
+                claims_.push_back({playerState.id, static_cast<uint32_t>(i), coinGenerations_[i], tick,
+                                   std::min(player->getViewTick(), tick)});
+                coin.active = false;
+
+                // Respawn coin away from players and other coins
+                coin.position = spawner_.coinPosition(players, coins_);
+                coin.active = true;
+                coinGenerations_[i]++;
+            }
+        }
+
+        // Rewind the coins to what this client was looking at
+        if (history_.getMaxRewindTicks() == 0 || history_.empty()) continue;
+        uint32_t viewTick = history_.clampTick(player->getViewTick());
+        if (viewTick >= history_.getLatestTick()) continue;
+
+        const auto* seen = history_.coinsAt(viewTick);
+        if (!seen) continue;
+
+        for (size_t i = 0; i < seen->size() && i < coins_.size(); ++i) {
+            const RewindHistory::CoinSample& sample = (*seen)[i];
+            // Only coins taken since the view tick differ from the live check
+            if (!sample.active || sample.generation == coinGenerations_[i]) continue;
+            if (!GameCommon::checkCollision(playerState.position, sample.position)) continue;
+
+            // One point per coin generation. Whoever took it already holds it;
+            // it changes hands only to a player who saw the coin earlier.
+            PickupClaim* claim = findClaim(static_cast<uint32_t>(i), sample.generation);
+            if (claim) {
+                if (claim->playerId == 0 || claim->playerId == playerState.id || claim->viewTick <= viewTick) continue;
+                auto holder = std::find_if(players.begin(), players.end(),
+                    [claim](const ServerPlayer* p) { return p->getId() == claim->playerId; });
+                if (holder == players.end()) continue; // gone; its point stays
+
+                (*holder)->getState().score--;
+                if (logPickups_) {
+                    LOG_INFO("Server", "Player " << claim->playerId << " loses a coin to player " << playerState.id
+                             << ", who saw it first");
+                }
+            }
+
+            awardPickup(playerState, "collected (rewound)");
+            if (claim) {
+                claim->playerId = playerState.id;
+                claim->viewTick = viewTick;
+            } else {
+                claims_.push_back({playerState.id, static_cast<uint32_t>(i), sample.generation, tick, viewTick});
+            }
+            compensatedPickups_++;
+        }
+    }
+
+    history_.record(tick, players, coins_, coinGenerations_);
+}
+
+bool GameWorld::claimCoin(uint32_t coinId, const Vec2& seenAt, const std::vector<ServerPlayer*>& players) {
+    if (coinId < firstCoinId_ || coinId - firstCoinId_ >= coins_.size()) return false;
+
+    size_t i = coinId - firstCoinId_;
+    CoinState& coin = coins_[i];
+    // A stale claim for a coin that already moved is dropped
+    if (!coin.active || coin.position.x != seenAt.x || coin.position.y != seenAt.y) return false;
+
+    // The point went to a player on another shard; rewinds here cannot take it
+    uint32_t tick = history_.empty() ? 0 : history_.getLatestTick() + 1;
+    claims_.push_back({0, static_cast<uint32_t>(i), coinGenerations_[i], tick, tick});
+
+    coin.active = false;
+    coin.position = spawner_.coinPosition(players, coins_);
+    coin.active = true;
+    coinGenerations_[i]++;
+    return true;
+}
+
+void GameWorld::awardPickup(PlayerState& player, const char* how) {
+    player.score++;
+
+    if (logPickups_) {
+        LOG_INFO("Server", "Player " << player.id << " " << how << " coin. Score: " << player.score);
+    }
+}
+
+GameWorld::PickupClaim* GameWorld::findClaim(uint32_t coinIndex, uint32_t generation) {
+    for (auto& claim : claims_) {
+        if (claim.coinIndex == coinIndex && claim.generation == generation) {
+            return &claim;
+        }
+    }
+    return nullptr;
+}
+
+uint64_t GameWorld::stateHash(const std::vector<ServerPlayer*>& players) const {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    for (const auto* player : players) {
+        const PlayerState& state = player->getState();
+        hashBytes(hash, &state.id, sizeof(state.id));
+        hashFloat(hash, state.position.x);
+        hashFloat(hash, state.position.y);
+        hashBytes(hash, &state.score, sizeof(state.score));
+    }
+
+    for (const auto& coin : coins_) {
+        hashFloat(hash, coin.position.x);
+        hashFloat(hash, coin.position.y);
+        uint8_t active = coin.active ? 1 : 0;
+        hashBytes(hash, &active, 1);
+    }
+
+    return hash;
+}
+
+} // namespace CoinCollector
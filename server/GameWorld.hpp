@@ -0,0 +1,105 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#ifndef KRAFTON_GAMEWORLD_HPP
+#define KRAFTON_GAMEWORLD_HPP
+
+
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "RewindHistory.hpp"
+#include "ServerPlayer.hpp"
+#include "SpawnGenerator.hpp"
+#include "Shared.hpp"
+
+namespace CoinCollector {
+
+    /**
+     * Authoritative simulation state of one match: coins, spawns, input
+     * application and pickups. Holds no sockets, so the same code runs
+     * behind the live network and in headless replay.
+     */
+    class GameWorld {
+    public:
+        explicit GameWorld(uint64_t seed);
+
+        /**
+         * Own only the strip [minX, maxX) of a sharded world: spawns stay
+         * inside it and its coinCount coins are numbered from firstCoinId.
+         * Call before spawnCoins().
+         */
+        void setRegion(float minX, float maxX, int coinCount, uint32_t firstCoinId);
+
+        // Coins in play (MAX_COINS by default); call before spawnCoins()
+        void setCoinCount(int coinCount) { coinCount_ = coinCount; }
+
+        void spawnCoins(const std::vector<ServerPlayer*>& players);
+        void restoreCoins(const std::vector<CoinState>& coins);
+        Vec2 spawnPlayerPosition(const std::vector<ServerPlayer*>& players);
+
+        void applyInput(ServerPlayer& player, const InputPacket& input);
+
+        /**
+         * Pickups for this tick, then record the tick into the rewind history.
+         *
+         * Besides touching a coin now, a player also scores a coin that was
+         * collected by someone else after the player's view tick if the
+         * player now stands on it where the client still saw it (favor the
+         * client, bounded by the max rewind). Each such coin can be claimed
+         * once per player.
+         */
+        void checkCollisions(const std::vector<ServerPlayer*>& players, uint32_t tick);
+
+        /**
+         * Pickup by a player another shard owns. Granted only if the coin is
+         * still active where the claimer saw it; the coin then respawns.
+         */
+        bool claimCoin(uint32_t coinId, const Vec2& seenAt, const std::vector<ServerPlayer*>& players);
+
+        /**
+         * FNV-1a over every player and coin, used to verify replays
+         */
+        uint64_t stateHash(const std::vector<ServerPlayer*>& players) const;
+
+        const std::vector<CoinState>& getCoins() const { return coins_; }
+        uint64_t getSeed() const { return spawner_.getSeed(); }
+
+        // Console output per pickup (off for headless replay)
+        void setLogPickups(bool enabled) { logPickups_ = enabled; }
+
+        // 0 disables lag-compensated pickups
+        void setMaxRewindTicks(uint32_t ticks) { history_.setMaxRewindTicks(ticks); }
+        uint32_t getMaxRewindTicks() const { return history_.getMaxRewindTicks(); }
+        const RewindHistory& getHistory() const { return history_; }
+        uint64_t getCompensatedPickups() const { return compensatedPickups_; }
+
+    private:
+        // Who holds the point for one generation of one coin
+        struct PickupClaim {
+            PlayerID playerId; // 0: taken on another shard, never contested
+            uint32_t coinIndex;
+            uint32_t generation; // generation of the coin that was taken
+            uint32_t tick;
+            uint32_t viewTick; // what the holder was looking at when it touched the coin
+        };
+
+        void awardPickup(PlayerState& player, const char* how);
+        PickupClaim* findClaim(uint32_t coinIndex, uint32_t generation);
+
+        std::vector<CoinState> coins_;
+        std::vector<uint32_t> coinGenerations_;
+        SpawnGenerator spawner_;
+        RewindHistory history_;
+        std::vector<PickupClaim> claims_;
+        uint64_t compensatedPickups_ = 0;
+        bool logPickups_ = true;
+        int coinCount_ = MAX_COINS;
+        uint32_t firstCoinId_ = 0;
+    };
+
+} // namespace CoinCollector
+
+#endif //KRAFTON_GAMEWORLD_HPP
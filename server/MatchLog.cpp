@@ -0,0 +1,299 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "MatchLog.hpp"
+#include <chrono>
+#include <iostream>
+#include <utility>
+
+namespace CoinCollector {
+
+namespace {
+    uint8_t packButtons(const InputState& input) {
+        return static_cast<uint8_t>((input.up ? 1 : 0) | (input.down ? 2 : 0) |
+                                    (input.left ? 4 : 0) | (input.right ? 8 : 0));
+    }
+
+    InputState unpackButtons(uint8_t bits) {
+        InputState input;
+        input.up = (bits & 1) != 0;
+        input.down = (bits & 2) != 0;
+        input.left = (bits & 4) != 0;
+        input.right = (bits & 8) != 0;
+        return input;
+    }
+
+    // Payload bytes following the type + tick prefix
+    size_t payloadSize(MatchEventType type) {
+        switch (type) {
+            case MatchEventType::Connect: return 4 + 4 + 4;
+            case MatchEventType::Disconnect: return 4;
+            case MatchEventType::Input: return 4 + 4 + 1 + 4;
+            case MatchEventType::Checksum: return 8;
+            case MatchEventType::Resume: return 4 + 4 + 4 + 4;
+        }
+        return 0;
+    }
+
+    constexpr size_t HEADER_SIZE = 4 + 2 + 8 + 2 + 2;
+    constexpr size_t RECORD_PREFIX = 1 + 4;
+}
+
+void MatchLog::encodeHeader(ByteBuffer& buffer, const MatchLogHeader& header) {
+    buffer.writeUint32(MAGIC);
+    buffer.writeUint16(header.version);
+    buffer.writeUint64(header.seed);
+    buffer.writeUint16(header.tickRate);
+    buffer.writeUint16(header.maxRewindTicks);
+}
+
+void MatchLog::encodeEvent(ByteBuffer& buffer, const MatchEvent& event) {
+    buffer.writeUint8(static_cast<uint8_t>(event.type));
+    buffer.writeUint32(event.tick);
+
+    switch (event.type) {
+        case MatchEventType::Connect:
+            buffer.writeUint32(event.playerId);
+            buffer.writeFloat(event.position.x);
+            buffer.writeFloat(event.position.y);
+            break;
+        case MatchEventType::Disconnect:
+            buffer.writeUint32(event.playerId);
+            break;
+        case MatchEventType::Input:
+            buffer.writeUint32(event.playerId);
+            buffer.writeUint32(event.sequenceId);
+            buffer.writeUint8(packButtons(event.input));
+            buffer.writeUint32(event.viewTick);
+            break;
+        case MatchEventType::Checksum:
+            buffer.writeUint64(event.checksum);
+            break;
+        case MatchEventType::Resume:
+            buffer.writeUint32(event.playerId);
+            buffer.writeFloat(event.position.x);
+            buffer.writeFloat(event.position.y);
+            buffer.writeUint32(event.score);
+            break;
+    }
+}
+
+bool MatchLog::read(const std::string& path, MatchLogHeader& header,
+                    std::vector<MatchEvent>& events) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        std::cerr << "[MatchLog] Cannot open " << path << std::endl;
+        return false;
+    }
+
+    std::vector<uint8_t> bytes;
+    uint8_t chunk[64 * 1024];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        bytes.insert(bytes.end(), chunk, chunk + n);
+    }
+    std::fclose(file);
+
+    ByteBuffer buffer(bytes);
+    if (buffer.remaining() < HEADER_SIZE || buffer.readUint32() != MAGIC) {
+        std::cerr << "[MatchLog] Not a match log: " << path << std::endl;
+        return false;
+    }
+
+    header.version = buffer.readUint16();
+    header.seed = buffer.readUint64();
+    header.tickRate = buffer.readUint16();
+    header.maxRewindTicks = buffer.readUint16();
+    if (header.version != VERSION) {
+        std::cerr << "[MatchLog] Unsupported version " << header.version << std::endl;
+        return false;
+    }
+
+    events.clear();
+    while (buffer.remaining() >= RECORD_PREFIX) {
+        MatchEvent event;
+        event.type = static_cast<MatchEventType>(buffer.readUint8());
+        event.tick = buffer.readUint32();
+
+        size_t size = payloadSize(event.type);
+        if (size == 0) {
+            std::cerr << "[MatchLog] Corrupt record type, stopping" << std::endl;
+            break;
+        }
+        if (buffer.remaining() < size) {
+            break; // Truncated tail
+        }
+
+        switch (event.type) {
+            case MatchEventType::Connect:
+                event.playerId = buffer.readUint32();
+                event.position.x = buffer.readFloat();
+                event.position.y = buffer.readFloat();
+                break;
+            case MatchEventType::Disconnect:
+                event.playerId = buffer.readUint32();
+                break;
+            case MatchEventType::Input:
+                event.playerId = buffer.readUint32();
+                event.sequenceId = buffer.readUint32();
+                event.input = unpackButtons(buffer.readUint8());
+                event.viewTick = buffer.readUint32();
+                break;
+            case MatchEventType::Checksum:
+                event.checksum = buffer.readUint64();
+                break;
+            case MatchEventType::Resume:
+                event.playerId = buffer.readUint32();
+                event.position.x = buffer.readFloat();
+                event.position.y = buffer.readFloat();
+                event.score = buffer.readUint32();
+                break;
+        }
+        events.push_back(event);
+    }
+
+    return true;
+}
+
+MatchRecorder::~MatchRecorder() {
+    close();
+}
+
+bool MatchRecorder::open(const std::string& path, uint64_t seed, uint16_t maxRewindTicks) {
+    close();
+
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        std::cerr << "[MatchRecorder] Cannot open " << path << std::endl;
+        return false;
+    }
+
+    MatchLogHeader header;
+    header.version = MatchLog::VERSION;
+    header.seed = seed;
+    header.tickRate = TICK_RATE;
+    header.maxRewindTicks = maxRewindTicks;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.clear();
+        MatchLog::encodeHeader(pending_, header);
+        stopping_ = false;
+        bytesWritten_ = 0;
+    }
+
+    writer_ = std::thread(&MatchRecorder::writerLoop, this);
+    std::cout << "[MatchRecorder] Recording to " << path << std::endl;
+    return true;
+}
+
+void MatchRecorder::close() {
+    if (!file_) return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+void MatchRecorder::recordConnect(uint32_t tick, PlayerID playerId, const Vec2& spawn) {
+    MatchEvent event;
+    event.type = MatchEventType::Connect;
+    event.tick = tick;
+    event.playerId = playerId;
+    event.position = spawn;
+    append(event);
+}
+
+void MatchRecorder::recordDisconnect(uint32_t tick, PlayerID playerId) {
+    MatchEvent event;
+    event.type = MatchEventType::Disconnect;
+    event.tick = tick;
+    event.playerId = playerId;
+    append(event);
+}
+
+void MatchRecorder::recordInput(uint32_t tick, PlayerID playerId, const InputPacket& input) {
+    MatchEvent event;
+    event.type = MatchEventType::Input;
+    event.tick = tick;
+    event.playerId = playerId;
+    event.sequenceId = input.sequenceId;
+    event.input = input.input;
+    event.viewTick = input.viewTick;
+    append(event);
+}
+
+void MatchRecorder::recordChecksum(uint32_t tick, uint64_t hash) {
+    MatchEvent event;
+    event.type = MatchEventType::Checksum;
+    event.tick = tick;
+    event.checksum = hash;
+    append(event);
+}
+
+void MatchRecorder::recordResume(uint32_t tick, const PlayerState& state) {
+    MatchEvent event;
+    event.type = MatchEventType::Resume;
+    event.tick = tick;
+    event.playerId = state.id;
+    event.position = state.position;
+    event.score = state.score;
+    append(event);
+}
+
+uint64_t MatchRecorder::bytesWritten() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytesWritten_;
+}
+
+void MatchRecorder::append(const MatchEvent& event) {
+    if (!file_) return;
+
+    bool flush;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        MatchLog::encodeEvent(pending_, event);
+        flush = pending_.size() >= FLUSH_BYTES;
+    }
+    if (flush) {
+        wake_.notify_one();
+    }
+}
+
+void MatchRecorder::writerLoop() {
+    ByteBuffer writing;
+
+    for (;;) {
+        bool stopping;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait_for(lock, std::chrono::milliseconds(100), [this] {
+                return stopping_ || pending_.size() >= FLUSH_BYTES;
+            });
+            std::swap(writing, pending_);
+            stopping = stopping_;
+        }
+
+        if (writing.size() > 0) {
+            std::fwrite(writing.data(), 1, writing.size(), file_);
+            std::fflush(file_);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            bytesWritten_ += writing.size();
+        }
+        writing.clear();
+
+        if (stopping) break;
+    }
+}
+
+} // namespace CoinCollector
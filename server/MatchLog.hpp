@@ -0,0 +1,121 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#ifndef KRAFTON_MATCHLOG_HPP
+#define KRAFTON_MATCHLOG_HPP
+
+
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "NetTypes.hpp"
+#include "ServerPlayer.hpp"
+#include "Shared.hpp"
+
+namespace CoinCollector {
+
+    /**
+     * Compact binary match log
+     *
+     * Header: magic u32, version u16, seed u64, tick rate u16, max rewind ticks u16
+     * Record: type u8, tick u32, then
+     *   Connect    player u32, spawn x f32, spawn y f32
+     *   Disconnect player u32
+     *   Input      player u32, sequence u32, buttons u8 (up|down|left|right bits), view tick u32
+     *   Checksum   world state hash u64
+     *   Resume     player u32, x f32, y f32, score u32 (parked player reconnected)
+     */
+    enum class MatchEventType : uint8_t {
+        Connect = 1,
+        Disconnect = 2,
+        Input = 3,
+        Checksum = 4,
+        Resume = 5
+    };
+
+    struct MatchLogHeader {
+        uint16_t version = 0;
+        uint64_t seed = 0;
+        uint16_t tickRate = 0;
+        uint16_t maxRewindTicks = 0;
+    };
+
+    struct MatchEvent {
+        MatchEventType type = MatchEventType::Input;
+        uint32_t tick = 0;
+        PlayerID playerId = 0;
+        SequenceID sequenceId = 0;
+        InputState input;
+        uint32_t viewTick = 0;
+        Vec2 position;
+        uint64_t checksum = 0;
+        uint32_t score = 0;
+    };
+
+    class MatchLog {
+    public:
+        static constexpr uint32_t MAGIC = 0x50524343; // "CCRP"
+        static constexpr uint16_t VERSION = 3;
+
+        static void encodeHeader(ByteBuffer& buffer, const MatchLogHeader& header);
+        static void encodeEvent(ByteBuffer& buffer, const MatchEvent& event);
+
+        /**
+         * Load a whole log. A truncated final record (e.g. after a crash)
+         * is dropped; everything before it is returned.
+         */
+        static bool read(const std::string& path, MatchLogHeader& header,
+                         std::vector<MatchEvent>& events);
+    };
+
+    /**
+     * Appends match events to a log file. Recording only encodes into a
+     * memory buffer; a background thread does the file I/O, so the tick
+     * never waits on the disk.
+     */
+    class MatchRecorder {
+    public:
+        MatchRecorder() = default;
+        ~MatchRecorder();
+
+        MatchRecorder(const MatchRecorder&) = delete;
+        MatchRecorder& operator=(const MatchRecorder&) = delete;
+
+        bool open(const std::string& path, uint64_t seed, uint16_t maxRewindTicks);
+        void close();
+        bool isOpen() const { return file_ != nullptr; }
+
+        void recordConnect(uint32_t tick, PlayerID playerId, const Vec2& spawn);
+        void recordDisconnect(uint32_t tick, PlayerID playerId);
+        void recordInput(uint32_t tick, PlayerID playerId, const InputPacket& input);
+        void recordChecksum(uint32_t tick, uint64_t hash);
+        void recordResume(uint32_t tick, const PlayerState& state);
+
+        uint64_t bytesWritten() const;
+
+    private:
+        void append(const MatchEvent& event);
+        void writerLoop();
+
+        // Wake the writer early once this much is pending
+        static constexpr size_t FLUSH_BYTES = 64 * 1024;
+
+        std::FILE* file_ = nullptr;
+        std::thread writer_;
+        mutable std::mutex mutex_;
+        std::condition_variable wake_;
+        ByteBuffer pending_;
+        bool stopping_ = false;
+        uint64_t bytesWritten_ = 0;
+    };
+
+} // namespace CoinCollector
+
+#endif //KRAFTON_MATCHLOG_HPP
@@ -0,0 +1,130 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "MatchReplay.hpp"
+#include "GameWorld.hpp"
+#include "ServerPlayer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+namespace CoinCollector {
+
+ReplayResult MatchReplay::run(const MatchLogHeader& header,
+                              const std::vector<MatchEvent>& events) {
+    ReplayResult result;
+    auto startTime = std::chrono::steady_clock::now();
+
+    GameWorld world(header.seed);
+    world.setLogPickups(false);
+    world.setMaxRewindTicks(header.maxRewindTicks);
+    std::vector<std::unique_ptr<ServerPlayer>> owned;
+    std::vector<ServerPlayer*> players;
+
+    auto findPlayer = [&owned](PlayerID id) -> ServerPlayer* {
+        for (auto& player : owned) {
+            if (player->getId() == id) return player.get();
+        }
+        return nullptr;
+    };
+
+    // Same order as GameServer::start()
+    world.spawnCoins(players);
+
+    uint32_t lastTick = events.empty() ? 0 : events.back().tick;
+    size_t next = 0;
+
+    for (uint32_t tick = 0; tick <= lastTick; ++tick) {
+        // Network and input events precede collisions within a tick
+        while (next < events.size() && events[next].tick == tick &&
+               events[next].type != MatchEventType::Checksum) {
+            const MatchEvent& event = events[next++];
+
+            switch (event.type) {
+                case MatchEventType::Connect: {
+                    // Draw the spawn like the live server did to keep the RNG in step
+                    Vec2 spawn = world.spawnPlayerPosition(players);
+                    if (spawn.x != event.position.x || spawn.y != event.position.y) {
+                        result.spawnMismatches++;
+                    }
+
+                    auto player = std::make_unique<ServerPlayer>(event.playerId);
+                    player->getState().position = event.position;
+                    player->setViewTick(tick);
+                    players.push_back(player.get());
+                    owned.push_back(std::move(player));
+                    result.connects++;
+                    break;
+                }
+                case MatchEventType::Resume: {
+                    // Parked state comes back as recorded, in id order like the live server
+                    auto player = std::make_unique<ServerPlayer>(event.playerId);
+                    player->getState().position = event.position;
+                    player->getState().score = event.score;
+                    player->setViewTick(tick);
+                    auto pos = std::upper_bound(players.begin(), players.end(), event.playerId,
+                        [](PlayerID id, const ServerPlayer* other) { return id < other->getId(); });
+                    players.insert(pos, player.get());
+                    owned.push_back(std::move(player));
+                    result.resumes++;
+                    break;
+                }
+                case MatchEventType::Disconnect: {
+                    auto it = std::find_if(owned.begin(), owned.end(),
+                        [&event](const std::unique_ptr<ServerPlayer>& p) {
+                            return p->getId() == event.playerId;
+                        });
+                    if (it != owned.end()) {
+                        players.erase(std::find(players.begin(), players.end(), it->get()));
+                        owned.erase(it);
+                    }
+                    break;
+                }
+                case MatchEventType::Input: {
+                    if (ServerPlayer* player = findPlayer(event.playerId)) {
+                        InputPacket input;
+                        input.sequenceId = event.sequenceId;
+                        input.input = event.input;
+                        input.viewTick = event.viewTick;
+                        world.applyInput(*player, input);
+                        result.inputs++;
+                    }
+                    break;
+                }
+                case MatchEventType::Checksum:
+                    break;
+            }
+        }
+
+        world.checkCollisions(players, tick);
+
+        while (next < events.size() && events[next].tick == tick) {
+            const MatchEvent& event = events[next++];
+            if (event.type != MatchEventType::Checksum) continue;
+
+            if (world.stateHash(players) == event.checksum) {
+                result.checksumsVerified++;
+            } else {
+                if (result.checksumMismatches == 0) {
+                    std::cerr << "[MatchReplay] Diverged at tick " << tick << std::endl;
+                }
+                result.checksumMismatches++;
+            }
+        }
+
+        result.ticks = tick + 1;
+    }
+
+    result.finalHash = world.stateHash(players);
+    for (const auto* player : players) {
+        result.finalPlayers.push_back(player->getState());
+    }
+    result.seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
+
+} // namespace CoinCollector
@@ -0,0 +1,47 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#ifndef KRAFTON_MATCHREPLAY_HPP
+#define KRAFTON_MATCHREPLAY_HPP
+
+
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "MatchLog.hpp"
+#include "Shared.hpp"
+
+namespace CoinCollector {
+
+    struct ReplayResult {
+        uint32_t ticks = 0;
+        size_t inputs = 0;
+        size_t connects = 0;
+        size_t resumes = 0;
+        size_t checksumsVerified = 0;
+        size_t checksumMismatches = 0;
+        size_t spawnMismatches = 0;
+        uint64_t finalHash = 0;
+        double seconds = 0.0;           // wall time spent simulating
+        std::vector<PlayerState> finalPlayers;
+    };
+
+    /**
+     * Headless re-simulation of a recorded match
+     *
+     * Rebuilds the world from the log seed and feeds recorded connects,
+     * disconnects and inputs at their ticks as fast as possible. Recorded
+     * checksums and spawn positions are compared along the way, so any
+     * divergence from the live server is reported.
+     */
+    class MatchReplay {
+    public:
+        static ReplayResult run(const MatchLogHeader& header,
+                                const std::vector<MatchEvent>& events);
+    };
+
+} // namespace CoinCollector
+
+#endif //KRAFTON_MATCHREPLAY_HPP
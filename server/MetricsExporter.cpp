@@ -0,0 +1,120 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "MetricsExporter.hpp"
+#include <iostream>
+#include <string>
+
+#ifndef _WIN32
+    #include <arpa/inet.h>
+    #include <sys/select.h>
+#endif
+
+namespace CoinCollector {
+
+namespace {
+    // How often the server thread checks for stop() while idle
+    constexpr int POLL_INTERVAL_MS = 100;
+    // A scraper that has not sent its request by then is answered anyway
+    constexpr int REQUEST_WAIT_MS = 200;
+
+    bool waitReadable(SocketType socket, int timeoutMs) {
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(socket, &readable);
+        timeval timeout{};
+        timeout.tv_sec = timeoutMs / 1000;
+        timeout.tv_usec = (timeoutMs % 1000) * 1000;
+        return select(static_cast<int>(socket) + 1, &readable, nullptr, nullptr, &timeout) > 0;
+    }
+}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+bool MetricsExporter::start(uint16_t port, std::function<std::string()> render) {
+    stop();
+
+    listenSocket_ = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (listenSocket_ == INVALID_SOCKET_VALUE) {
+        std::cerr << "[Metrics] Failed to create socket" << std::endl;
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(listenSocket_, SOL_SOCKET, SO_REUSEADDR,
+               reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    // Loopback only: metrics are for a local agent, not the internet
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (bind(listenSocket_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        listen(listenSocket_, 4) < 0) {
+        std::cerr << "[Metrics] Cannot listen on 127.0.0.1:" << port << std::endl;
+        closesocket(listenSocket_);
+        listenSocket_ = INVALID_SOCKET_VALUE;
+        return false;
+    }
+
+    render_ = std::move(render);
+    stopping_ = false;
+    server_ = std::thread(&MetricsExporter::serveLoop, this);
+    std::cout << "[Metrics] Serving http://127.0.0.1:" << port << "/metrics" << std::endl;
+    return true;
+}
+
+void MetricsExporter::stop() {
+    if (server_.joinable()) {
+        stopping_ = true;
+        server_.join();
+    }
+    if (listenSocket_ != INVALID_SOCKET_VALUE) {
+        closesocket(listenSocket_);
+        listenSocket_ = INVALID_SOCKET_VALUE;
+    }
+}
+
+void MetricsExporter::serveLoop() {
+    while (!stopping_) {
+        if (!waitReadable(listenSocket_, POLL_INTERVAL_MS)) continue;
+
+        SocketType client = accept(listenSocket_, nullptr, nullptr);
+        if (client == INVALID_SOCKET_VALUE) continue;
+
+        serve(client);
+        closesocket(client);
+    }
+}
+
+void MetricsExporter::serve(SocketType client) {
+    // Read (and ignore) the request; every path gets the metrics
+    char request[1024];
+    if (waitReadable(client, REQUEST_WAIT_MS)) {
+        recv(client, request, sizeof(request), 0);
+    }
+
+    std::string body = render_();
+    std::string response = "HTTP/1.1 200 OK\r\n"
+                           "Content-Type: text/plain; version=0.0.4\r\n"
+                           "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                           "Connection: close\r\n\r\n" + body;
+
+#ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL; // a scraper hanging up must not kill the server
+#else
+    const int flags = 0;
+#endif
+    size_t sent = 0;
+    while (sent < response.size()) {
+        int n = ::send(client, response.data() + sent, static_cast<int>(response.size() - sent), flags);
+        if (n <= 0) break;
+        sent += static_cast<size_t>(n);
+    }
+    scrapes_.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace CoinCollector
@@ -0,0 +1,53 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#ifndef KRAFTON_METRICSEXPORTER_HPP
+#define KRAFTON_METRICSEXPORTER_HPP
+
+#pragma once
+#include "Shared.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace CoinCollector {
+
+    /**
+     * Tiny HTTP endpoint for Prometheus scrapes.
+     *
+     * Listens on 127.0.0.1 only and answers every request, whatever the
+     * path, with the text from the render callback. It runs on its own
+     * thread so a slow scraper never touches the tick; the callback must
+     * therefore only read thread-safe state (see ServerMetrics).
+     */
+    class MetricsExporter {
+    public:
+        MetricsExporter() = default;
+        ~MetricsExporter();
+
+        MetricsExporter(const MetricsExporter&) = delete;
+        MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+        bool start(uint16_t port, std::function<std::string()> render);
+        void stop();
+        bool isRunning() const { return server_.joinable(); }
+
+        uint64_t getScrapeCount() const { return scrapes_.load(std::memory_order_relaxed); }
+
+    private:
+        void serveLoop();
+        void serve(SocketType client);
+
+        std::function<std::string()> render_;
+        SocketType listenSocket_ = INVALID_SOCKET_VALUE;
+        std::thread server_;
+        std::atomic<bool> stopping_{false};
+        std::atomic<uint64_t> scrapes_{0};
+    };
+
+} // namespace CoinCollector
+
+#endif //KRAFTON_METRICSEXPORTER_HPP
@@ -0,0 +1,52 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "MatchLog.hpp"
+#include "MatchReplay.hpp"
+#include <iostream>
+
+int main(int argc, char* argv[]) {
+    using namespace CoinCollector;
+
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <match.log>" << std::endl;
+        return 1;
+    }
+
+    MatchLogHeader header;
+    std::vector<MatchEvent> events;
+    if (!MatchLog::read(argv[1], header, events)) {
+        return 1;
+    }
+
+    std::cout << "=== Coin Collector Match Replay ===" << std::endl;
+    std::cout << "Log: " << argv[1] << std::endl;
+    std::cout << "Seed: " << header.seed << std::endl;
+    std::cout << "Tick Rate: " << header.tickRate << " Hz" << std::endl;
+    std::cout << "Max Rewind: " << header.maxRewindTicks << " ticks" << std::endl;
+    std::cout << "Events: " << events.size() << std::endl;
+    std::cout << "===================================" << std::endl;
+
+    if (header.tickRate != TICK_RATE) {
+        std::cerr << "Warning: recorded at " << header.tickRate
+                  << " Hz, replaying at " << TICK_RATE << " Hz" << std::endl;
+    }
+
+    ReplayResult result = MatchReplay::run(header, events);
+
+    double ticksPerSecond = result.seconds > 0.0 ? result.ticks / result.seconds : 0.0;
+    std::cout << "Ticks: " << result.ticks
+              << " (" << static_cast<uint64_t>(ticksPerSecond) << " ticks/s, "
+              << result.seconds * 1000.0 << " ms)" << std::endl;
+    std::cout << "Inputs: " << result.inputs << ", Connects: " << result.connects
+              << ", Resumes: " << result.resumes << std::endl;
+    std::cout << "Checksums: " << result.checksumsVerified << " verified, "
+              << result.checksumMismatches << " mismatched" << std::endl;
+    std::cout << "Spawn mismatches: " << result.spawnMismatches << std::endl;
+    for (const auto& player : result.finalPlayers) {
+        std::cout << "  Player " << player.id << " score " << player.score << std::endl;
+    }
+
+    return (result.checksumMismatches == 0 && result.spawnMismatches == 0) ? 0 : 2;
+}
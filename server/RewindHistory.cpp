@@ -0,0 +1,101 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "RewindHistory.hpp"
+#include "ServerPlayer.hpp"
+
+#include <algorithm>
+
+namespace CoinCollector {
+
+RewindHistory::RewindHistory(uint32_t capacityTicks)
+    : frames_(std::max<uint32_t>(capacityTicks, 1)),
+      maxRewindTicks_(std::min<uint32_t>(MAX_REWIND_MS * TICK_RATE / 1000, getCapacity() - 1)) {}
+
+void RewindHistory::setMaxRewindTicks(uint32_t ticks) {
+    maxRewindTicks_ = std::min(ticks, getCapacity() - 1);
+}
+
+void RewindHistory::record(uint32_t tick,
+                           const std::vector<ServerPlayer*>& players,
+                           const std::vector<CoinState>& coins,
+                           const std::vector<uint32_t>& coinGenerations) {
+    Frame& frame = frames_[tick % frames_.size()];
+    frame.tick = tick;
+    frame.valid = true;
+    frame.ids.clear();
+    frame.positions.clear();
+    frame.coins.clear();
+
+    // Players normally arrive in join order, which is id order
+    bool sorted = true;
+    for (const auto* player : players) {
+        if (!frame.ids.empty() && player->getId() < frame.ids.back()) sorted = false;
+        frame.ids.push_back(player->getId());
+        frame.positions.push_back(player->getState().position);
+    }
+
+    if (!sorted) {
+        sortScratch_.resize(players.size());
+        for (size_t i = 0; i < sortScratch_.size(); ++i) sortScratch_[i] = i;
+        std::sort(sortScratch_.begin(), sortScratch_.end(),
+                  [&players](size_t a, size_t b) { return players[a]->getId() < players[b]->getId(); });
+        for (size_t i = 0; i < sortScratch_.size(); ++i) {
+            frame.ids[i] = players[sortScratch_[i]]->getId();
+            frame.positions[i] = players[sortScratch_[i]]->getState().position;
+        }
+    }
+
+    for (size_t i = 0; i < coins.size(); ++i) {
+        CoinSample sample;
+        sample.position = coins[i].position;
+        sample.generation = i < coinGenerations.size() ? coinGenerations[i] : 0;
+        sample.active = coins[i].active;
+        frame.coins.push_back(sample);
+    }
+
+    latestTick_ = tick;
+    hasLatest_ = true;
+}
+
+void RewindHistory::clear() {
+    for (auto& frame : frames_) {
+        frame.valid = false;
+    }
+    hasLatest_ = false;
+}
+
+uint32_t RewindHistory::clampTick(uint32_t requested) const {
+    uint32_t oldest = latestTick_ > maxRewindTicks_ ? latestTick_ - maxRewindTicks_ : 0;
+    return std::min(std::max(requested, oldest), latestTick_);
+}
+
+const RewindHistory::Frame* RewindHistory::frameAt(uint32_t tick) const {
+    if (!hasLatest_) return nullptr;
+
+    // Walk forward past gaps (e.g. right after a restore) to the nearest frame
+    for (uint32_t t = clampTick(tick); t <= latestTick_; ++t) {
+        const Frame& frame = frames_[t % frames_.size()];
+        if (frame.valid && frame.tick == t) return &frame;
+    }
+    return nullptr;
+}
+
+bool RewindHistory::positionAt(PlayerID playerId, uint32_t tick, Vec2& out) const {
+    const Frame* frame = frameAt(tick);
+    if (!frame) return false;
+
+    auto it = std::lower_bound(frame->ids.begin(), frame->ids.end(), playerId);
+    if (it == frame->ids.end() || *it != playerId) return false;
+
+    out = frame->positions[it - frame->ids.begin()];
+    return true;
+}
+
+const std::vector<RewindHistory::CoinSample>* RewindHistory::coinsAt(uint32_t tick) const {
+    const Frame* frame = frameAt(tick);
+    return frame ? &frame->coins : nullptr;
+}
+
+} // namespace CoinCollector
@@ -0,0 +1,82 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#ifndef KRAFTON_REWINDHISTORY_HPP
+#define KRAFTON_REWINDHISTORY_HPP
+
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Shared.hpp"
+
+namespace CoinCollector {
+    class ServerPlayer;
+
+    /**
+     * Per-tick history of the world for lag compensation
+     *
+     * A fixed ring of frames, one per tick, each holding every player's
+     * position (ids and positions in separate arrays, sorted by id) and the
+     * coin layout at the end of that tick. Frames are reused in place, so
+     * recording allocates nothing once the ring has warmed up: one second
+     * for 5000 players is about 3.6 MB.
+     */
+    class RewindHistory {
+    public:
+        struct CoinSample {
+            Vec2 position;
+            uint32_t generation = 0; // bumped each time the coin respawns
+            bool active = false;
+        };
+
+        explicit RewindHistory(uint32_t capacityTicks = REWIND_HISTORY_MS * TICK_RATE / 1000);
+
+        // Furthest a query may reach behind the latest tick (clamped to the ring size)
+        void setMaxRewindTicks(uint32_t ticks);
+        uint32_t getMaxRewindTicks() const { return maxRewindTicks_; }
+        uint32_t getCapacity() const { return static_cast<uint32_t>(frames_.size()); }
+
+        void record(uint32_t tick,
+                    const std::vector<ServerPlayer*>& players,
+                    const std::vector<CoinState>& coins,
+                    const std::vector<uint32_t>& coinGenerations);
+        void clear();
+
+        /**
+         * Clamp a client's perceived tick into the rewindable window
+         * [latest - maxRewind, latest]
+         */
+        uint32_t clampTick(uint32_t requested) const;
+
+        // Rewind queries; the tick is clamped first. False if nothing was recorded.
+        bool positionAt(PlayerID playerId, uint32_t tick, Vec2& out) const;
+        const std::vector<CoinSample>* coinsAt(uint32_t tick) const;
+
+        bool empty() const { return !hasLatest_; }
+        uint32_t getLatestTick() const { return latestTick_; }
+
+    private:
+        struct Frame {
+            uint32_t tick = 0;
+            bool valid = false;
+            std::vector<PlayerID> ids;
+            std::vector<Vec2> positions;
+            std::vector<CoinSample> coins;
+        };
+
+        const Frame* frameAt(uint32_t tick) const;
+
+        std::vector<Frame> frames_;
+        std::vector<size_t> sortScratch_;
+        uint32_t maxRewindTicks_;
+        uint32_t latestTick_ = 0;
+        bool hasLatest_ = false;
+    };
+
+} // namespace CoinCollector
+
+#endif //KRAFTON_REWINDHISTORY_HPP
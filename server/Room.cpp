@@ -0,0 +1,380 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "Room.hpp"
+#include "GameCommon.hpp"
+#include "GameProtocol.hpp"
+#include "ServerNetwork.hpp"
+#include "Log.hpp"
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace CoinCollector {
+
+Room::Room(uint32_t id, uint64_t seed, ServerNetwork& network)
+    : id_(id), currentTick_(0), network_(network), world_(seed) {}
+
+bool Room::enableRecording(const std::string& path) {
+    return recorder_.open(path, world_.getSeed(),
+                          static_cast<uint16_t>(world_.getMaxRewindTicks()));
+}
+
+void Room::start() {
+    // Resume the previous world if there is one, otherwise spawn initial coins
+    if (!restoreCheckpoint()) {
+        world_.spawnCoins(players_);
+    }
+
+    if (!checkpointPath_.empty()) {
+        checkpointWriter_.start(checkpointPath_);
+    }
+}
+
+void Room::stop() {
+    if (checkpointWriter_.isRunning()) {
+        // Final checkpoint so a clean shutdown loses nothing
+        checkpointWriter_.submit(buildCheckpoint());
+        checkpointWriter_.stop();
+    }
+    recorder_.close();
+}
+
+void Room::tick(bool lastStep) {
+    // Process client inputs (movement is applied here)
+    {
+        ScopedTimer timed(timer(TickPhase::Inputs));
+        TRACE_SCOPE("room", "inputs");
+        processInputs();
+    }
+
+    // Check collisions
+    {
+        ScopedTimer timed(timer(TickPhase::Collisions));
+        TRACE_SCOPE("room", "collisions");
+        world_.checkCollisions(players_, currentTick_);
+    }
+
+    if (recorder_.isOpen() && currentTick_ % CHECKSUM_INTERVAL_TICKS == 0) {
+        recorder_.recordChecksum(currentTick_, world_.stateHash(players_));
+    }
+
+    if (checkpointWriter_.isRunning() && currentTick_ % CHECKPOINT_INTERVAL_TICKS == 0 && !checkpointOwed_) {
+        checkpointOwed_ = true;
+        checkpointDueTick_ = currentTick_;
+    }
+    // Shedding postpones a checkpoint by at most one interval, never indefinitely
+    if (checkpointOwed_ && (!shedding_ || currentTick_ - checkpointDueTick_ >= CHECKPOINT_INTERVAL_TICKS)) {
+        checkpointWriter_.submit(buildCheckpoint());
+        checkpointOwed_ = false;
+        checkpointsSubmitted_++;
+    }
+
+    // Broadcast world state (every 3 ticks = 20Hz), once per catch-up run
+    if (currentTick_ % BROADCAST_INTERVAL_TICKS == 0) {
+        snapshotOwed_ = true;
+    }
+    if (snapshotOwed_ && lastStep) {
+        ScopedTimer timed(timer(TickPhase::Broadcast));
+        TRACE_SCOPE("room", "broadcast");
+        broadcastWorldState();
+        snapshotOwed_ = false;
+    }
+
+    currentTick_++;
+    if (currentTick_ % BROADCAST_INTERVAL_TICKS == 0) {
+        publishOwed_ = true;
+    }
+}
+
+void Room::setShedding(bool shedding) {
+    shedding_ = shedding;
+    world_.setLogPickups(!shedding);
+}
+
+void Room::processInputs() {
+    for (auto& player : players_) {
+        InputPacket input;
+        if (player->popInput(input)) {
+            world_.applyInput(*player, input);
+
+            if (recorder_.isOpen()) {
+                recorder_.recordInput(currentTick_, player->getId(), input);
+            }
+        }
+    }
+}
+
+void Room::broadcastWorldState() {
+    // Broadcast to the room's clients through latency buffer
+    network_.broadcast(buildWorldState(), id_);
+}
+
+ByteBuffer Room::buildWorldState() const {
+    // Build player states in the frame arena
+    ArenaVector<PlayerState> playerStates{ArenaAllocator<PlayerState>(arena_)};
+    size_t mirroredPlayers = 0;
+    size_t mirroredCoins = 0;
+    for (const auto& mirror : mirrors_) {
+        mirroredPlayers += mirror.players.size();
+        mirroredCoins += mirror.coins.size();
+    }
+    playerStates.reserve(players_.size() + mirroredPlayers);
+    for (const auto& player : players_) {
+        PlayerState state = player->getState();
+        state.lastProcessedSeq = player->getLastProcessedSeq();
+        playerStates.push_back(state);
+    }
+
+    if (!shardLink_) {
+        // Serialize world state
+        return GameProtocol::serializeWorldState(
+            currentTick_,
+            currentTick_,
+            playerStates,
+            world_.getCoins()
+        );
+    }
+
+    // Sharded: the rest of the world as the other shards last reported it
+    ArenaVector<CoinState> coins{ArenaAllocator<CoinState>(arena_)};
+    coins.reserve(world_.getCoins().size() + mirroredCoins);
+    coins.insert(coins.end(), world_.getCoins().begin(), world_.getCoins().end());
+    for (const auto& mirror : mirrors_) {
+        playerStates.insert(playerStates.end(), mirror.players.begin(), mirror.players.end());
+        coins.insert(coins.end(), mirror.coins.begin(), mirror.coins.end());
+    }
+    return GameProtocol::serializeWorldState(currentTick_, currentTick_, playerStates, coins);
+}
+
+Vec2 Room::spawnPlayerPosition() {
+    // Called from ServerNetwork on connect, before the player joins players_
+    return world_.spawnPlayerPosition(players_);
+}
+
+bool Room::restoreCheckpoint() {
+    if (checkpointPath_.empty()) return false;
+
+    auto loadStart = std::chrono::steady_clock::now();
+    WorldCheckpoint checkpoint;
+    if (!WorldCheckpoint::load(checkpointPath_, checkpoint)) {
+        LOG_WARN("Room", id_ << ": No usable checkpoint at " << checkpointPath_);
+        return false;
+    }
+
+    currentTick_ = checkpoint.tick;
+    world_.restoreCoins(checkpoint.coins);
+    // Every restored session waits for its owner like a dropped connection
+    for (const auto& session : checkpoint.sessions) {
+        network_.parkSession(session.token, session.playerId, session.score, id_);
+    }
+
+    auto elapsed = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - loadStart).count();
+    LOG_INFO("Room", id_ << ": Restored checkpoint at tick " << checkpoint.tick << ": "
+             << checkpoint.sessions.size() << " sessions, " << checkpoint.coins.size()
+             << " coins in " << elapsed << " ms");
+
+    if (recorder_.isOpen()) {
+        LOG_WARN("Room", id_ << ": Recording a restored world, replay will not match");
+    }
+    return true;
+}
+
+WorldCheckpoint Room::buildCheckpoint() const {
+    WorldCheckpoint checkpoint;
+    checkpoint.tick = currentTick_;
+    checkpoint.coins = world_.getCoins();
+
+    std::vector<const ServerPlayer*> sessions(players_.begin(), players_.end());
+    for (const auto* player : network_.getParkedPlayers()) {
+        if (player->getRoomId() == id_) sessions.push_back(player);
+    }
+
+    checkpoint.sessions.reserve(sessions.size());
+    for (const auto* player : sessions) {
+        WorldCheckpoint::Session session;
+        session.token = player->getSessionToken();
+        session.playerId = player->getId();
+        session.score = player->getState().score;
+        checkpoint.sessions.push_back(session);
+    }
+
+    return checkpoint;
+}
+
+void Room::onPlayerConnected(ServerPlayer& player, bool resumed) {
+    // No rewind until the client reports what it has seen
+    player.setViewTick(currentTick_);
+
+    auto pos = std::upper_bound(players_.begin(), players_.end(), &player,
+        [](const ServerPlayer* a, const ServerPlayer* b) { return a->getId() < b->getId(); });
+    players_.insert(pos, &player);
+
+    if (recorder_.isOpen()) {
+        if (resumed) {
+            recorder_.recordResume(currentTick_, player.getState());
+        } else {
+            recorder_.recordConnect(currentTick_, player.getId(), player.getState().position);
+        }
+    }
+
+    if (resumed) {
+        // Full snapshot right away instead of waiting for the next broadcast
+        network_.send(player.getId(), buildWorldState());
+    }
+}
+
+void Room::enableSharding(const ShardMap& map, ShardLink& link) {
+    shardMap_ = map;
+    shardLink_ = &link;
+    mirrors_.assign(map.count, ShardMirror());
+
+    // Same coin density as the unsharded world, ids unique across shards
+    int coinCount = std::max(1, MAX_COINS / static_cast<int>(map.count));
+    world_.setRegion(map.minX(map.index), map.maxX(map.index), coinCount, map.index * MAX_COINS);
+}
+
+void Room::exchangeWithShards() {
+    if (!shardLink_) return;
+
+    handOffPlayers();
+    claimMirroredCoins();
+    if (publishOwed_) {
+        publishToShards();
+        publishOwed_ = false;
+    }
+}
+
+void Room::handOffPlayers() {
+    float minX = shardMap_.minX(shardMap_.index) - SHARD_HANDOFF_MARGIN;
+    float maxX = shardMap_.maxX(shardMap_.index) + SHARD_HANDOFF_MARGIN;
+
+    // handOff() removes the player from players_ through the disconnect callback
+    ArenaVector<ServerPlayer*> leaving{ArenaAllocator<ServerPlayer*>(arena_)};
+    for (auto* player : players_) {
+        float x = player->getState().position.x;
+        if (x < minX || x >= maxX) leaving.push_back(player);
+    }
+
+    for (auto* player : leaving) {
+        uint32_t target = shardMap_.ownerOf(player->getState().position.x);
+        // With the neighbor down the player just stays here past the border
+        if (!shardLink_->isConnected(target)) continue;
+
+        HandoffState handoff;
+        handoff.sessionToken = player->getSessionToken();
+        handoff.state = player->getState();
+        handoff.lastProcessedSeq = player->getLastProcessedSeq();
+        PlayerID playerId = player->getId();
+
+        // The state reaches the next shard long before the client does
+        shardLink_->send(target, ShardProtocol::serializeHandoff(handoff));
+        network_.handOff(playerId, GameProtocol::serializeRedirect(0, shardMap_.portOf(target)));
+        LOG_INFO("Room", id_ << ": Player " << playerId << " handed off to shard " << target);
+    }
+}
+
+void Room::claimMirroredCoins() {
+    // Unanswered claims are retried after a second
+    uint32_t tick = currentTick_;
+    outstandingClaims_.erase(std::remove_if(outstandingClaims_.begin(), outstandingClaims_.end(),
+        [tick](const OutstandingClaim& claim) { return tick - claim.tick > static_cast<uint32_t>(TICK_RATE); }),
+        outstandingClaims_.end());
+
+    for (uint32_t shard = 0; shard < mirrors_.size(); ++shard) {
+        for (const auto& coin : mirrors_[shard].coins) {
+            if (!coin.active) continue;
+            bool outstanding = std::any_of(outstandingClaims_.begin(), outstandingClaims_.end(),
+                [&coin](const OutstandingClaim& claim) { return claim.coinId == coin.id; });
+            if (outstanding) continue;
+
+            for (auto* player : players_) {
+                if (!GameCommon::checkCollision(player->getState().position, coin.position)) continue;
+
+                // The owner decides; first valid claim wins
+                CoinClaim claim;
+                claim.coinId = coin.id;
+                claim.coinPosition = coin.position;
+                claim.playerId = player->getId();
+                shardLink_->send(shard, ShardProtocol::serializePickupClaim(claim));
+                outstandingClaims_.push_back({coin.id, tick});
+                break;
+            }
+        }
+    }
+}
+
+void Room::publishToShards() {
+    ArenaVector<PlayerState> players{ArenaAllocator<PlayerState>(arena_)};
+    players.reserve(players_.size());
+    for (const auto* player : players_) {
+        players.push_back(player->getState());
+    }
+    shardLink_->broadcast(ShardProtocol::serializeGhosts(currentTick_, players, world_.getCoins()));
+}
+
+void Room::onShardMessage(uint32_t fromShard, ShardMessage type, ByteBuffer& payload) {
+    switch (type) {
+        case ShardMessage::Ghosts: {
+            uint32_t tick = 0;
+            ShardMirror& mirror = mirrors_[fromShard];
+            ShardProtocol::deserializeGhosts(payload, tick, mirror.players, mirror.coins);
+
+            // Shards follow the furthest-ahead clock so clients see one tick
+            // sequence across handoffs. Never backwards: a restarted shard
+            // catches up rather than rewinding the others' clients and claims.
+            int64_t drift = static_cast<int64_t>(tick) - static_cast<int64_t>(currentTick_);
+            if (drift > SHARD_TICK_TOLERANCE) {
+                currentTick_ = tick;
+            }
+            break;
+        }
+        case ShardMessage::Handoff: {
+            HandoffState handoff = ShardProtocol::deserializeHandoff(payload);
+            network_.adoptSession(handoff.sessionToken, handoff.state, handoff.lastProcessedSeq, id_);
+            // Hide the stale copy until our own broadcasts include the player
+            auto& players = mirrors_[fromShard].players;
+            players.erase(std::remove_if(players.begin(), players.end(),
+                [&handoff](const PlayerState& state) { return state.id == handoff.state.id; }), players.end());
+            break;
+        }
+        case ShardMessage::PickupClaim: {
+            CoinClaim claim = ShardProtocol::deserializePickupClaim(payload);
+            if (world_.claimCoin(claim.coinId, claim.coinPosition, players_)) {
+                shardLink_->send(fromShard, ShardProtocol::serializePickupGrant(claim.playerId));
+            }
+            break;
+        }
+        case ShardMessage::PickupGrant: {
+            PlayerID playerId = ShardProtocol::deserializePickupGrant(payload);
+            // Lost if the player left this shard in the meantime
+            if (ServerPlayer* player = findPlayer(playerId)) {
+                player->getState().score++;
+                LOG_INFO("Room", id_ << ": Player " << playerId
+                         << " collected coin across the border. Score: " << player->getState().score);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+ServerPlayer* Room::findPlayer(PlayerID playerId) {
+    auto it = std::lower_bound(players_.begin(), players_.end(), playerId,
+        [](const ServerPlayer* player, PlayerID id) { return player->getId() < id; });
+    return (it != players_.end() && (*it)->getId() == playerId) ? *it : nullptr;
+}
+
+void Room::onPlayerDisconnected(const ServerPlayer& player) {
+    players_.erase(std::remove(players_.begin(), players_.end(), &player), players_.end());
+
+    if (recorder_.isOpen()) {
+        recorder_.recordDisconnect(currentTick_, player.getId());
+    }
+}
+
+} // namespace CoinCollector
@@ -0,0 +1,163 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#ifndef KRAFTON_ROOM_HPP
+#define KRAFTON_ROOM_HPP
+
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Allocators.hpp"
+#include "GameWorld.hpp"
+#include "MatchLog.hpp"
+#include "NetTypes.hpp"
+#include "ServerMetrics.hpp"
+#include "ServerPlayer.hpp"
+#include "ShardLink.hpp"
+#include "ShardProtocol.hpp"
+#include "Shared.hpp"
+#include "WorldCheckpoint.hpp"
+
+namespace CoinCollector {
+    class ServerNetwork;
+
+    /**
+     * One independent match: its own world, player list and tick
+     *
+     * Rooms share the server's ServerNetwork. Network callbacks
+     * (connect, disconnect, spawn) run on the I/O thread between ticks;
+     * tick() may run on any pool thread, and touches only this room and
+     * the thread-safe outgoing packet queue.
+     */
+    class Room {
+    public:
+        // World checkpoint cadence (every 5 seconds); shedding delays one by at most this much
+        static constexpr uint32_t CHECKPOINT_INTERVAL_TICKS = 5 * TICK_RATE;
+
+        Room(uint32_t id, uint64_t seed, ServerNetwork& network);
+
+        Room(const Room&) = delete;
+        Room& operator=(const Room&) = delete;
+
+        uint32_t getId() const { return id_; }
+        uint32_t getTick() const { return currentTick_; }
+        size_t getPlayerCount() const { return players_.size(); }
+        const std::vector<ServerPlayer*>& getPlayers() const { return players_; }
+
+        // Lag compensation window for pickups; call before enableRecording()
+        void setMaxRewindTicks(uint32_t ticks) { world_.setMaxRewindTicks(ticks); }
+        uint32_t getMaxRewindTicks() const { return world_.getMaxRewindTicks(); }
+
+        // Record the match for GameReplay; call before start()
+        bool enableRecording(const std::string& path);
+
+        // Restore from and periodically write a world checkpoint; call before start()
+        void enableCheckpoints(const std::string& path) { checkpointPath_ = path; }
+
+        // Coins in play; call before start()
+        void setCoinCount(int coinCount) { world_.setCoinCount(coinCount); }
+
+        // Time tick phases into the server's shared histograms
+        void setMetrics(ServerMetrics* metrics) { metrics_ = metrics; }
+
+        /**
+         * Simulate only this shard's strip of a world split across processes.
+         * The other shards' players and coins are mirrored from the link and
+         * sent to clients with our own, so every client sees the whole world.
+         * Call before start().
+         */
+        void enableSharding(const ShardMap& map, ShardLink& link);
+
+        // Handoffs, pickups of mirrored coins and mirroring our own state;
+        // runs on the server thread after tick(), like network I/O
+        void exchangeWithShards();
+        void onShardMessage(uint32_t fromShard, ShardMessage type, ByteBuffer& payload);
+
+        void start();
+        void stop();
+
+        /**
+         * One fixed step: inputs, pickups, logging, broadcast. When the
+         * server runs several steps back to back to catch up, only the
+         * last of them (lastStep) sends the snapshot the others owed.
+         */
+        void tick(bool lastStep = true);
+
+        // Under overload: no pickup logging, checkpoints wait until it clears
+        // or until they are a full interval late
+        void setShedding(bool shedding);
+        uint64_t getCheckpointsSubmitted() const { return checkpointsSubmitted_; }
+
+        // Frees this frame's temporaries; the server calls it after every frame
+        void resetArena() { arena_.reset(); }
+        const FrameArena& getArena() const { return arena_; }
+
+        Vec2 spawnPlayerPosition();
+        void onPlayerConnected(ServerPlayer& player, bool resumed);
+        void onPlayerDisconnected(const ServerPlayer& player);
+
+    private:
+        void processInputs();
+        void broadcastWorldState();
+        ByteBuffer buildWorldState() const;
+        bool restoreCheckpoint();
+        WorldCheckpoint buildCheckpoint() const;
+        void handOffPlayers();
+        void claimMirroredCoins();
+        void publishToShards();
+        ServerPlayer* findPlayer(PlayerID playerId);
+        LatencyHistogram* timer(TickPhase phase) const {
+            return metrics_ ? metrics_->phase(phase) : nullptr;
+        }
+
+        // What another shard last told us it owns
+        struct ShardMirror {
+            std::vector<PlayerState> players;
+            std::vector<CoinState> coins;
+        };
+
+        // Claim sent for another shard's coin, not answered yet
+        struct OutstandingClaim {
+            uint32_t coinId;
+            uint32_t tick;
+        };
+
+        // World checksum cadence in the match log (1 per second)
+        static constexpr uint32_t CHECKSUM_INTERVAL_TICKS = TICK_RATE;
+
+        uint32_t id_;
+        uint32_t currentTick_;
+        ServerNetwork& network_;
+        std::vector<ServerPlayer*> players_; // sorted by id
+        GameWorld world_;
+        MatchRecorder recorder_;
+
+        std::string checkpointPath_;
+        CheckpointWriter checkpointWriter_;
+
+        ShardMap shardMap_;
+        ShardLink* shardLink_ = nullptr;
+        std::vector<ShardMirror> mirrors_; // by shard index
+        std::vector<OutstandingClaim> outstandingClaims_;
+
+        // Work a catch-up step skipped, done by the next step allowed to
+        bool snapshotOwed_ = false;
+        bool publishOwed_ = false;
+        bool checkpointOwed_ = false;
+        uint32_t checkpointDueTick_ = 0;
+        uint64_t checkpointsSubmitted_ = 0;
+        bool shedding_ = false;
+
+        ServerMetrics* metrics_ = nullptr;
+
+        // Per-frame scratch (snapshot player lists); mutable so const builders can use it
+        mutable FrameArena arena_;
+    };
+
+} // namespace CoinCollector
+
+#endif //KRAFTON_ROOM_HPP
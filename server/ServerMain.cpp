@@ -4,12 +4,17 @@
 
 #include "GameServer.hpp"
 #include "Shared.hpp"
+#include "Log.hpp"
+#include "Trace.hpp"
 #include <iostream>
 #include <csignal>
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <ctime>
 #include <cstdlib>
+#include <string>
+#include <vector>
 
 std::atomic<bool> g_running(true);
 
@@ -21,26 +26,130 @@ void signalHandler(int signal) {
 }
 
 int main(int argc, char* argv[]) {
-    std::srand(static_cast<unsigned>(std::time(nullptr)));
     using namespace CoinCollector;
 
     // Setup signal handlers
     std::signal(SIGINT, signalHandler);
     std::signal(SIGTERM, signalHandler);
 
+    // Usage: GameServer [port] [seed] [--record <match.log>] [--checkpoint <world.ckpt>]
+    //                   [--max-rewind <ms>] [--rooms <max>] [--room-size <players>]
+    //                   [--threads <n>] [--shard <i>/<n>] [--shard-socket <prefix>] [--shm]
+    //                   [--metrics-port <port>] [--trace <ticks.json>] [--log-json]
+    std::vector<std::string> positional;
+    std::string recordPath;
+    std::string checkpointPath;
+    int maxRewindMs = MAX_REWIND_MS;
+    size_t maxRooms = 1;
+    size_t roomSize = 0;
+    size_t threads = 0;
+    ShardMap shardMap;
+    std::string shardSocket = "/tmp/coincollector-shard";
+    bool sharedMemory = false;
+    uint16_t metricsPort = 0;
+    std::string tracePath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--record" && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (arg == "--checkpoint" && i + 1 < argc) {
+            checkpointPath = argv[++i];
+        } else if (arg == "--max-rewind" && i + 1 < argc) {
+            maxRewindMs = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--rooms" && i + 1 < argc) {
+            maxRooms = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--room-size" && i + 1 < argc) {
+            roomSize = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--shard" && i + 1 < argc) {
+            std::string spec = argv[++i];
+            size_t slash = spec.find('/');
+            if (slash == std::string::npos) {
+                std::cerr << "--shard expects <index>/<count>" << std::endl;
+                return 1;
+            }
+            shardMap.index = static_cast<uint32_t>(std::atoi(spec.substr(0, slash).c_str()));
+            shardMap.count = static_cast<uint32_t>(std::max(1, std::atoi(spec.substr(slash + 1).c_str())));
+        } else if (arg == "--shard-socket" && i + 1 < argc) {
+            shardSocket = argv[++i];
+        } else if (arg == "--shm") {
+            sharedMemory = true;
+        } else if (arg == "--metrics-port" && i + 1 < argc) {
+            metricsPort = static_cast<uint16_t>(std::atoi(argv[++i]));
+        } else if (arg == "--trace" && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (arg == "--log-json") {
+            Log::setJson(true);
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
     uint16_t port = SERVER_PORT;
-    if (argc > 1) {
-        port = static_cast<uint16_t>(std::atoi(argv[1]));
+    if (positional.size() > 0) {
+        port = static_cast<uint16_t>(std::atoi(positional[0].c_str()));
+    }
+
+    // World seed: fixed for reproducible runs, time-based otherwise
+    uint64_t seed = static_cast<uint64_t>(std::time(nullptr));
+    if (positional.size() > 1) {
+        seed = std::strtoull(positional[1].c_str(), nullptr, 10);
+    }
+
+    // Shards take clients on consecutive ports from the base port
+    shardMap.basePort = port;
+    if (shardMap.isSharded()) {
+        if (shardMap.index >= shardMap.count) {
+            std::cerr << "Shard index must be below the shard count" << std::endl;
+            return 1;
+        }
+        port = shardMap.portOf(shardMap.index);
     }
 
     std::cout << "=== Coin Collector Multiplayer Server ===" << std::endl;
     std::cout << "Port: " << port << std::endl;
     std::cout << "Tick Rate: " << TICK_RATE << " Hz" << std::endl;
     std::cout << "Simulated Latency: " << SIMULATED_LATENCY_MS << " ms" << std::endl;
+    std::cout << "World Seed: " << seed << std::endl;
     std::cout << "==========================================" << std::endl;
 
+    // Recording and checkpoints cover a single world
+    if (maxRooms > 1 && (!recordPath.empty() || !checkpointPath.empty())) {
+        std::cerr << "--record and --checkpoint need --rooms 1" << std::endl;
+        return 1;
+    }
+    // A shard is one room, and cross-shard events are not in its match log
+    if (shardMap.isSharded() && (maxRooms > 1 || !recordPath.empty())) {
+        std::cerr << "--shard cannot be combined with --rooms or --record" << std::endl;
+        return 1;
+    }
+
     try {
-        GameServer server(port);
+        GameServer server(port, seed, roomSize, maxRooms, threads);
+        server.setMaxRewindTicks(static_cast<uint32_t>(maxRewindMs) * TICK_RATE / 1000);
+        std::cout << "[Server] Max rewind: " << server.getMaxRewindTicks() << " ticks" << std::endl;
+
+        if (!recordPath.empty() && !server.enableRecording(recordPath)) {
+            std::cerr << "Failed to open match recording" << std::endl;
+            return 1;
+        }
+        if (!checkpointPath.empty()) {
+            server.enableCheckpoints(checkpointPath);
+        }
+        if (shardMap.isSharded()) {
+            server.enableSharding(shardMap, shardSocket);
+            std::cout << "[Server] Shard " << shardMap.index << " of " << shardMap.count
+                      << ", owns x in [" << shardMap.minX(shardMap.index) << ", "
+                      << shardMap.maxX(shardMap.index) << ")" << std::endl;
+        }
+        if (sharedMemory) {
+            server.enableSharedMemory();
+        }
+        if (metricsPort != 0 && !server.enableMetrics(metricsPort)) {
+            std::cerr << "Failed to start metrics endpoint" << std::endl;
+            return 1;
+        }
 
         if (!server.start()) {
             std::cerr << "Failed to start server" << std::endl;
@@ -50,9 +159,22 @@ int main(int argc, char* argv[]) {
         std::cout << "Server started successfully" << std::endl;
         std::cout << "Press Ctrl+C to stop" << std::endl;
 
+        if (!tracePath.empty()) {
+            Trace::setThreadName("server");
+            Trace::start();
+        }
+
         // Main game loop
         server.run(g_running);
 
+        if (!tracePath.empty()) {
+            if (Trace::stop(tracePath)) {
+                std::cout << "[Server] Trace written to " << tracePath << std::endl;
+            } else {
+                std::cerr << "Failed to write trace " << tracePath << std::endl;
+            }
+        }
+
         std::cout << "Server shutting down..." << std::endl;
         server.stop();
 
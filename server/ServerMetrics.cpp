@@ -0,0 +1,213 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "ServerMetrics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace CoinCollector {
+
+    void LatencyHistogram::record(uint64_t nanos) {
+        buckets_[bucketOf(nanos)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(nanos, std::memory_order_relaxed);
+
+        uint64_t seen = max_.load(std::memory_order_relaxed);
+        while (nanos > seen && !max_.compare_exchange_weak(seen, nanos, std::memory_order_relaxed)) {
+        }
+    }
+
+    void LatencyHistogram::reset() {
+        for (auto& bucket : buckets_) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        count_.store(0, std::memory_order_relaxed);
+        sum_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t LatencyHistogram::percentile(double q) const {
+        uint64_t total = getCount();
+        if (total == 0) return 0;
+
+        uint64_t target = static_cast<uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(total)));
+        target = std::max<uint64_t>(target, 1);
+
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKET_COUNT; ++i) {
+            seen += buckets_[i].load(std::memory_order_relaxed);
+            if (seen >= target) {
+                return std::min(bucketUpperBound(i), getMax());
+            }
+        }
+        return getMax();
+    }
+
+    int LatencyHistogram::bucketOf(uint64_t nanos) {
+        if (nanos < static_cast<uint64_t>(SUB_BUCKETS)) {
+            return static_cast<int>(nanos);
+        }
+
+        int exponent = 63;
+        while (!(nanos >> exponent)) --exponent;
+        if (exponent > MAX_EXPONENT) {
+            return BUCKET_COUNT - 1;
+        }
+
+        int shift = exponent - SUB_BUCKET_BITS;
+        int sub = static_cast<int>((nanos >> shift) & (SUB_BUCKETS - 1));
+        return (shift + 1) * SUB_BUCKETS + sub;
+    }
+
+    uint64_t LatencyHistogram::bucketUpperBound(int index) {
+        int block = index / SUB_BUCKETS;
+        uint64_t sub = static_cast<uint64_t>(index % SUB_BUCKETS);
+        if (block == 0) {
+            return sub;
+        }
+
+        int shift = block - 1;
+        return ((SUB_BUCKETS + sub) << shift) + (uint64_t(1) << shift) - 1;
+    }
+
+    const char* toString(TickPhase phase) {
+        switch (phase) {
+            case TickPhase::Tick: return "tick";
+            case TickPhase::Network: return "network";
+            case TickPhase::Shards: return "shards";
+            case TickPhase::Rooms: return "rooms";
+            case TickPhase::Inputs: return "inputs";
+            case TickPhase::Collisions: return "collisions";
+            case TickPhase::Broadcast: return "broadcast";
+            case TickPhase::Count: break;
+        }
+        return "unknown";
+    }
+
+    namespace {
+
+        double seconds(uint64_t nanos) {
+            return static_cast<double>(nanos) / 1e9;
+        }
+
+        void counter(std::ostringstream& out, const char* name, const char* help, uint64_t value) {
+            out << "# HELP " << name << ' ' << help << '\n'
+                << "# TYPE " << name << " counter\n"
+                << name << ' ' << value << '\n';
+        }
+
+        void gauge(std::ostringstream& out, const char* name, const char* help, double value) {
+            out << "# HELP " << name << ' ' << help << '\n'
+                << "# TYPE " << name << " gauge\n"
+                << name << ' ' << value << '\n';
+        }
+
+    } // namespace
+
+    std::string ServerMetrics::renderPrometheus(const TrafficStats& traffic) const {
+        static const double QUANTILES[] = {0.5, 0.9, 0.99, 0.999};
+
+        std::ostringstream out;
+        out.precision(9);
+
+        out << "# HELP coincollector_tick_phase_seconds Time spent in each phase of a server tick\n"
+            << "# TYPE coincollector_tick_phase_seconds summary\n";
+        for (size_t i = 0; i < phases.size(); ++i) {
+            const LatencyHistogram& histogram = phases[i];
+            const char* name = toString(static_cast<TickPhase>(i));
+            for (double q : QUANTILES) {
+                out << "coincollector_tick_phase_seconds{phase=\"" << name << "\",quantile=\"" << q << "\"} "
+                    << seconds(histogram.percentile(q)) << '\n';
+            }
+            out << "coincollector_tick_phase_seconds_sum{phase=\"" << name << "\"} "
+                << seconds(histogram.getSum()) << '\n'
+                << "coincollector_tick_phase_seconds_count{phase=\"" << name << "\"} "
+                << histogram.getCount() << '\n';
+        }
+
+        out << "# HELP coincollector_tick_phase_max_seconds Slowest run of each tick phase\n"
+            << "# TYPE coincollector_tick_phase_max_seconds gauge\n";
+        for (size_t i = 0; i < phases.size(); ++i) {
+            out << "coincollector_tick_phase_max_seconds{phase=\"" << toString(static_cast<TickPhase>(i)) << "\"} "
+                << seconds(phases[i].getMax()) << '\n';
+        }
+
+        out << "# HELP coincollector_tick_wake_lateness_seconds How late the tick loop woke after its deadline\n"
+            << "# TYPE coincollector_tick_wake_lateness_seconds summary\n";
+        for (double q : QUANTILES) {
+            out << "coincollector_tick_wake_lateness_seconds{quantile=\"" << q << "\"} "
+                << seconds(wakeLateness.percentile(q)) << '\n';
+        }
+        out << "coincollector_tick_wake_lateness_seconds_sum " << seconds(wakeLateness.getSum()) << '\n'
+            << "coincollector_tick_wake_lateness_seconds_count " << wakeLateness.getCount() << '\n';
+
+        gauge(out, "coincollector_tick_budget_seconds", "Time available per tick",
+              static_cast<double>(FIXED_DT));
+        gauge(out, "coincollector_last_tick_seconds", "Duration of the most recent tick",
+              seconds(lastTickNanos.load(std::memory_order_relaxed)));
+        counter(out, "coincollector_ticks_total", "Ticks simulated", ticks.load(std::memory_order_relaxed));
+        counter(out, "coincollector_missed_ticks_total", "Ticks skipped because the server fell too far behind",
+                missedTicks.load(std::memory_order_relaxed));
+        counter(out, "coincollector_over_budget_ticks_total", "Ticks that took longer than the tick budget",
+                overBudgetTicks.load(std::memory_order_relaxed));
+        counter(out, "coincollector_catch_up_ticks_total", "Ticks simulated late to catch up after an overrun",
+                catchUpTicks.load(std::memory_order_relaxed));
+        counter(out, "coincollector_overloaded_frames_total", "Frames run with optional work shed",
+                overloadedFrames.load(std::memory_order_relaxed));
+        gauge(out, "coincollector_overloaded", "1 while the server is shedding optional work to catch up",
+              static_cast<double>(overloaded.load(std::memory_order_relaxed)));
+
+        counter(out, "coincollector_received_bytes_total", "Bytes read from clients",
+                traffic.bytesIn.load(std::memory_order_relaxed));
+        counter(out, "coincollector_sent_bytes_total", "Bytes written to clients",
+                traffic.bytesOut.load(std::memory_order_relaxed));
+        counter(out, "coincollector_received_packets_total", "Complete packets parsed from clients",
+                traffic.packetsIn.load(std::memory_order_relaxed));
+        counter(out, "coincollector_sent_packets_total", "Packets written to clients",
+                traffic.packetsOut.load(std::memory_order_relaxed));
+        counter(out, "coincollector_io_calls_total", "Receive, send and accept attempts",
+                traffic.ioCalls.load(std::memory_order_relaxed));
+        counter(out, "coincollector_send_failures_total", "Packets a client connection did not accept",
+                traffic.sendFailures.load(std::memory_order_relaxed));
+
+        gauge(out, "coincollector_rooms", "Open rooms",
+              static_cast<double>(rooms.load(std::memory_order_relaxed)));
+        gauge(out, "coincollector_players", "Connected players",
+              static_cast<double>(players.load(std::memory_order_relaxed)));
+        gauge(out, "coincollector_parked_sessions", "Disconnected sessions waiting to resume",
+              static_cast<double>(parkedSessions.load(std::memory_order_relaxed)));
+        gauge(out, "coincollector_pending_connections", "Connections waiting for a handshake",
+              static_cast<double>(pendingConnections.load(std::memory_order_relaxed)));
+        gauge(out, "coincollector_outgoing_queue_depth", "Packets held in the outgoing latency queue",
+              static_cast<double>(outgoingQueueDepth.load(std::memory_order_relaxed)));
+
+        return out.str();
+    }
+
+    void ServerMetrics::resetTimings() {
+        for (auto& histogram : phases) {
+            histogram.reset();
+        }
+        wakeLateness.reset();
+    }
+
+    std::string ServerMetrics::summary() const {
+        const LatencyHistogram& tick = phase(TickPhase::Tick);
+
+        std::ostringstream out;
+        out.precision(3);
+        out << std::fixed << ticks.load(std::memory_order_relaxed) << " ticks, p50 " << seconds(tick.percentile(0.5)) * 1e3
+            << " ms, p99 " << seconds(tick.percentile(0.99)) * 1e3
+            << " ms, max " << seconds(tick.getMax()) * 1e3 << " ms; wake lateness p99 "
+            << seconds(wakeLateness.percentile(0.99)) * 1e6 << " us; "
+            << overBudgetTicks.load(std::memory_order_relaxed) << " over budget, "
+            << catchUpTicks.load(std::memory_order_relaxed) << " caught up late, "
+            << missedTicks.load(std::memory_order_relaxed) << " missed, "
+            << overloadedFrames.load(std::memory_order_relaxed) << " frames overloaded";
+        return out.str();
+    }
+
+} // namespace CoinCollector
@@ -0,0 +1,148 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#ifndef KRAFTON_SERVERMETRICS_HPP
+#define KRAFTON_SERVERMETRICS_HPP
+
+#pragma once
+#include "Shared.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace CoinCollector {
+
+    /**
+     * HDR-style latency histogram in nanoseconds.
+     *
+     * Buckets are log-linear: every power of two is split into 32 equal
+     * sub-buckets, so any recorded value is reported within ~3% from 1 ns
+     * up to ~18 minutes in under 10 KB. Recording is a few relaxed atomic
+     * adds, safe from any thread (rooms tick in parallel); readers see a
+     * slightly stale but consistent-enough view.
+     */
+    class LatencyHistogram {
+    public:
+        static constexpr int SUB_BUCKET_BITS = 5;
+        static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+        static constexpr int MAX_EXPONENT = 40; // 2^40 ns ~ 18 minutes
+        static constexpr int BUCKET_COUNT = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+        void record(uint64_t nanos);
+
+        // Forget every sample; racing record() calls may land on either side
+        void reset();
+
+        // Upper bound of the bucket holding the q-th quantile (0..1); 0 when empty
+        uint64_t percentile(double q) const;
+
+        uint64_t getCount() const { return count_.load(std::memory_order_relaxed); }
+        uint64_t getSum() const { return sum_.load(std::memory_order_relaxed); }
+        uint64_t getMax() const { return max_.load(std::memory_order_relaxed); }
+
+        static int bucketOf(uint64_t nanos);
+        static uint64_t bucketUpperBound(int index);
+
+    private:
+        std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets_{};
+        std::atomic<uint64_t> count_{0};
+        std::atomic<uint64_t> sum_{0};
+        std::atomic<uint64_t> max_{0};
+    };
+
+    /**
+     * Records the lifetime of a scope into a histogram; a null histogram
+     * makes it a no-op so callers need no branches
+     */
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(LatencyHistogram* histogram)
+            : histogram_(histogram),
+              start_(histogram ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point()) {}
+
+        ~ScopedTimer() {
+            if (histogram_) {
+                auto elapsed = std::chrono::steady_clock::now() - start_;
+                histogram_->record(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+            }
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        LatencyHistogram* histogram_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    /**
+     * Wire traffic seen by ServerNetwork. ioCalls counts every receive,
+     * send and accept attempt: system calls for TCP, ring operations for
+     * shared-memory clients.
+     */
+    struct TrafficStats {
+        std::atomic<uint64_t> bytesIn{0};
+        std::atomic<uint64_t> bytesOut{0};
+        std::atomic<uint64_t> packetsIn{0};
+        std::atomic<uint64_t> packetsOut{0};
+        std::atomic<uint64_t> ioCalls{0};
+        std::atomic<uint64_t> sendFailures{0}; // ring full or socket buffer full
+    };
+
+    enum class TickPhase : uint8_t {
+        Tick = 0,   // the whole GameServer::gameLoop
+        Network,    // client and shard link I/O, handshakes, timers
+        Shards,     // handoffs, border pickups and mirroring
+        Rooms,      // every room's simulation, parallel part included
+        Inputs,     // Room::processInputs, per room
+        Collisions, // GameWorld::checkCollisions, per room
+        Broadcast,  // world state build and queue, per room
+        Count
+    };
+
+    /**
+     * Everything a GameServer reports about itself. Written by the server
+     * and room threads, read by the metrics endpoint thread, so all of it
+     * is atomic.
+     */
+    struct ServerMetrics {
+        std::array<LatencyHistogram, static_cast<size_t>(TickPhase::Count)> phases;
+        LatencyHistogram wakeLateness; // how far past its deadline the tick loop woke
+
+        std::atomic<uint64_t> ticks{0};
+        std::atomic<uint64_t> missedTicks{0};     // dropped by the frame-time cap
+        std::atomic<uint64_t> overBudgetTicks{0}; // frames that took longer than FIXED_DT
+        std::atomic<uint64_t> catchUpTicks{0};    // simulated late, without their own network pass
+        std::atomic<uint64_t> overloadedFrames{0}; // frames run with optional work shed
+        std::atomic<uint64_t> overloaded{0};       // 1 while shedding
+        std::atomic<uint64_t> lastTickNanos{0};
+
+        // Gauges sampled once per tick
+        std::atomic<uint64_t> rooms{0};
+        std::atomic<uint64_t> players{0};
+        std::atomic<uint64_t> parkedSessions{0};
+        std::atomic<uint64_t> pendingConnections{0};
+        std::atomic<uint64_t> outgoingQueueDepth{0};
+
+        LatencyHistogram* phase(TickPhase which) { return &phases[static_cast<size_t>(which)]; }
+        const LatencyHistogram& phase(TickPhase which) const { return phases[static_cast<size_t>(which)]; }
+
+        // Prometheus text exposition format (version 0.0.4)
+        std::string renderPrometheus(const TrafficStats& traffic) const;
+
+        // Start every phase histogram over, e.g. after a benchmark's warmup
+        void resetTimings();
+
+        // One line for the shutdown log
+        std::string summary() const;
+    };
+
+    const char* toString(TickPhase phase);
+
+} // namespace CoinCollector
+
+#endif //KRAFTON_SERVERMETRICS_HPP
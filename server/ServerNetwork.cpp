@@ -4,13 +4,17 @@
 
 #include "ServerNetwork.hpp"
 #include "ServerPlayer.hpp"
+#include <algorithm>
 #include <iostream>
 #include <cerrno>
 #include <cstring>
 #include <memory>
+#include <random>
 #include <utility>
 
 #include "GameProtocol.hpp"
+#include "Log.hpp"
+#include "Trace.hpp"
 
 #ifndef _WIN32
     #include <arpa/inet.h>
@@ -22,7 +26,8 @@ namespace CoinCollector {
 
 ServerNetwork::ServerNetwork(uint16_t port)
     : port_(port), listenSocket_(INVALID_SOCKET_VALUE),
-      nextPlayerId_(1), outgoingBuffer_(SIMULATED_LATENCY_MS), running_(false) {
+      nextPlayerId_(1), timerEpoch_(Clock::now()),
+      outgoingBuffer_(SIMULATED_LATENCY_MS), running_(false) {
 }
 
 ServerNetwork::~ServerNetwork() {
@@ -80,15 +85,37 @@ bool ServerNetwork::initialize() {
 }
 
 void ServerNetwork::update() {
-    acceptNewClients();
-    receiveFromClients();
-    sendToClients();
+    {
+        TRACE_SCOPE("net", "accept");
+        acceptNewClients();
+    }
+    {
+        TRACE_SCOPE("net", "handshakes");
+        receiveHandshakes();
+    }
+    {
+        TRACE_SCOPE("net", "receive");
+        receiveFromClients();
+    }
+    {
+        TRACE_SCOPE("net", "send");
+        sendToClients();
+    }
+    {
+        TRACE_SCOPE("net", "timers");
+        runTimers();
+    }
 }
 
 void ServerNetwork::shutdown() {
     running_ = false;
 
+    // Dropping the connections closes them
     players_.clear();
+    pending_.clear();
+    departing_.clear();
+    parked_.clear();
+    shmListener_.reset();
 
     if (listenSocket_ != INVALID_SOCKET_VALUE) {
         closesocket(listenSocket_);
@@ -100,30 +127,106 @@ void ServerNetwork::shutdown() {
 #endif
 }
 
-    // Replace the entire getPlayers function with this:
-std::vector<ServerPlayer*> ServerNetwork::getPlayers() {
-    std::vector<ServerPlayer*> result;
-    result.reserve(players_.size());
+bool ServerNetwork::enableSharedMemory() {
+#ifdef _WIN32
+    return false;
+#else
+    auto listener = std::make_unique<Shm::Listener>(Shm::nameForPort(port_));
+    if (!listener->initialize()) {
+        std::cerr << "[ServerNetwork] Failed to create shared memory segment "
+                  << listener->getName() << std::endl;
+        return false;
+    }
+    std::cout << "[ServerNetwork] Shared memory clients on " << listener->getName() << std::endl;
+    shmListener_ = std::move(listener);
+    return true;
+#endif
+}
 
+const std::vector<ServerPlayer*>& ServerNetwork::getPlayers() {
+    playerView_.clear();
     for (const auto& player : players_) {
-        // Push the raw pointer. Do NOT make_unique.
-        result.push_back(player.get());
+        playerView_.push_back(player.get());
     }
-    return result;
+    return playerView_;
 }
 
-void ServerNetwork::broadcast(const ByteBuffer& data) {
+void ServerNetwork::broadcast(ByteBuffer data, uint32_t roomId) {
     OutgoingPacket packet;
-    packet.data = data;
+    packet.data = std::move(data);
     packet.targetId = 0; // Broadcast
-    outgoingBuffer_.push(packet);
+    packet.roomId = roomId;
+    packet.closeAfter = false;
+    outgoingBuffer_.push(std::move(packet));
 }
 
-void ServerNetwork::send(PlayerID playerId, const ByteBuffer& data) {
+void ServerNetwork::send(PlayerID playerId, ByteBuffer data) {
     OutgoingPacket packet;
-    packet.data = data;
+    packet.data = std::move(data);
     packet.targetId = playerId;
-    outgoingBuffer_.push(packet);
+    packet.roomId = 0;
+    packet.closeAfter = false;
+    outgoingBuffer_.push(std::move(packet));
+}
+
+bool ServerNetwork::handOff(PlayerID playerId, const ByteBuffer& redirect) {
+    auto it = findPlayer(playerId);
+    if (it == players_.end()) return false;
+
+    if (onDisconnect_) {
+        onDisconnect_(**it);
+    }
+    livenessTimers_.cancel(playerId);
+    departing_.push_back(std::move(*it));
+    players_.erase(it);
+
+    OutgoingPacket packet;
+    packet.data = redirect;
+    packet.targetId = playerId;
+    packet.roomId = 0;
+    packet.closeAfter = true;
+    outgoingBuffer_.push(std::move(packet));
+    return true;
+}
+
+void ServerNetwork::adoptSession(uint64_t token, const PlayerState& state, SequenceID lastProcessedSeq,
+                                 uint32_t roomId) {
+    auto player = std::make_unique<ServerPlayer>(state.id);
+    player->getState() = state;
+    player->setLastProcessedSeq(lastProcessedSeq);
+    player->setSessionToken(token);
+    player->setRoomId(roomId);
+
+    ParkedSession& session = parked_[token];
+    session.player = std::move(player);
+    session.parkedAt = Clock::now();
+    session.respawn = false;
+    sessionTimers_.schedule(token, toWheelTick(session.parkedAt + std::chrono::milliseconds(SESSION_GRACE_MS)));
+}
+
+void ServerNetwork::parkSession(uint64_t token, PlayerID playerId, uint32_t score, uint32_t roomId) {
+    auto player = std::make_unique<ServerPlayer>(playerId);
+    player->setSessionToken(token);
+    player->setRoomId(roomId);
+    player->getState().score = score;
+
+    ParkedSession& session = parked_[token];
+    session.player = std::move(player);
+    session.parkedAt = Clock::now();
+    session.respawn = true;
+    sessionTimers_.schedule(token, toWheelTick(session.parkedAt + std::chrono::milliseconds(SESSION_GRACE_MS)));
+
+    // Never hand a restored id to a new player
+    nextPlayerId_ = std::max(nextPlayerId_, playerId + 1);
+}
+
+std::vector<const ServerPlayer*> ServerNetwork::getParkedPlayers() const {
+    std::vector<const ServerPlayer*> result;
+    result.reserve(parked_.size());
+    for (const auto& entry : parked_) {
+        result.push_back(entry.second.player.get());
+    }
+    return result;
 }
 
 void ServerNetwork::acceptNewClients() {
@@ -132,28 +235,172 @@ void ServerNetwork::acceptNewClients() {
 
     SocketType clientSocket = accept(listenSocket_,
         reinterpret_cast<sockaddr*>(&clientAddr), &clientLen);
+    traffic_.ioCalls.fetch_add(1, std::memory_order_relaxed);
 
     if (clientSocket != INVALID_SOCKET_VALUE) {
         setNonBlocking(clientSocket);
         setTcpNoDelay(clientSocket);
+        addPending(std::make_unique<SocketConnection>(clientSocket));
+    }
+
+    if (shmListener_) {
+        while (auto connection = shmListener_->accept()) {
+            addPending(std::move(connection));
+        }
+    }
+}
+
+void ServerNetwork::addPending(std::unique_ptr<Connection> connection) {
+    // The player is created (or resumed) once the handshake says which
+    PendingConnection pending;
+    pending.connection = std::move(connection);
+    pending.acceptedAt = Clock::now();
+    pending_.push_back(std::move(pending));
+}
+
+void ServerNetwork::receiveHandshakes() {
+    auto now = Clock::now();
+
+    for (auto it = pending_.begin(); it != pending_.end();) {
+        uint8_t buffer[256];
+        int received = it->connection->receive(buffer, sizeof(buffer));
+        traffic_.ioCalls.fetch_add(1, std::memory_order_relaxed);
+        if (received > 0) {
+            it->receiveBuffer.insert(it->receiveBuffer.end(), buffer, buffer + received);
+            traffic_.bytesIn.fetch_add(static_cast<uint64_t>(received), std::memory_order_relaxed);
+        }
+
+        bool failed = received < 0;
+        if (!failed && now - it->acceptedAt > std::chrono::milliseconds(HANDSHAKE_TIMEOUT_MS)) {
+            reapStats_.handshakeTimeouts++;
+            failed = true;
+        }
+
+        if (!failed && it->receiveBuffer.size() >= 7) {
+            ByteBuffer packet(it->receiveBuffer);
+            PacketHeader header = GameProtocol::deserializeHeader(packet);
+
+            if (header.type != PacketType::Handshake) {
+                failed = true;
+            } else if (it->receiveBuffer.size() >= 7u + header.payloadSize) {
+                std::unique_ptr<Connection> connection = std::move(it->connection);
+                uint32_t requestedRoom = 0;
+                uint64_t resumeToken = GameProtocol::deserializeHandshake(packet, requestedRoom);
+                std::vector<uint8_t> rest(it->receiveBuffer.begin() + 7 + header.payloadSize,
+                                          it->receiveBuffer.end());
+                it = pending_.erase(it);
+
+                // Anything sent right behind the handshake belongs to the player
+                ServerPlayer* player = completeHandshake(std::move(connection), resumeToken, requestedRoom);
+                if (player && !rest.empty()) {
+                    player->appendReceiveBuffer(rest.data(), rest.size());
+                    player->processPackets();
+                }
+                continue;
+            }
+        }
+
+        if (failed) {
+            it = pending_.erase(it); // closes the connection
+        } else {
+            ++it;
+        }
+    }
+}
 
-        PlayerID newId = nextPlayerId_++;
-        auto newPlayer = std::make_unique<ServerPlayer>(newId, clientSocket);
+ServerPlayer* ServerNetwork::completeHandshake(std::unique_ptr<Connection> connection,
+                                              uint64_t resumeToken, uint32_t requestedRoom) {
+    std::unique_ptr<ServerPlayer> player;
+    bool resumed = false;
 
-        // Random spawn position
-        float randX = 50.0f + static_cast<float>(std::rand() % static_cast<int>(WORLD_WIDTH - 100));
+    auto parked = resumeToken != 0 ? parked_.find(resumeToken) : parked_.end();
+    auto live = players_.end();
+    if (resumeToken != 0 && parked == parked_.end()) {
+        live = std::find_if(players_.begin(), players_.end(),
+            [resumeToken](const std::unique_ptr<ServerPlayer>& p) { return p->getSessionToken() == resumeToken; });
+    }
 
-        // Generate random Y between 50 and WORLD_HEIGHT - 50
-        float randY = 50.0f + static_cast<float>(std::rand() % static_cast<int>(WORLD_HEIGHT - 100));
+    if (live != players_.end()) {
+        // Back before its old socket was reaped: move the session over to
+        // the new one, which leaves and rejoins the room like a resume
+        LOG_INFO("ServerNetwork", "Client " << (*live)->getId() << " reconnected, closing its old connection");
+        if (onDisconnect_) {
+            onDisconnect_(**live);
+        }
+        livenessTimers_.cancel((*live)->getId());
+        player = std::move(*live);
+        players_.erase(live);
+        player->rebind(std::move(connection)); // drops the old connection
+        resumed = true;
+    } else if (parked != parked_.end()) {
+        // A resumed session goes back to the room it left
+        player = std::move(parked->second.player);
+        player->rebind(std::move(connection));
+        if (parked->second.respawn) {
+            player->getState().position = spawnPosition(player->getRoomId());
+        }
+        parked_.erase(parked);
+        sessionTimers_.cancel(resumeToken);
+        resumed = true;
+    } else {
+        uint32_t roomId = roomRouter_ ? roomRouter_(requestedRoom) : 1;
+        if (roomId == 0) {
+            LOG_WARN("ServerNetwork", "No room for client (asked for " << requestedRoom << "), closing");
+            connection->close();
+            return nullptr;
+        }
+
+        player = std::make_unique<ServerPlayer>(nextPlayerId_++, std::move(connection));
+        player->setSessionToken(newSessionToken());
+        player->setRoomId(roomId);
+
+        // Spawn position from the room's seeded generator
+        player->getState().position = spawnPosition(roomId);
+    }
 
-        newPlayer->getState().position = Vec2(randX, randY);
+    PlayerID playerId = player->getId();
+    uint64_t token = player->getSessionToken();
+    uint32_t roomId = player->getRoomId();
+    ServerPlayer& added = *player;
+    insertPlayer(std::move(player));
+    livenessTimers_.schedule(playerId, toWheelTick(Clock::now() + std::min(pingInterval_, idleTimeout_)));
 
-        players_.push_back(std::move(newPlayer));
+    LOG_INFO("ServerNetwork", "Client " << (resumed ? "resumed: " : "connected: ")
+             << playerId << " (room " << roomId << ")");
+    send(playerId, GameProtocol::serializeHandshakeResponse(0, playerId, token, resumed, roomId));
 
-        std::cout << "[ServerNetwork] Client connected: " << newId << std::endl;
-        ByteBuffer welcomePacket = GameProtocol::serializeHandshakeResponse(0, newId);
-        send(newId, welcomePacket);
+    if (onConnect_) {
+        onConnect_(added, resumed);
     }
+    return &added;
+}
+
+Vec2 ServerNetwork::spawnPosition(uint32_t roomId) {
+    return spawnPositionProvider_
+        ? spawnPositionProvider_(roomId)
+        : Vec2(WORLD_WIDTH / 2, WORLD_HEIGHT / 2);
+}
+
+void ServerNetwork::insertPlayer(std::unique_ptr<ServerPlayer> player) {
+    player->setSimulatedLatency(latencyMs_);
+    // Keep id order so resumed players land where replay puts them
+    auto pos = std::upper_bound(players_.begin(), players_.end(), player->getId(),
+        [](PlayerID id, const std::unique_ptr<ServerPlayer>& other) { return id < other->getId(); });
+    players_.insert(pos, std::move(player));
+}
+
+uint64_t ServerNetwork::newSessionToken() {
+    auto inUse = [this](uint64_t token) {
+        return parked_.count(token) != 0 ||
+               std::any_of(players_.begin(), players_.end(),
+                   [token](const std::unique_ptr<ServerPlayer>& p) { return p->getSessionToken() == token; });
+    };
+
+    uint64_t token = 0;
+    while (token == 0 || inUse(token)) {
+        token = (static_cast<uint64_t>(tokenSource_()) << 32) | tokenSource_();
+    }
+    return token;
 }
 
 void ServerNetwork::receiveFromClients() {
@@ -161,48 +408,151 @@ void ServerNetwork::receiveFromClients() {
         auto& player = *it;
 
         uint8_t buffer[1024];
-        int received = recv(player->getSocket(),
-                           reinterpret_cast<char*>(buffer), sizeof(buffer), 0);
+        int received = player->getConnection()->receive(buffer, sizeof(buffer));
+        traffic_.ioCalls.fetch_add(1, std::memory_order_relaxed);
 
         if (received > 0) {
             player->appendReceiveBuffer(buffer, received);
-            player->processPackets();
+            traffic_.bytesIn.fetch_add(static_cast<uint64_t>(received), std::memory_order_relaxed);
+            traffic_.packetsIn.fetch_add(player->processPackets(), std::memory_order_relaxed);
             ++it;
-        } else if (received == 0 ||
-                   (received < 0 && errno != EWOULDBLOCK && errno != EAGAIN)) {
-            std::cout << "[ServerNetwork] Client disconnected: "
-                      << player->getId() << std::endl;
-            it = players_.erase(it);
+        } else if (received < 0) {
+            LOG_INFO("ServerNetwork", "Client disconnected: " << player->getId());
+            reapStats_.closedByPeer++;
+            it = dropPlayer(it);
         } else {
             ++it;
         }
     }
 }
 
+std::vector<std::unique_ptr<ServerPlayer>>::iterator
+ServerNetwork::dropPlayer(std::vector<std::unique_ptr<ServerPlayer>>::iterator it) {
+    auto& player = *it;
+    LOG_INFO("ServerNetwork", "Parking player " << player->getId() << " for " << SESSION_GRACE_MS << " ms");
+    if (onDisconnect_) {
+        onDisconnect_(*player);
+    }
+    livenessTimers_.cancel(player->getId());
+
+    // Keep the state so a quick reconnect resumes it
+    player->rebind(nullptr);
+    uint64_t token = player->getSessionToken();
+    ParkedSession& session = parked_[token];
+    session.player = std::move(player);
+    session.parkedAt = Clock::now();
+    session.respawn = false;
+    sessionTimers_.schedule(token, toWheelTick(session.parkedAt + std::chrono::milliseconds(SESSION_GRACE_MS)));
+
+    return players_.erase(it);
+}
+
+std::vector<std::unique_ptr<ServerPlayer>>::iterator ServerNetwork::findPlayer(PlayerID playerId) {
+    auto it = std::lower_bound(players_.begin(), players_.end(), playerId,
+        [](const std::unique_ptr<ServerPlayer>& player, PlayerID id) { return player->getId() < id; });
+    return (it != players_.end() && (*it)->getId() == playerId) ? it : players_.end();
+}
+
+void ServerNetwork::runTimers() {
+    uint64_t now = toWheelTick(Clock::now());
+    livenessTimers_.advance(now, [this](uint64_t key) { checkLiveness(static_cast<PlayerID>(key)); });
+    sessionTimers_.advance(now, [this](uint64_t key) { expireSession(key); });
+}
+
+void ServerNetwork::checkLiveness(PlayerID playerId) {
+    auto it = findPlayer(playerId);
+    if (it == players_.end()) return;
+
+    ServerPlayer& player = **it;
+    auto now = Clock::now();
+
+    if (now - player.getLastInput() >= idleTimeout_) {
+        LOG_INFO("ServerNetwork", "Reaping idle client " << playerId);
+        reapStats_.idleTimeouts++;
+        dropPlayer(it);
+        return;
+    }
+
+    // Busy players are heard every tick and never get here with a silence
+    Clock::time_point next = player.getLastHeard() + pingInterval_;
+    if (now >= next) {
+        int missed = player.addMissedPing();
+        if (missed > maxMissedPings_) {
+            LOG_INFO("ServerNetwork", "Reaping unresponsive client " << playerId);
+            reapStats_.pingTimeouts++;
+            dropPlayer(it);
+            return;
+        }
+        send(playerId, GameProtocol::serializePing(static_cast<SequenceID>(missed)));
+        next = now + pingInterval_;
+    }
+
+    // The idle deadline may come first
+    next = std::min(next, player.getLastInput() + idleTimeout_);
+    livenessTimers_.schedule(playerId, toWheelTick(next));
+}
+
+void ServerNetwork::expireSession(uint64_t token) {
+    auto it = parked_.find(token);
+    if (it == parked_.end()) return;
+
+    LOG_INFO("ServerNetwork", "Session expired: " << it->second.player->getId());
+    reapStats_.sessionsExpired++;
+    parked_.erase(it);
+}
+
+uint64_t ServerNetwork::toWheelTick(Clock::time_point time) const {
+    // Round up so no timer fires early
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(time - timerEpoch_).count();
+    if (ms < 0) return 0;
+    return (static_cast<uint64_t>(ms) + TIMER_RESOLUTION_MS - 1) / TIMER_RESOLUTION_MS;
+}
+
 void ServerNetwork::sendToClients() {
     OutgoingPacket packet;
     while (outgoingBuffer_.popReady(packet)) {
         if (packet.targetId == 0) {
-            // Broadcast to all
+            // Broadcast to all (or to one room)
             for (auto& player : players_) {
-                ::send(player->getSocket(),
-                      reinterpret_cast<const char*>(packet.data.data()),
-                      packet.data.size(), 0);
+                if (packet.roomId != 0 && player->getRoomId() != packet.roomId) continue;
+                sendTo(*player, packet.data);
             }
-        } else {
+            // A handed-off player still gets what was queued before its redirect
+            for (auto& player : departing_) {
+                if (packet.roomId != 0 && player->getRoomId() != packet.roomId) continue;
+                sendTo(*player, packet.data);
+            }
+        } else if (!packet.closeAfter) {
             // Send to specific player
-            for (auto& player : players_) {
-                if (player->getId() == packet.targetId) {
-                    ::send(player->getSocket(),
-                          reinterpret_cast<const char*>(packet.data.data()),
-                          packet.data.size(), 0);
-                    break;
-                }
+            auto it = findPlayer(packet.targetId);
+            if (it != players_.end()) {
+                sendTo(**it, packet.data);
+            }
+        } else {
+            // Parting packet to a handed-off player, then hang up
+            auto it = std::find_if(departing_.begin(), departing_.end(),
+                [&packet](const std::unique_ptr<ServerPlayer>& player) { return player->getId() == packet.targetId; });
+            if (it != departing_.end()) {
+                sendTo(**it, packet.data);
+                departing_.erase(it); // closes the connection
             }
         }
     }
 }
 
+void ServerNetwork::sendTo(ServerPlayer& player, const ByteBuffer& data) {
+    Connection* connection = player.getConnection();
+    if (!connection) return;
+
+    traffic_.ioCalls.fetch_add(1, std::memory_order_relaxed);
+    if (connection->send(data.data(), data.size())) {
+        traffic_.bytesOut.fetch_add(data.size(), std::memory_order_relaxed);
+        traffic_.packetsOut.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        traffic_.sendFailures.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
 bool ServerNetwork::setNonBlocking(SocketType socket) {
 #ifdef _WIN32
     u_long mode = 1;
@@ -12,12 +12,20 @@
 #include <vector>
 #include <memory>
 #include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <functional>
+#include <random>
+#include <unordered_map>
 
+#include "Connection.hpp"
 #include "LagSimulator.hpp"
 #include "NetTypes.hpp"
+#include "ServerMetrics.hpp"
 #include "ServerPlayer.hpp"
 #include "Shared.hpp"
+#include "ShmTransport.hpp"
+#include "TimerWheel.hpp"
 
 
 
@@ -30,9 +38,20 @@ namespace CoinCollector {
     struct OutgoingPacket {
         ByteBuffer data;
         PlayerID targetId; // 0 = broadcast
+        uint32_t roomId;   // broadcast scope, 0 = every room
+        bool closeAfter;   // last packet for a departing connection
     };
     class ServerPlayer;
 
+    // Connections the server dropped on its own, by reason
+    struct ReapStats {
+        uint64_t closedByPeer = 0;      // socket closed or errored
+        uint64_t pingTimeouts = 0;      // silent past MAX_MISSED_PINGS pings
+        uint64_t idleTimeouts = 0;      // alive but no input for IDLE_TIMEOUT_MS
+        uint64_t handshakeTimeouts = 0; // accepted but never said hello
+        uint64_t sessionsExpired = 0;   // parked past SESSION_GRACE_MS
+    };
+
     class ServerNetwork {
     public:
         explicit ServerNetwork(uint16_t port);
@@ -42,24 +61,155 @@ namespace CoinCollector {
         void update();
         void shutdown();
 
-        std::vector<ServerPlayer*> getPlayers();
-        void broadcast(const ByteBuffer& data);
-        void send(PlayerID playerId, const ByteBuffer& data);
+        /**
+         * Also accept local clients over shared memory, on the segment
+         * named Shm::nameForPort(port); call after initialize()
+         */
+        bool enableSharedMemory();
+
+        // Valid until the next call; the vector is reused, not reallocated
+        const std::vector<ServerPlayer*>& getPlayers();
+        // Thread-safe; roomId limits a broadcast to one room's players.
+        // Passing a temporary moves its pooled buffer into the queue.
+        void broadcast(ByteBuffer data, uint32_t roomId = 0);
+        void send(PlayerID playerId, ByteBuffer data);
+
+        // Picks the room for a new player from the one it asked for (0 = any);
+        // returning 0 refuses the connection. Without a router everyone is in room 1.
+        void setRoomRouter(std::function<uint32_t(uint32_t requested)> router) {
+            roomRouter_ = std::move(router);
+        }
+
+        // Chooses where newly connected players appear in their room
+        void setSpawnPositionProvider(std::function<Vec2(uint32_t roomId)> provider) {
+            spawnPositionProvider_ = std::move(provider);
+        }
+
+        // Notified when a player joins (after spawn) or resumes, and when it drops.
+        // A dropped player is parked for SESSION_GRACE_MS and may come back.
+        void setConnectionCallbacks(std::function<void(ServerPlayer&, bool resumed)> onConnect,
+                                    std::function<void(const ServerPlayer&)> onDisconnect) {
+            onConnect_ = std::move(onConnect);
+            onDisconnect_ = std::move(onDisconnect);
+        }
+
+        /**
+         * Park a session restored from a checkpoint; it gets a fresh spawn
+         * position in the same room if its owner comes back within the
+         * grace period
+         */
+        void parkSession(uint64_t token, PlayerID playerId, uint32_t score, uint32_t roomId = 1);
+
+        /**
+         * Park a player handed over by another shard, keeping its position
+         * and input ack, until its client reconnects here with the token
+         */
+        void adoptSession(uint64_t token, const PlayerState& state, SequenceID lastProcessedSeq,
+                          uint32_t roomId = 1);
+
+        /**
+         * Send the player elsewhere: it leaves the simulation now (the
+         * disconnect callback runs) and its connection closes once the
+         * redirect packet is out. Returns false if the player is unknown.
+         */
+        bool handOff(PlayerID playerId, const ByteBuffer& redirect);
+
+        // New players get ids from base upward (sharded servers use disjoint blocks)
+        void setPlayerIdBase(PlayerID base) { nextPlayerId_ = std::max(nextPlayerId_, base); }
+
+        // Disconnected players still inside their grace period
+        std::vector<const ServerPlayer*> getParkedPlayers() const;
+
+        const ReapStats& getReapStats() const { return reapStats_; }
+
+        // Traffic counters are atomic and safe to read from any thread
+        const TrafficStats& getTrafficStats() const { return traffic_; }
+        size_t getPendingCount() const { return pending_.size(); }
+        size_t getParkedCount() const { return parked_.size(); }
+        size_t getOutgoingQueueDepth() const { return outgoingBuffer_.size(); }
+        bool isRunning() const { return running_; }
+
+        // Override PING_INTERVAL_MS / MAX_MISSED_PINGS / IDLE_TIMEOUT_MS for new checks
+        void setLivenessTimeouts(int pingIntervalMs, int maxMissedPings, int idleTimeoutMs) {
+            pingInterval_ = std::chrono::milliseconds(pingIntervalMs);
+            maxMissedPings_ = maxMissedPings;
+            idleTimeout_ = std::chrono::milliseconds(idleTimeoutMs);
+        }
+
+        // Override SIMULATED_LATENCY_MS for outgoing packets and the inputs of players added later
+        void setSimulatedLatency(int latencyMs) {
+            latencyMs_ = latencyMs;
+            outgoingBuffer_.setLatency(latencyMs);
+        }
 
     private:
+        using Clock = std::chrono::steady_clock;
+
+        // Accepted socket that has not sent its handshake yet
+        struct PendingConnection {
+            std::unique_ptr<Connection> connection;
+            std::vector<uint8_t> receiveBuffer;
+            Clock::time_point acceptedAt;
+        };
+
+        struct ParkedSession {
+            std::unique_ptr<ServerPlayer> player;
+            Clock::time_point parkedAt;
+            bool respawn = false; // restored without a position
+        };
+
         void acceptNewClients();
+        void receiveHandshakes();
+        void addPending(std::unique_ptr<Connection> connection);
+        ServerPlayer* completeHandshake(std::unique_ptr<Connection> connection, uint64_t resumeToken,
+                                        uint32_t requestedRoom);
+        void sendTo(ServerPlayer& player, const ByteBuffer& data);
+        Vec2 spawnPosition(uint32_t roomId);
         void receiveFromClients();
         void sendToClients();
-        void disconnectClient(PlayerID playerId);
+        void runTimers();
+        void checkLiveness(PlayerID playerId);
+        void expireSession(uint64_t token);
+        // Park the player for a possible resume and drop it from the simulation
+        std::vector<std::unique_ptr<ServerPlayer>>::iterator
+            dropPlayer(std::vector<std::unique_ptr<ServerPlayer>>::iterator it);
+        std::vector<std::unique_ptr<ServerPlayer>>::iterator findPlayer(PlayerID playerId);
+        void insertPlayer(std::unique_ptr<ServerPlayer> player);
+        uint64_t toWheelTick(Clock::time_point time) const;
+        uint64_t newSessionToken();
         bool setNonBlocking(SocketType socket);
         bool setTcpNoDelay(SocketType socket);
 
         uint16_t port_;
         SocketType listenSocket_;
-        std::vector<std::unique_ptr<ServerPlayer>> players_;
+        std::unique_ptr<Shm::Listener> shmListener_;
+        std::vector<std::unique_ptr<ServerPlayer>> players_; // sorted by id
+        std::vector<ServerPlayer*> playerView_; // getPlayers() result
+        std::vector<PendingConnection> pending_;
+        std::vector<std::unique_ptr<ServerPlayer>> departing_; // handed off, redirect in flight
+        std::unordered_map<uint64_t, ParkedSession> parked_; // by session token
         PlayerID nextPlayerId_;
 
+        // Liveness checks keyed by player id, session expiry keyed by token
+        static constexpr int TIMER_RESOLUTION_MS = 10;
+        Clock::time_point timerEpoch_;
+        TimerWheel livenessTimers_;
+        TimerWheel sessionTimers_;
+        ReapStats reapStats_;
+        TrafficStats traffic_;
+        std::chrono::milliseconds pingInterval_{PING_INTERVAL_MS};
+        int maxMissedPings_ = MAX_MISSED_PINGS;
+        std::chrono::milliseconds idleTimeout_{IDLE_TIMEOUT_MS};
+
+        int latencyMs_ = SIMULATED_LATENCY_MS;
         LatencyBuffer<OutgoingPacket> outgoingBuffer_;
+        std::function<uint32_t(uint32_t)> roomRouter_;
+        std::function<Vec2(uint32_t)> spawnPositionProvider_;
+        // Session tokens are bearer credentials, so every bit comes from the
+        // OS entropy source; a seeded PRNG could be recovered from one token
+        std::random_device tokenSource_;
+        std::function<void(ServerPlayer&, bool)> onConnect_;
+        std::function<void(const ServerPlayer&)> onDisconnect_;
 
         std::atomic<bool> running_;
     };
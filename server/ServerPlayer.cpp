@@ -9,21 +9,31 @@
 
 namespace CoinCollector {
 
-    ServerPlayer::ServerPlayer(PlayerID id, SocketType socket)
-        : socket_(socket), inputBuffer_(SIMULATED_LATENCY_MS), lastProcessedSeq_(0) {
+    ServerPlayer::ServerPlayer(PlayerID id, std::unique_ptr<Connection> connection)
+        : connection_(std::move(connection)), inputBuffer_(SIMULATED_LATENCY_MS), lastProcessedSeq_(0),
+          lastHeard_(std::chrono::steady_clock::now()), lastInput_(lastHeard_) {
         state_.id = id;
         receiveBuffer_.reserve(4096);
     }
 
+    void ServerPlayer::rebind(std::unique_ptr<Connection> connection) {
+        connection_ = std::move(connection);
+        receiveBuffer_.clear();
+        lastHeard_ = lastInput_ = std::chrono::steady_clock::now();
+        missedPings_ = 0;
+    }
+
     void ServerPlayer::appendReceiveBuffer(const uint8_t* data, size_t size) {
         receiveBuffer_.insert(receiveBuffer_.end(), data, data + size);
+        lastHeard_ = std::chrono::steady_clock::now();
+        missedPings_ = 0;
     }
 
-    void ServerPlayer::processPackets() {
+    size_t ServerPlayer::processPackets() {
+        size_t processed = 0;
         while (receiveBuffer_.size() >= 7) { // Minimum: header size
-            // Parse header
-            ByteBuffer headerBuf(std::vector<uint8_t>(
-                receiveBuffer_.begin(), receiveBuffer_.begin() + 7));
+            // Parse header (pooled copies, no heap allocation once warm)
+            ByteBuffer headerBuf(receiveBuffer_.data(), 7);
             PacketHeader header = GameProtocol::deserializeHeader(headerBuf);
 
             size_t totalSize = 7 + header.payloadSize;
@@ -32,10 +42,7 @@ namespace CoinCollector {
             }
 
             // Extract full packet
-            std::vector<uint8_t> packetData(
-                receiveBuffer_.begin() + 7,
-                receiveBuffer_.begin() + totalSize);
-            ByteBuffer payloadBuf(packetData);
+            ByteBuffer payloadBuf(receiveBuffer_.data() + 7, header.payloadSize);
 
             // Process based on type
             if (header.type == PacketType::Input) {
@@ -44,15 +51,21 @@ namespace CoinCollector {
                 InputPacket inputPacket;
                 inputPacket.sequenceId = header.sequenceId;
                 inputPacket.input = input;
+                if (payloadBuf.remaining() >= sizeof(uint32_t)) {
+                    inputPacket.viewTick = payloadBuf.readUint32();
+                }
 
                 // Push through latency buffer
                 inputBuffer_.push(inputPacket);
+                lastInput_ = lastHeard_;
             }
 
             // Remove processed packet from buffer
             receiveBuffer_.erase(receiveBuffer_.begin(),
                                 receiveBuffer_.begin() + totalSize);
+            processed++;
         }
+        return processed;
     }
 
     bool ServerPlayer::popInput(InputPacket& out) {
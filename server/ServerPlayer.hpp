@@ -9,7 +9,9 @@
 #pragma once
 #include <vector>
 #include <cstdint>
+#include <memory>
 
+#include "Connection.hpp"
 #include "LagSimulator.hpp"
 #include "Shared.hpp"
 
@@ -19,30 +21,62 @@ namespace CoinCollector {
     struct InputPacket {
         SequenceID sequenceId;
         InputState input;
+        uint32_t viewTick = 0; // newest server tick the client had seen when sending
     };
 
     class ServerPlayer {
     public:
-        ServerPlayer(PlayerID id, SocketType socket);
+        // No connection for replayed, parked or simulated players
+        explicit ServerPlayer(PlayerID id, std::unique_ptr<Connection> connection = nullptr);
 
         PlayerID getId() const { return state_.id; }
-        SocketType getSocket() const { return socket_; }
+        Connection* getConnection() const { return connection_.get(); }
+
+        // Attach a resumed session to its new connection (closes the old one)
+        void rebind(std::unique_ptr<Connection> connection);
         PlayerState& getState() { return state_; }
         const PlayerState& getState() const { return state_; }
 
         void appendReceiveBuffer(const uint8_t* data, size_t size);
-        void processPackets();
+        // Parses every complete packet; returns how many there were
+        size_t processPackets();
         bool popInput(InputPacket& out);
 
         void setLastProcessedSeq(SequenceID seq) { lastProcessedSeq_ = seq; }
         SequenceID getLastProcessedSeq() const { return lastProcessedSeq_; }
 
+        // Server tick the client was looking at for its last applied input
+        void setViewTick(uint32_t tick) { viewTick_ = tick; }
+        uint32_t getViewTick() const { return viewTick_; }
+
+        // Liveness: any bytes count as heard, only Input packets reset idleness
+        TimePoint getLastHeard() const { return lastHeard_; }
+        TimePoint getLastInput() const { return lastInput_; }
+        int addMissedPing() { return ++missedPings_; }
+
+        // Secret that lets this player's session be resumed (e.g. after a restart)
+        void setSessionToken(uint64_t token) { sessionToken_ = token; }
+        uint64_t getSessionToken() const { return sessionToken_; }
+
+        // Delay before a received input can be applied; SIMULATED_LATENCY_MS by default
+        void setSimulatedLatency(int latencyMs) { inputBuffer_.setLatency(latencyMs); }
+
+        // Room the player was routed to at handshake time
+        void setRoomId(uint32_t roomId) { roomId_ = roomId; }
+        uint32_t getRoomId() const { return roomId_; }
+
     private:
         PlayerState state_;
-        SocketType socket_;
+        std::unique_ptr<Connection> connection_;
         std::vector<uint8_t> receiveBuffer_;
         LatencyBuffer<InputPacket> inputBuffer_;
         SequenceID lastProcessedSeq_;
+        uint32_t viewTick_ = 0;
+        TimePoint lastHeard_;
+        TimePoint lastInput_;
+        int missedPings_ = 0;
+        uint64_t sessionToken_ = 0;
+        uint32_t roomId_ = 0;
     };
 
 } // namespace CoinCollector
@@ -0,0 +1,252 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "ShardLink.hpp"
+#include "Log.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace CoinCollector {
+
+namespace {
+    bool setNonBlocking(int socket) {
+        int flags = fcntl(socket, F_GETFL, 0);
+        if (flags == -1) return false;
+        return fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+    }
+
+    bool makeAddress(const std::string& path, sockaddr_un& addr) {
+        addr = sockaddr_un{};
+        addr.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(addr.sun_path)) return false;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        return true;
+    }
+}
+
+ShardLink::ShardLink(uint32_t index, uint32_t count, std::string socketPrefix)
+    : index_(index), count_(count), socketPrefix_(std::move(socketPrefix)),
+      listenSocket_(-1), peers_(count) {}
+
+ShardLink::~ShardLink() {
+    shutdown();
+}
+
+bool ShardLink::initialize() {
+    std::string path = socketPath(socketPrefix_, index_);
+    sockaddr_un addr;
+    if (!makeAddress(path, addr)) {
+        std::cerr << "[ShardLink] Socket path too long: " << path << std::endl;
+        return false;
+    }
+
+    listenSocket_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenSocket_ < 0) {
+        std::cerr << "[ShardLink] Failed to create socket" << std::endl;
+        return false;
+    }
+
+    // A crashed shard leaves its socket file behind
+    unlink(path.c_str());
+    if (bind(listenSocket_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        listen(listenSocket_, static_cast<int>(count_)) < 0 ||
+        !setNonBlocking(listenSocket_)) {
+        std::cerr << "[ShardLink] Failed to listen on " << path << ": " << std::strerror(errno) << std::endl;
+        close(listenSocket_);
+        listenSocket_ = -1;
+        return false;
+    }
+
+    std::cout << "[ShardLink] Shard " << index_ << "/" << count_ << " listening on " << path << std::endl;
+    return true;
+}
+
+void ShardLink::update() {
+    if (listenSocket_ < 0) return;
+
+    acceptPeers();
+    connectPeers();
+    identifyPeers();
+
+    for (uint32_t shard = 0; shard < count_; ++shard) {
+        Peer& peer = peers_[shard];
+        if (peer.socket < 0) continue;
+
+        if (!flush(peer) || !receive(peer.socket, peer.in)) {
+            dropPeer(shard);
+            continue;
+        }
+        dispatch(shard, peer);
+    }
+}
+
+void ShardLink::shutdown() {
+    for (auto& peer : peers_) {
+        if (peer.socket >= 0) close(peer.socket);
+        peer = Peer();
+    }
+    for (auto& link : unidentified_) {
+        close(link.socket);
+    }
+    unidentified_.clear();
+
+    if (listenSocket_ >= 0) {
+        close(listenSocket_);
+        listenSocket_ = -1;
+        unlink(socketPath(socketPrefix_, index_).c_str());
+    }
+}
+
+void ShardLink::send(uint32_t shard, const ByteBuffer& frame) {
+    if (shard >= count_ || shard == index_) return;
+    Peer& peer = peers_[shard];
+    // Nothing is queued for a peer that is down; its state is resent once it is back
+    if (peer.socket < 0) return;
+    peer.out.insert(peer.out.end(), frame.data(), frame.data() + frame.size());
+}
+
+void ShardLink::broadcast(const ByteBuffer& frame) {
+    for (uint32_t shard = 0; shard < count_; ++shard) {
+        send(shard, frame);
+    }
+}
+
+bool ShardLink::isConnected(uint32_t shard) const {
+    return shard < count_ && peers_[shard].socket >= 0;
+}
+
+size_t ShardLink::getConnectedCount() const {
+    return static_cast<size_t>(std::count_if(peers_.begin(), peers_.end(),
+                                             [](const Peer& peer) { return peer.socket >= 0; }));
+}
+
+void ShardLink::acceptPeers() {
+    for (;;) {
+        int socket = accept(listenSocket_, nullptr, nullptr);
+        if (socket < 0) return;
+        setNonBlocking(socket);
+        unidentified_.push_back({socket, {}});
+    }
+}
+
+void ShardLink::connectPeers() {
+    auto now = Clock::now();
+
+    // Lower shards are connected to, higher ones connect to us
+    for (uint32_t shard = 0; shard < index_; ++shard) {
+        Peer& peer = peers_[shard];
+        if (peer.socket >= 0 || now < peer.nextConnectAttempt) continue;
+        peer.nextConnectAttempt = now + std::chrono::milliseconds(CONNECT_RETRY_MS);
+
+        sockaddr_un addr;
+        if (!makeAddress(socketPath(socketPrefix_, shard), addr)) continue;
+
+        int socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (socket < 0) continue;
+        if (connect(socket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            close(socket); // not up yet
+            continue;
+        }
+        setNonBlocking(socket);
+
+        peer.socket = socket;
+        ByteBuffer hello = ShardProtocol::serializeHello(index_);
+        peer.out.assign(hello.data(), hello.data() + hello.size());
+        LOG_INFO("ShardLink", "Linked to shard " << shard);
+    }
+}
+
+void ShardLink::identifyPeers() {
+    for (auto it = unidentified_.begin(); it != unidentified_.end();) {
+        bool alive = receive(it->socket, it->in);
+
+        if (alive && it->in.size() >= ShardProtocol::FRAME_HEADER_SIZE + 4) {
+            ByteBuffer frame(it->in);
+            ShardMessage type = static_cast<ShardMessage>(frame.readUint8());
+            frame.readUint32();
+            uint32_t shard = ShardProtocol::deserializeHello(frame);
+
+            if (type == ShardMessage::Hello && shard > index_ && shard < count_) {
+                dropPeer(shard); // a restarted peer replaces its old link
+                Peer& peer = peers_[shard];
+                peer.socket = it->socket;
+                peer.in.assign(it->in.begin() + ShardProtocol::FRAME_HEADER_SIZE + 4, it->in.end());
+                LOG_INFO("ShardLink", "Linked to shard " << shard);
+                it = unidentified_.erase(it);
+                continue;
+            }
+            alive = false;
+        }
+
+        if (!alive) {
+            close(it->socket);
+            it = unidentified_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool ShardLink::receive(int socket, std::vector<uint8_t>& in) {
+    uint8_t buffer[8192];
+    for (;;) {
+        ssize_t received = recv(socket, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            in.insert(in.end(), buffer, buffer + received);
+        } else if (received == 0) {
+            return false;
+        } else {
+            return errno == EWOULDBLOCK || errno == EAGAIN;
+        }
+    }
+}
+
+bool ShardLink::flush(Peer& peer) {
+    while (!peer.out.empty()) {
+        ssize_t sent = ::send(peer.socket, peer.out.data(), peer.out.size(), MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno != EWOULDBLOCK && errno != EAGAIN) return false;
+            break;
+        }
+        peer.out.erase(peer.out.begin(), peer.out.begin() + sent);
+    }
+    return peer.out.size() <= MAX_QUEUED_BYTES;
+}
+
+void ShardLink::dispatch(uint32_t shard, Peer& peer) {
+    size_t offset = 0;
+    while (peer.in.size() - offset >= ShardProtocol::FRAME_HEADER_SIZE) {
+        ByteBuffer header(std::vector<uint8_t>(peer.in.begin() + offset,
+                                               peer.in.begin() + offset + ShardProtocol::FRAME_HEADER_SIZE));
+        ShardMessage type = static_cast<ShardMessage>(header.readUint8());
+        uint32_t length = header.readUint32();
+        size_t total = ShardProtocol::FRAME_HEADER_SIZE + length;
+        if (peer.in.size() - offset < total) break;
+
+        ByteBuffer payload(std::vector<uint8_t>(peer.in.begin() + offset + ShardProtocol::FRAME_HEADER_SIZE,
+                                                peer.in.begin() + offset + total));
+        offset += total;
+        if (handler_) {
+            handler_(shard, type, payload);
+        }
+    }
+    peer.in.erase(peer.in.begin(), peer.in.begin() + offset);
+}
+
+void ShardLink::dropPeer(uint32_t shard) {
+    Peer& peer = peers_[shard];
+    if (peer.socket < 0) return;
+
+    LOG_WARN("ShardLink", "Lost shard " << shard);
+    close(peer.socket);
+    peer = Peer();
+}
+
+} // namespace CoinCollector
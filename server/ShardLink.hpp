@@ -0,0 +1,119 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#ifndef KRAFTON_SHARDLINK_HPP
+#define KRAFTON_SHARDLINK_HPP
+
+
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "NetTypes.hpp"
+#include "ShardProtocol.hpp"
+#include "Shared.hpp"
+
+namespace CoinCollector {
+
+    /**
+     * Which shard owns which part of the world. The world is cut into
+     * equal vertical strips; shard i owns x in [minX(i), maxX(i)) and
+     * takes clients on basePort + i.
+     */
+    struct ShardMap {
+        uint32_t index = 0;
+        uint32_t count = 1;
+        uint16_t basePort = SERVER_PORT;
+
+        bool isSharded() const { return count > 1; }
+        float minX(uint32_t shard) const { return WORLD_WIDTH * shard / count; }
+        float maxX(uint32_t shard) const { return WORLD_WIDTH * (shard + 1) / count; }
+        uint16_t portOf(uint32_t shard) const { return static_cast<uint16_t>(basePort + shard); }
+
+        uint32_t ownerOf(float x) const {
+            if (x <= 0.0f) return 0;
+            return std::min(count - 1, static_cast<uint32_t>(x * count / WORLD_WIDTH));
+        }
+    };
+
+    /**
+     * Full mesh of Unix domain socket links between the shard processes
+     * on one machine
+     *
+     * Shard i listens on "<prefix>-<i>.sock" and connects to every lower
+     * shard, retrying until it is up, so each pair shares one link. The
+     * connecting side introduces itself with a Hello. Everything is
+     * non-blocking and driven from update(), like ServerNetwork.
+     */
+    class ShardLink {
+    public:
+        using MessageHandler = std::function<void(uint32_t fromShard, ShardMessage type, ByteBuffer& payload)>;
+
+        ShardLink(uint32_t index, uint32_t count, std::string socketPrefix);
+        ~ShardLink();
+
+        ShardLink(const ShardLink&) = delete;
+        ShardLink& operator=(const ShardLink&) = delete;
+
+        bool initialize();
+        // Accept, (re)connect, flush queued frames, receive and dispatch
+        void update();
+        void shutdown();
+
+        void send(uint32_t shard, const ByteBuffer& frame);
+        void broadcast(const ByteBuffer& frame);
+
+        bool isConnected(uint32_t shard) const;
+        size_t getConnectedCount() const;
+
+        void setMessageHandler(MessageHandler handler) { handler_ = std::move(handler); }
+
+        static std::string socketPath(const std::string& prefix, uint32_t shard) {
+            return prefix + "-" + std::to_string(shard) + ".sock";
+        }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Peer {
+            int socket = -1;
+            std::vector<uint8_t> in;
+            std::vector<uint8_t> out;
+            Clock::time_point nextConnectAttempt;
+        };
+
+        // Accepted link that has not said which shard it is yet
+        struct Unidentified {
+            int socket;
+            std::vector<uint8_t> in;
+        };
+
+        void acceptPeers();
+        void connectPeers();
+        void identifyPeers();
+        bool receive(int socket, std::vector<uint8_t>& in);
+        bool flush(Peer& peer);
+        void dispatch(uint32_t shard, Peer& peer);
+        void dropPeer(uint32_t shard);
+
+        // A peer this far behind on reading is treated as dead
+        static constexpr size_t MAX_QUEUED_BYTES = 1 << 20;
+        static constexpr int CONNECT_RETRY_MS = 200;
+
+        uint32_t index_;
+        uint32_t count_;
+        std::string socketPrefix_;
+        int listenSocket_;
+        std::vector<Peer> peers_; // by shard index; peers_[index_] unused
+        std::vector<Unidentified> unidentified_;
+        MessageHandler handler_;
+    };
+
+} // namespace CoinCollector
+
+#endif //KRAFTON_SHARDLINK_HPP
@@ -0,0 +1,167 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#ifndef KRAFTON_SHARDPROTOCOL_HPP
+#define KRAFTON_SHARDPROTOCOL_HPP
+#pragma once
+
+#include <vector>
+
+#include "NetTypes.hpp"
+#include "Shared.hpp"
+
+namespace CoinCollector {
+
+// Messages between shard processes (never sent to clients)
+enum class ShardMessage : uint8_t {
+    Hello = 1,       // first message on a link: sender's shard index
+    Ghosts = 2,      // sender's players and coins, mirrored by every peer
+    Handoff = 3,     // a player crossed into the receiver's strip
+    PickupClaim = 4, // a sender's player touched one of the receiver's coins
+    PickupGrant = 5  // the claim was valid; award the pickup
+};
+
+// A player moving between shards: enough to resume its session there
+struct HandoffState {
+    uint64_t sessionToken = 0;
+    PlayerState state;
+    SequenceID lastProcessedSeq = 0;
+};
+
+struct CoinClaim {
+    uint32_t coinId = 0;
+    Vec2 coinPosition; // where the claimer saw the coin
+    PlayerID playerId = 0;
+};
+
+/**
+ * Shard Protocol - framing and payloads for the shard IPC links.
+ * Frame: type (1) + payload length (4) + payload.
+ */
+class ShardProtocol {
+public:
+    static constexpr size_t FRAME_HEADER_SIZE = 5;
+
+    static ByteBuffer frame(ShardMessage type, const ByteBuffer& payload) {
+        ByteBuffer buffer(FRAME_HEADER_SIZE + payload.size());
+        buffer.writeUint8(static_cast<uint8_t>(type));
+        buffer.writeUint32(static_cast<uint32_t>(payload.size()));
+        for (size_t i = 0; i < payload.size(); ++i) {
+            buffer.writeUint8(payload.data()[i]);
+        }
+        return buffer;
+    }
+
+    static ByteBuffer serializeHello(uint32_t shardIndex) {
+        ByteBuffer payload(4);
+        payload.writeUint32(shardIndex);
+        return frame(ShardMessage::Hello, payload);
+    }
+
+    static uint32_t deserializeHello(ByteBuffer& buffer) {
+        return buffer.readUint32();
+    }
+
+    template <typename Players>
+    static ByteBuffer serializeGhosts(uint32_t tick, const Players& players,
+                                      const std::vector<CoinState>& coins) {
+        ByteBuffer payload;
+        payload.writeUint32(tick);
+        payload.writeUint16(static_cast<uint16_t>(players.size()));
+        for (const auto& player : players) {
+            payload.writeUint32(player.id);
+            payload.writeFloat(player.position.x);
+            payload.writeFloat(player.position.y);
+            payload.writeFloat(player.velocity.x);
+            payload.writeFloat(player.velocity.y);
+            payload.writeUint32(player.score);
+        }
+        payload.writeUint16(static_cast<uint16_t>(coins.size()));
+        for (const auto& coin : coins) {
+            payload.writeUint32(coin.id);
+            payload.writeFloat(coin.position.x);
+            payload.writeFloat(coin.position.y);
+            payload.writeBool(coin.active);
+        }
+        return frame(ShardMessage::Ghosts, payload);
+    }
+
+    static void deserializeGhosts(ByteBuffer& buffer, uint32_t& tick,
+                                  std::vector<PlayerState>& players, std::vector<CoinState>& coins) {
+        tick = buffer.readUint32();
+        players.resize(buffer.readUint16());
+        for (auto& player : players) {
+            player.id = buffer.readUint32();
+            player.position.x = buffer.readFloat();
+            player.position.y = buffer.readFloat();
+            player.velocity.x = buffer.readFloat();
+            player.velocity.y = buffer.readFloat();
+            player.score = buffer.readUint32();
+        }
+        coins.resize(buffer.readUint16());
+        for (auto& coin : coins) {
+            coin.id = buffer.readUint32();
+            coin.position.x = buffer.readFloat();
+            coin.position.y = buffer.readFloat();
+            coin.active = buffer.readBool();
+        }
+    }
+
+    static ByteBuffer serializeHandoff(const HandoffState& handoff) {
+        ByteBuffer payload(40);
+        payload.writeUint64(handoff.sessionToken);
+        payload.writeUint32(handoff.state.id);
+        payload.writeFloat(handoff.state.position.x);
+        payload.writeFloat(handoff.state.position.y);
+        payload.writeFloat(handoff.state.velocity.x);
+        payload.writeFloat(handoff.state.velocity.y);
+        payload.writeUint32(handoff.state.score);
+        payload.writeUint32(handoff.lastProcessedSeq);
+        return frame(ShardMessage::Handoff, payload);
+    }
+
+    static HandoffState deserializeHandoff(ByteBuffer& buffer) {
+        HandoffState handoff;
+        handoff.sessionToken = buffer.readUint64();
+        handoff.state.id = buffer.readUint32();
+        handoff.state.position.x = buffer.readFloat();
+        handoff.state.position.y = buffer.readFloat();
+        handoff.state.velocity.x = buffer.readFloat();
+        handoff.state.velocity.y = buffer.readFloat();
+        handoff.state.score = buffer.readUint32();
+        handoff.lastProcessedSeq = buffer.readUint32();
+        return handoff;
+    }
+
+    static ByteBuffer serializePickupClaim(const CoinClaim& claim) {
+        ByteBuffer payload(16);
+        payload.writeUint32(claim.coinId);
+        payload.writeFloat(claim.coinPosition.x);
+        payload.writeFloat(claim.coinPosition.y);
+        payload.writeUint32(claim.playerId);
+        return frame(ShardMessage::PickupClaim, payload);
+    }
+
+    static CoinClaim deserializePickupClaim(ByteBuffer& buffer) {
+        CoinClaim claim;
+        claim.coinId = buffer.readUint32();
+        claim.coinPosition.x = buffer.readFloat();
+        claim.coinPosition.y = buffer.readFloat();
+        claim.playerId = buffer.readUint32();
+        return claim;
+    }
+
+    static ByteBuffer serializePickupGrant(PlayerID playerId) {
+        ByteBuffer payload(4);
+        payload.writeUint32(playerId);
+        return frame(ShardMessage::PickupGrant, payload);
+    }
+
+    static PlayerID deserializePickupGrant(ByteBuffer& buffer) {
+        return buffer.readUint32();
+    }
+};
+
+} // namespace CoinCollector
+#endif //KRAFTON_SHARDPROTOCOL_HPP
@@ -0,0 +1,61 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "SpawnGenerator.hpp"
+#include "ServerPlayer.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace CoinCollector {
+
+    SpawnGenerator::SpawnGenerator(uint64_t seed) : seed_(seed), rng_(seed) {}
+
+    void SpawnGenerator::reseed(uint64_t seed) {
+        seed_ = seed;
+        rng_.reseed(seed);
+    }
+
+    Vec2 SpawnGenerator::coinPosition(const std::vector<ServerPlayer*>& players,
+                                      const std::vector<CoinState>& coins) {
+        return bestCandidate(COIN_RADIUS, players, coins);
+    }
+
+    Vec2 SpawnGenerator::playerPosition(const std::vector<ServerPlayer*>& players,
+                                        const std::vector<CoinState>& coins) {
+        return bestCandidate(PLAYER_RADIUS, players, coins);
+    }
+
+    Vec2 SpawnGenerator::bestCandidate(float radius,
+                                       const std::vector<ServerPlayer*>& players,
+                                       const std::vector<CoinState>& coins) {
+        Vec2 best;
+        float bestClearance = -std::numeric_limits<float>::max();
+
+        for (int i = 0; i < CANDIDATES; ++i) {
+            Vec2 candidate(rng_.nextRange(minX_ + radius, maxX_ - radius),
+                           rng_.nextRange(radius, WORLD_HEIGHT - radius));
+
+            // Clearance: gap to the nearest player or active coin edge
+            float clearance = std::numeric_limits<float>::max();
+            for (const auto* player : players) {
+                float gap = (player->getState().position - candidate).length() - PLAYER_RADIUS - radius;
+                clearance = std::min(clearance, gap);
+            }
+            for (const auto& coin : coins) {
+                if (!coin.active) continue;
+                float gap = (coin.position - candidate).length() - COIN_RADIUS - radius;
+                clearance = std::min(clearance, gap);
+            }
+
+            if (clearance > bestClearance) {
+                bestClearance = clearance;
+                best = candidate;
+            }
+        }
+
+        return best;
+    }
+
+} // namespace CoinCollector
@@ -0,0 +1,59 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#ifndef KRAFTON_SPAWNGENERATOR_HPP
+#define KRAFTON_SPAWNGENERATOR_HPP
+
+
+#pragma once
+#include <vector>
+#include <cstdint>
+
+#include "Random.hpp"
+#include "Shared.hpp"
+
+namespace CoinCollector {
+    class ServerPlayer;
+
+    /**
+     * Seeded spawn placement shared by all spawn logic of one world.
+     *
+     * Uses best-candidate sampling (an approximation of Poisson-disk
+     * sampling): several uniform candidates are drawn and the one farthest
+     * from every player and coin wins. Spawns are spread out like blue
+     * noise and never land on top of a player when there is room.
+     */
+    class SpawnGenerator {
+    public:
+        explicit SpawnGenerator(uint64_t seed);
+
+        void reseed(uint64_t seed);
+        uint64_t getSeed() const { return seed_; }
+
+        Vec2 coinPosition(const std::vector<ServerPlayer*>& players,
+                          const std::vector<CoinState>& coins);
+        Vec2 playerPosition(const std::vector<ServerPlayer*>& players,
+                            const std::vector<CoinState>& coins);
+
+        Pcg32& rng() { return rng_; }
+
+        // Horizontal strip spawns are confined to (the whole world by default)
+        void setBounds(float minX, float maxX) { minX_ = minX; maxX_ = maxX; }
+
+    private:
+        Vec2 bestCandidate(float radius,
+                           const std::vector<ServerPlayer*>& players,
+                           const std::vector<CoinState>& coins);
+
+        static constexpr int CANDIDATES = 16;
+
+        uint64_t seed_;
+        Pcg32 rng_;
+        float minX_ = 0.0f;
+        float maxX_ = WORLD_WIDTH;
+    };
+
+} // namespace CoinCollector
+
+#endif //KRAFTON_SPAWNGENERATOR_HPP
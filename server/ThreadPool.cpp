@@ -0,0 +1,83 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+#include <string>
+
+namespace CoinCollector {
+
+ThreadPool::ThreadPool(size_t workers) {
+    workers_.reserve(workers);
+    for (size_t i = 0; i < workers; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& fn) {
+    if (count == 0) return;
+    if (workers_.empty() || count == 1) {
+        for (size_t i = 0; i < count; ++i) fn(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &fn;
+        count_ = count;
+        next_.store(0, std::memory_order_relaxed);
+        active_ = workers_.size();
+        generation_++;
+    }
+    wake_.notify_all();
+
+    drain();
+
+    // Every worker must let go of the job before fn goes out of scope
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return active_ == 0; });
+    job_ = nullptr;
+}
+
+void ThreadPool::drain() {
+    size_t i;
+    while ((i = next_.fetch_add(1, std::memory_order_relaxed)) < count_) {
+        (*job_)(i);
+    }
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    Trace::setThreadName("worker " + std::to_string(index));
+
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this, seen] { return stopping_ || generation_ != seen; });
+            if (stopping_) return;
+            seen = generation_;
+        }
+
+        drain();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--active_ == 0) {
+            done_.notify_one();
+        }
+    }
+}
+
+} // namespace CoinCollector
@@ -0,0 +1,61 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#ifndef KRAFTON_THREADPOOL_HPP
+#define KRAFTON_THREADPOOL_HPP
+
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace CoinCollector {
+
+    /**
+     * Fixed set of worker threads for fork-join work such as ticking rooms
+     *
+     * parallelFor() hands indices out through an atomic counter, so cheap
+     * and expensive items balance across workers. The calling thread
+     * works too and returns once every index is done.
+     */
+    class ThreadPool {
+    public:
+        // 0 workers runs everything on the calling thread
+        explicit ThreadPool(size_t workers);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        void parallelFor(size_t count, const std::function<void(size_t)>& fn);
+
+        size_t getWorkerCount() const { return workers_.size(); }
+
+    private:
+        void workerLoop(size_t index);
+        void drain();
+
+        std::vector<std::thread> workers_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+
+        // Current job; a new generation wakes the workers
+        const std::function<void(size_t)>* job_ = nullptr;
+        size_t count_ = 0;
+        std::atomic<size_t> next_{0};
+        size_t active_ = 0;
+        uint64_t generation_ = 0;
+        bool stopping_ = false;
+    };
+
+} // namespace CoinCollector
+
+#endif //KRAFTON_THREADPOOL_HPP
@@ -0,0 +1,130 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "TimerWheel.hpp"
+
+namespace CoinCollector {
+
+TimerWheel::TimerWheel(uint64_t now) : now_(now) {
+    for (auto& level : slots_) {
+        level.fill(NIL);
+    }
+}
+
+void TimerWheel::schedule(uint64_t key, uint64_t deadline) {
+    uint32_t index;
+    auto it = byKey_.find(key);
+    if (it != byKey_.end()) {
+        index = it->second;
+        unlink(index);
+    } else if (!free_.empty()) {
+        index = free_.back();
+        free_.pop_back();
+        byKey_[key] = index;
+    } else {
+        index = static_cast<uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+        byKey_[key] = index;
+    }
+
+    Node& node = nodes_[index];
+    node.key = key;
+    // The current tick's slot has already run
+    node.deadline = deadline > now_ ? deadline : now_ + 1;
+    file(index);
+}
+
+bool TimerWheel::cancel(uint64_t key) {
+    auto it = byKey_.find(key);
+    if (it == byKey_.end()) return false;
+
+    uint32_t index = it->second;
+    bool armed = nodes_[index].head != nullptr;
+    unlink(index);
+    release(index);
+    return armed;
+}
+
+void TimerWheel::advance(uint64_t now, const std::function<void(uint64_t)>& onExpire) {
+    while (now_ < now) {
+        uint64_t tick = ++now_;
+
+        // Cascade from the top down when a lower level wraps
+        for (int level = LEVELS - 1; level > 0; --level) {
+            uint64_t lowMask = (uint64_t(1) << (SLOT_BITS * level)) - 1;
+            if ((tick & lowMask) != 0) continue;
+
+            uint32_t& head = slots_[level][(tick >> (SLOT_BITS * level)) & (SLOTS - 1)];
+            while (head != NIL) {
+                uint32_t index = head;
+                unlink(index);
+                file(index);
+            }
+        }
+
+        // Pop one at a time so callbacks may cancel anything still queued here
+        uint32_t& head = slots_[0][tick & (SLOTS - 1)];
+        while (head != NIL) {
+            uint32_t index = head;
+            unlink(index);
+            if (nodes_[index].deadline > tick) {
+                file(index); // clamped far-future timer, not due yet
+                continue;
+            }
+            // Keep the key's node through the callback: re-arming it from
+            // there (the usual case) then costs no map insertion
+            uint64_t key = nodes_[index].key;
+            onExpire(key);
+            auto it = byKey_.find(key);
+            if (it != byKey_.end() && it->second == index && nodes_[index].head == nullptr) {
+                release(index);
+            }
+        }
+    }
+}
+
+void TimerWheel::file(uint32_t index) {
+    Node& node = nodes_[index];
+    uint64_t delta = node.deadline > now_ ? node.deadline - now_ : 0;
+
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+        ++level;
+    }
+
+    // Beyond the top level's span: park in the farthest slot and re-file on cascade
+    uint64_t target = node.deadline;
+    uint64_t span = uint64_t(1) << (SLOT_BITS * LEVELS);
+    if (delta >= span) {
+        target = now_ + span - 1;
+    }
+
+    uint32_t* head = &slots_[level][(target >> (SLOT_BITS * level)) & (SLOTS - 1)];
+    node.head = head;
+    node.prev = NIL;
+    node.next = *head;
+    if (*head != NIL) nodes_[*head].prev = index;
+    *head = index;
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    Node& node = nodes_[index];
+    if (node.prev != NIL) {
+        nodes_[node.prev].next = node.next;
+    } else if (node.head) {
+        *node.head = node.next;
+    }
+    if (node.next != NIL) {
+        nodes_[node.next].prev = node.prev;
+    }
+    node.prev = node.next = NIL;
+    node.head = nullptr;
+}
+
+void TimerWheel::release(uint32_t index) {
+    byKey_.erase(nodes_[index].key);
+    free_.push_back(index);
+}
+
+} // namespace CoinCollector
@@ -0,0 +1,81 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#ifndef KRAFTON_TIMERWHEEL_HPP
+#define KRAFTON_TIMERWHEEL_HPP
+
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace CoinCollector {
+
+    /**
+     * Hierarchical timer wheel keyed by a caller-chosen id
+     *
+     * Four levels of 64 slots; level n slots span 64^n wheel ticks, so
+     * deadlines up to 16M ticks ahead are covered. Scheduling and
+     * cancelling are O(1), and advancing one tick touches a single slot
+     * (plus an occasional cascade), however many timers are pending.
+     * Timers far enough out to be cascaded are re-filed closer to their
+     * deadline; nothing fires early.
+     */
+    class TimerWheel {
+    public:
+        explicit TimerWheel(uint64_t now = 0);
+
+        // Slot lists are referenced by address
+        TimerWheel(const TimerWheel&) = delete;
+        TimerWheel& operator=(const TimerWheel&) = delete;
+
+        // Arm (or re-arm) the timer for key; deadlines in the past fire on the next tick
+        void schedule(uint64_t key, uint64_t deadline);
+        bool cancel(uint64_t key);
+        bool isScheduled(uint64_t key) const {
+            auto it = byKey_.find(key);
+            return it != byKey_.end() && nodes_[it->second].head != nullptr;
+        }
+
+        /**
+         * Run every timer due up to and including now. The callback may
+         * schedule or cancel timers, including the one that fired.
+         */
+        void advance(uint64_t now, const std::function<void(uint64_t key)>& onExpire);
+
+        uint64_t getNow() const { return now_; }
+        size_t size() const { return byKey_.size(); }
+
+    private:
+        static constexpr int LEVELS = 4;
+        static constexpr int SLOT_BITS = 6;
+        static constexpr uint32_t SLOTS = 1u << SLOT_BITS;
+        static constexpr uint32_t NIL = UINT32_MAX;
+
+        struct Node {
+            uint64_t key = 0;
+            uint64_t deadline = 0;
+            uint32_t prev = NIL;
+            uint32_t next = NIL;
+            uint32_t* head = nullptr; // slot list this node is on
+        };
+
+        void file(uint32_t index);
+        void unlink(uint32_t index);
+        void release(uint32_t index);
+
+        std::vector<Node> nodes_;
+        std::vector<uint32_t> free_;
+        std::unordered_map<uint64_t, uint32_t> byKey_;
+        std::array<std::array<uint32_t, SLOTS>, LEVELS> slots_;
+        uint64_t now_;
+    };
+
+} // namespace CoinCollector
+
+#endif //KRAFTON_TIMERWHEEL_HPP
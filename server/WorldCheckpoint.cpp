@@ -0,0 +1,276 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "WorldCheckpoint.hpp"
+#include "Log.hpp"
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#ifndef _WIN32
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+namespace CoinCollector {
+
+namespace {
+    constexpr size_t HEADER_SIZE = 4 + 2 + 4 + 4 + 4;
+    constexpr size_t SESSION_SIZE = 8 + 4 + 4;
+    constexpr size_t COIN_SIZE = 4 + 4 + 4 + 1;
+    constexpr size_t TRAILER_SIZE = 8;
+
+    uint64_t fnv1a(const uint8_t* data, size_t size) {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= data[i];
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    // Bounds-checked little-endian reads straight from the mapping; like
+    // ByteBuffer, a read past the end returns 0 and does not advance
+    class MappedReader {
+    public:
+        MappedReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+        uint8_t u8() {
+            if (remaining() < 1) return 0;
+            return data_[pos_++];
+        }
+        uint16_t u16() {
+            if (remaining() < 2) return 0;
+            uint16_t v = data_[pos_] | (data_[pos_ + 1] << 8);
+            pos_ += 2;
+            return v;
+        }
+        uint32_t u32() {
+            if (remaining() < 4) return 0;
+            uint32_t v = static_cast<uint32_t>(data_[pos_]) |
+                         (static_cast<uint32_t>(data_[pos_ + 1]) << 8) |
+                         (static_cast<uint32_t>(data_[pos_ + 2]) << 16) |
+                         (static_cast<uint32_t>(data_[pos_ + 3]) << 24);
+            pos_ += 4;
+            return v;
+        }
+        uint64_t u64() {
+            if (remaining() < 8) return 0;
+            uint64_t lo = u32();
+            uint64_t hi = u32();
+            return lo | (hi << 32);
+        }
+        float f32() { uint32_t bits = u32(); float v; std::memcpy(&v, &bits, sizeof(v)); return v; }
+
+        size_t remaining() const { return size_ - pos_; }
+
+    private:
+        const uint8_t* data_;
+        size_t size_;
+        size_t pos_ = 0;
+    };
+
+    bool decode(const uint8_t* data, size_t size, WorldCheckpoint& out) {
+        if (size < HEADER_SIZE + TRAILER_SIZE) return false;
+
+        MappedReader trailer(data + size - TRAILER_SIZE, TRAILER_SIZE);
+        if (trailer.u64() != fnv1a(data, size - TRAILER_SIZE)) return false;
+
+        MappedReader reader(data, size - TRAILER_SIZE);
+        if (reader.u32() != WorldCheckpoint::MAGIC) return false;
+        if (reader.u16() != WorldCheckpoint::VERSION) return false;
+
+        WorldCheckpoint checkpoint;
+        checkpoint.tick = reader.u32();
+        uint32_t sessionCount = reader.u32();
+        uint32_t coinCount = reader.u32();
+
+        if (reader.remaining() != sessionCount * SESSION_SIZE + coinCount * COIN_SIZE) {
+            return false;
+        }
+
+        checkpoint.sessions.resize(sessionCount);
+        for (auto& session : checkpoint.sessions) {
+            session.token = reader.u64();
+            session.playerId = reader.u32();
+            session.score = reader.u32();
+        }
+
+        checkpoint.coins.resize(coinCount);
+        for (auto& coin : checkpoint.coins) {
+            coin.id = reader.u32();
+            coin.position.x = reader.f32();
+            coin.position.y = reader.f32();
+            coin.active = reader.u8() != 0;
+        }
+
+        out = std::move(checkpoint);
+        return true;
+    }
+}
+
+void WorldCheckpoint::encode(ByteBuffer& buffer) const {
+    buffer.clear();
+    buffer.writeUint32(MAGIC);
+    buffer.writeUint16(VERSION);
+    buffer.writeUint32(tick);
+    buffer.writeUint32(static_cast<uint32_t>(sessions.size()));
+    buffer.writeUint32(static_cast<uint32_t>(coins.size()));
+
+    for (const auto& session : sessions) {
+        buffer.writeUint64(session.token);
+        buffer.writeUint32(session.playerId);
+        buffer.writeUint32(session.score);
+    }
+
+    for (const auto& coin : coins) {
+        buffer.writeUint32(coin.id);
+        buffer.writeFloat(coin.position.x);
+        buffer.writeFloat(coin.position.y);
+        buffer.writeBool(coin.active);
+    }
+
+    buffer.writeUint64(fnv1a(buffer.data(), buffer.size()));
+}
+
+bool WorldCheckpoint::load(const std::string& path, WorldCheckpoint& out) {
+#ifdef _WIN32
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return false;
+    std::vector<uint8_t> bytes;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        bytes.insert(bytes.end(), chunk, chunk + n);
+    }
+    std::fclose(file);
+    return decode(bytes.data(), bytes.size(), out);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) return false;
+
+    bool ok = decode(static_cast<const uint8_t*>(mapping), size, out);
+    munmap(mapping, size);
+    return ok;
+#endif
+}
+
+CheckpointWriter::~CheckpointWriter() {
+    stop();
+}
+
+void CheckpointWriter::start(const std::string& path) {
+    stop();
+    path_ = path;
+    stopping_ = false;
+    writer_ = std::thread(&CheckpointWriter::writerLoop, this);
+}
+
+void CheckpointWriter::stop() {
+    if (!writer_.joinable()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    writer_.join();
+}
+
+void CheckpointWriter::submit(const WorldCheckpoint& checkpoint) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        checkpoint.encode(pending_);
+        hasPending_ = true;
+    }
+    wake_.notify_one();
+}
+
+uint64_t CheckpointWriter::checkpointsWritten() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return written_;
+}
+
+void CheckpointWriter::writerLoop() {
+    ByteBuffer writing;
+
+    for (;;) {
+        bool stopping;
+        bool hasData;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this] { return stopping_ || hasPending_; });
+            std::swap(writing, pending_);
+            hasData = hasPending_;
+            hasPending_ = false;
+            stopping = stopping_;
+        }
+
+        // The final checkpoint queued before stop() is still written
+        if (hasData && writeAtomically(writing)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            written_++;
+        }
+
+        if (stopping) break;
+    }
+}
+
+bool CheckpointWriter::writeAtomically(const ByteBuffer& data) {
+    std::string tempPath = path_ + ".tmp";
+
+    std::FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if (!file) {
+        LOG_ERROR("Checkpoint", "Cannot open " << tempPath);
+        return false;
+    }
+
+    bool ok = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    ok = (std::fflush(file) == 0) && ok;
+#ifndef _WIN32
+    ok = (fsync(fileno(file)) == 0) && ok;
+#endif
+    std::fclose(file);
+
+    if (!ok) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+#ifdef _WIN32
+    std::remove(path_.c_str());
+#endif
+    if (std::rename(tempPath.c_str(), path_.c_str()) != 0) {
+        LOG_ERROR("Checkpoint", "Rename failed for " << path_);
+        return false;
+    }
+
+#ifndef _WIN32
+    // Persist the rename itself
+    std::string dir = ".";
+    size_t slash = path_.find_last_of('/');
+    if (slash != std::string::npos) {
+        dir = slash == 0 ? "/" : path_.substr(0, slash);
+    }
+    int dirFd = ::open(dir.c_str(), O_RDONLY);
+    if (dirFd >= 0) {
+        fsync(dirFd);
+        ::close(dirFd);
+    }
+#endif
+    return true;
+}
+
+} // namespace CoinCollector
@@ -0,0 +1,93 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#ifndef KRAFTON_WORLDCHECKPOINT_HPP
+#define KRAFTON_WORLDCHECKPOINT_HPP
+
+
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "NetTypes.hpp"
+#include "Shared.hpp"
+
+namespace CoinCollector {
+
+    /**
+     * Compact snapshot of the world that survives a server restart
+     *
+     * Layout (little-endian):
+     *   magic u32, version u16, tick u32, session count u32, coin count u32
+     *   session: token u64, player id u32, score u32
+     *   coin:    id u32, x f32, y f32, active u8
+     *   trailer: FNV-1a of everything above, u64
+     */
+    struct WorldCheckpoint {
+        struct Session {
+            uint64_t token = 0;
+            PlayerID playerId = 0;
+            uint32_t score = 0;
+        };
+
+        uint32_t tick = 0;
+        std::vector<Session> sessions;
+        std::vector<CoinState> coins;
+
+        static constexpr uint32_t MAGIC = 0x4b434343; // "CCCK"
+        static constexpr uint16_t VERSION = 1;
+
+        void encode(ByteBuffer& buffer) const;
+
+        /**
+         * Map the file and decode it. Fails on a missing, truncated or
+         * corrupt checkpoint, leaving out untouched.
+         */
+        static bool load(const std::string& path, WorldCheckpoint& out);
+    };
+
+    /**
+     * Writes checkpoints off the tick thread. Each write goes to a
+     * temporary file which is fsynced and renamed over the previous
+     * checkpoint, so a crash never leaves a half-written file behind.
+     * Only the newest pending checkpoint is kept.
+     */
+    class CheckpointWriter {
+    public:
+        CheckpointWriter() = default;
+        ~CheckpointWriter();
+
+        CheckpointWriter(const CheckpointWriter&) = delete;
+        CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+        void start(const std::string& path);
+        void stop();
+        bool isRunning() const { return writer_.joinable(); }
+
+        // Queue a checkpoint; replaces one that has not been written yet
+        void submit(const WorldCheckpoint& checkpoint);
+
+        uint64_t checkpointsWritten() const;
+
+    private:
+        void writerLoop();
+        bool writeAtomically(const ByteBuffer& data);
+
+        std::string path_;
+        std::thread writer_;
+        mutable std::mutex mutex_;
+        std::condition_variable wake_;
+        ByteBuffer pending_;
+        bool hasPending_ = false;
+        bool stopping_ = false;
+        uint64_t written_ = 0;
+    };
+
+} // namespace CoinCollector
+
+#endif //KRAFTON_WORLDCHECKPOINT_HPP
@@ -0,0 +1,309 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "../include/Allocators.hpp"
+#include "../include/GameProtocol.hpp"
+#include "../include/LagSimulator.hpp"
+#include "../include/NetTypes.hpp"
+#include "../server/GameServer.hpp"
+#include "../client/ClientNetwork.hpp"
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+
+using namespace CoinCollector;
+
+static const uint16_t TEST_PORT = 39311;
+
+// Heap allocations made by threads that opted in, while armed
+static std::atomic<bool> countingArmed(false);
+static std::atomic<uint64_t> countedAllocations(0);
+static thread_local bool countThisThread = false;
+
+void* operator new(size_t size) {
+    if (countThisThread && countingArmed.load(std::memory_order_relaxed)) {
+        countedAllocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void* block = std::malloc(size == 0 ? 1 : size)) return block;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* block) noexcept {
+    std::free(block);
+}
+
+void operator delete[](void* block) noexcept {
+    std::free(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+    std::free(block);
+}
+
+void operator delete[](void* block, size_t) noexcept {
+    std::free(block);
+}
+
+void testFrameArena() {
+    std::cout << "Test: Frame arena bumps, spills and settles into one block..." << std::endl;
+
+    FrameArena arena(256);
+    auto* a = static_cast<uint8_t*>(arena.allocate(3, 1));
+    auto* b = static_cast<uint64_t*>(arena.allocate(sizeof(uint64_t), alignof(uint64_t)));
+    assert(reinterpret_cast<uintptr_t>(b) % alignof(uint64_t) == 0);
+    assert(reinterpret_cast<uint8_t*>(b) > a);
+
+    // A frame bigger than the block spills, then the block grows to fit it
+    for (int i = 0; i < 10; ++i) {
+        arena.allocate(100, 8);
+    }
+    assert(arena.getUsed() > 256);
+    arena.reset();
+    assert(arena.getUsed() == 0);
+    size_t grown = arena.getCapacity();
+    assert(grown > 1000);
+
+    for (int frame = 0; frame < 5; ++frame) {
+        ArenaVector<PlayerState> players{ArenaAllocator<PlayerState>(arena)};
+        players.reserve(20);
+        for (PlayerID id = 1; id <= 20; ++id) {
+            players.emplace_back(id, Vec2(1.0f, 2.0f));
+        }
+        assert(players.back().id == 20);
+        arena.reset();
+        assert(arena.getCapacity() == grown);
+    }
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testPooledByteBuffer() {
+    std::cout << "Test: Byte buffers recycle pool blocks across copies and moves..." << std::endl;
+
+    {
+        ByteBuffer warm(500);
+        ByteBuffer warmCopy(warm);
+    }
+    uint64_t heapBlocks = BufferPool::instance().getHeapBlocks();
+
+    for (int i = 0; i < 100; ++i) {
+        ByteBuffer buffer;
+        for (uint32_t v = 0; v < 100; ++v) {
+            buffer.writeUint32(v); // grows through the small classes
+        }
+        ByteBuffer copy(buffer);
+        ByteBuffer moved(std::move(copy));
+        assert(copy.size() == 0 && copy.data() == nullptr);
+        assert(moved.size() == 400);
+        for (uint32_t v = 0; v < 100; ++v) {
+            assert(moved.readUint32() == v);
+        }
+        assert(moved.remaining() == 0);
+
+        copy = buffer;
+        assert(copy.size() == 400 && copy.data() != buffer.data());
+    }
+    // Only the growth steps not taken before were new
+    assert(BufferPool::instance().getHeapBlocks() - heapBlocks <= 8);
+
+    uint64_t settled = BufferPool::instance().getHeapBlocks();
+    for (int i = 0; i < 100; ++i) {
+        ByteBuffer buffer;
+        for (uint32_t v = 0; v < 100; ++v) buffer.writeUint32(v);
+        ByteBuffer copy(buffer);
+    }
+    assert(BufferPool::instance().getHeapBlocks() == settled);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testLatencyRing() {
+    std::cout << "Test: Latency buffer keeps order across wraps and growth..." << std::endl;
+
+    LatencyBuffer<int> buffer(0);
+    int next = 0;
+    int expected = 0;
+    for (int round = 0; round < 50; ++round) {
+        // Uneven bursts wrap the ring and grow it while items are queued
+        for (int i = 0; i < 1 + (round * 7) % 40; ++i) {
+            buffer.push(next++);
+        }
+        int out = -1;
+        for (int i = 0; i < 1 + (round * 5) % 30 && buffer.popReady(out); ++i) {
+            assert(out == expected++);
+        }
+    }
+    int out = -1;
+    while (buffer.popReady(out)) {
+        assert(out == expected++);
+    }
+    assert(expected == next && buffer.size() == 0);
+
+    buffer.push(1);
+    buffer.clear();
+    assert(buffer.size() == 0 && !buffer.popReady(out));
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testWorldStatesAreDoubleBuffered() {
+    std::cout << "Test: Client world states cycle through the latency queue without allocating..." << std::endl;
+
+    std::vector<PlayerState> players;
+    std::vector<CoinState> coins;
+    for (PlayerID id = 1; id <= 32; ++id) players.emplace_back(id, Vec2(1.0f, 1.0f));
+    for (uint32_t id = 0; id < MAX_COINS; ++id) coins.emplace_back(id, Vec2(2.0f, 2.0f), true);
+
+    // ClientNetwork's pipeline: deserialize into a queue slot, swap out into the client's packet
+    LatencyBuffer<WorldStatePacket> queue(0);
+    WorldStatePacket latest;
+    std::vector<CoinState> shownCoins;
+    auto frame = [&](uint32_t tick) {
+        ByteBuffer packet = GameProtocol::serializeWorldState(tick, tick, players, coins);
+        GameProtocol::deserializeHeader(packet);
+        queue.emplace([&packet](WorldStatePacket& state) {
+            GameProtocol::deserializeWorldState(packet, state.tick, state.players, state.coins);
+        });
+        // Every third frame the client is late and two states queue up
+        if (tick % 3 == 0) return;
+        while (queue.swapReady(latest)) {
+            assert(latest.players.size() == players.size());
+            shownCoins.swap(latest.coins);
+        }
+    };
+
+    uint32_t tick = 1;
+    for (; tick < 50; ++tick) frame(tick);
+
+    countThisThread = true;
+    countingArmed = true;
+    for (; tick < 500; ++tick) frame(tick);
+    countingArmed = false;
+    countThisThread = false;
+
+    assert(countedAllocations.load() == 0);
+    assert(shownCoins.size() == coins.size());
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+struct Client {
+    SocketType socket = INVALID_SOCKET_VALUE;
+    bool joined = false;
+    std::vector<uint8_t> received;
+};
+
+static Client connectClient() {
+    Client client;
+    client.socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(TEST_PORT);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    assert(connect(client.socket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    fcntl(client.socket, F_SETFL, fcntl(client.socket, F_GETFL, 0) | O_NONBLOCK);
+
+    ByteBuffer request = GameProtocol::serializeHandshake(0, 0, 0);
+    assert(send(client.socket, request.data(), request.size(), 0) == static_cast<ssize_t>(request.size()));
+    return client;
+}
+
+// Drain what the server sent; the first bytes back are the handshake response
+static void drain(Client& client) {
+    uint8_t buffer[8192];
+    ssize_t n;
+    while ((n = recv(client.socket, buffer, sizeof(buffer), 0)) > 0) {
+        client.joined = true;
+    }
+}
+
+void testSteadyTicksDoNotAllocate() {
+    std::cout << "Test: Steady-state server ticks make no heap allocations..." << std::endl;
+
+    const int clientCount = 16;
+    GameServer server(TEST_PORT, 5);
+    server.setSimulatedLatency(50);
+    assert(server.start());
+
+    std::atomic<bool> running(true);
+    std::thread loop([&] {
+        countThisThread = true;
+        server.run(running);
+    });
+
+    // The server accepts one connection per tick
+    std::vector<Client> clients;
+    for (int i = 0; i < clientCount; ++i) {
+        clients.push_back(connectClient());
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    // Every client sends one input per tick, nudging its player up and down
+    SequenceID seq = 0;
+    auto runFor = [&](std::chrono::milliseconds duration) {
+        auto until = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < until) {
+            seq++;
+            InputState input;
+            input.up = (seq & 1) != 0;
+            input.down = !input.up;
+            for (Client& client : clients) {
+                drain(client);
+                if (!client.joined) continue;
+                ByteBuffer packet = GameProtocol::serializeInput(seq, input, 0);
+                send(client.socket, packet.data(), packet.size(), 0);
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(16667));
+        }
+    };
+
+    // Warm up past the first liveness checks so every pool and ring has peaked
+    runFor(std::chrono::milliseconds(1500));
+    for (const Client& client : clients) {
+        assert(client.joined);
+    }
+
+    uint64_t ticksBefore = server.getMetrics().ticks.load();
+    uint64_t poolBefore = BufferPool::instance().getHeapBlocks();
+    countingArmed = true;
+    runFor(std::chrono::milliseconds(1500));
+    countingArmed = false;
+    uint64_t ticks = server.getMetrics().ticks.load() - ticksBefore;
+
+    running = false;
+    loop.join();
+    for (Client& client : clients) {
+        close(client.socket);
+    }
+    server.stop();
+
+    std::cout << "  " << ticks << " ticks, " << countedAllocations.load() << " allocations" << std::endl;
+    assert(ticks >= 60);
+    assert(countedAllocations.load() == 0);
+    assert(BufferPool::instance().getHeapBlocks() == poolBefore);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Allocation Tests ===" << std::endl;
+
+    testFrameArena();
+    testPooledByteBuffer();
+    testLatencyRing();
+    testWorldStatesAreDoubleBuffered();
+    testSteadyTicksDoNotAllocate();
+
+    std::cout << "\nAll allocation tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,162 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "../include/Shared.hpp"
+#include "../include/GameCommon.hpp"
+#include "../include/Random.hpp"
+#include <iostream>
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+using namespace CoinCollector;
+
+// Hash of the reference trace below. Every build of the fixed-point core
+// (any compiler, -O0 through -O3 -ffast-math) must reproduce it.
+constexpr uint64_t REFERENCE_TRACE_HASH = 0x71bbe8e6dfa18fd7ULL;
+
+constexpr int TRACE_PLAYERS = 16;
+constexpr int TRACE_TICKS = 100000;
+
+// FNV-1a over raw bytes
+static void hashBytes(uint64_t& hash, const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+}
+
+static void hashFloat(uint64_t& hash, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    hashBytes(hash, &bits, sizeof(bits));
+}
+
+/**
+ * Simulate a long pseudo-random input trace and hash every resulting
+ * position, velocity and collision result. Inputs come from a plain LCG
+ * so the trace itself is identical on every platform.
+ */
+static uint64_t runTrace() {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    uint32_t lcg = 12345;
+
+    std::vector<PlayerState> players;
+    for (int i = 0; i < TRACE_PLAYERS; ++i) {
+        players.emplace_back(i + 1, Vec2(100.0f + 47.0f * i, 60.0f + 29.0f * i));
+    }
+
+    std::vector<Vec2> coins;
+    for (int i = 0; i < MAX_COINS; ++i) {
+        coins.emplace_back(80.0f + 83.0f * i, 50.0f + 41.0f * i);
+    }
+
+    InputState input;
+    for (int tick = 0; tick < TRACE_TICKS; ++tick) {
+        for (auto& player : players) {
+            // Hold each input for a few ticks, like a real player
+            lcg = lcg * 1664525u + 1013904223u;
+            if ((lcg >> 28) < 4) {
+                uint32_t bits = lcg >> 12;
+                input.up = bits & 1;
+                input.down = bits & 2;
+                input.left = bits & 4;
+                input.right = bits & 8;
+            }
+
+            GameCommon::applyInput(player, input, FIXED_DT);
+            hashFloat(hash, player.position.x);
+            hashFloat(hash, player.position.y);
+            hashFloat(hash, player.velocity.x);
+            hashFloat(hash, player.velocity.y);
+
+            for (const auto& coin : coins) {
+                uint8_t hit = GameCommon::checkCollision(player.position, coin) ? 1 : 0;
+                hashBytes(hash, &hit, 1);
+            }
+        }
+    }
+
+    return hash;
+}
+
+void testTraceRepeatable() {
+    std::cout << "Test: Input trace replays identically..." << std::endl;
+
+    uint64_t first = runTrace();
+    uint64_t second = runTrace();
+    assert(first == second);
+
+    std::cout << "  Trace hash: 0x" << std::hex << first << std::dec << std::endl;
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testTraceMatchesReference() {
+#if COINCOLLECTOR_FIXED_POINT_SIM
+    std::cout << "Test: Input trace matches the cross-build reference..." << std::endl;
+
+    uint64_t hash = runTrace();
+    assert(hash == REFERENCE_TRACE_HASH);
+
+    std::cout << "  PASSED" << std::endl;
+#else
+    std::cout << "Test: Cross-build reference skipped (float simulation core)" << std::endl;
+#endif
+}
+
+void testStateRoundTrip() {
+#if COINCOLLECTOR_FIXED_POINT_SIM
+    std::cout << "Test: Fixed-point state survives float round-trip..." << std::endl;
+
+    // Server state arrives as floats; re-quantizing must not move it
+    PlayerState player(1, Vec2(123.456f, 321.987f));
+    InputState input; input.up = true; input.right = true;
+
+    for (int i = 0; i < 1000; ++i) {
+        GameCommon::applyInput(player, input, FIXED_DT);
+        if (player.position.x >= WORLD_WIDTH - PLAYER_RADIUS) input.right = false;
+        assert(Fixed::toFloat(Fixed::fromFloat(player.position.x)) == player.position.x);
+        assert(Fixed::toFloat(Fixed::fromFloat(player.position.y)) == player.position.y);
+    }
+
+    std::cout << "  PASSED" << std::endl;
+#endif
+}
+
+void testSeededRng() {
+    std::cout << "Test: Seeded PRNG is reproducible..." << std::endl;
+
+    // Reference outputs for seed 42 must be the same on every platform
+    Pcg32 rng(42);
+    assert(rng.next() == 0x713066eau);
+    assert(rng.next() == 0x3c7a0d56u);
+    assert(rng.next() == 0xf424216au);
+
+    Pcg32 a(7);
+    Pcg32 b(7);
+    for (int i = 0; i < 1000; ++i) {
+        Vec2 pa = GameCommon::randomCoinPosition(a);
+        Vec2 pb = GameCommon::randomCoinPosition(b);
+        assert(pa.x == pb.x && pa.y == pb.y);
+        assert(pa.x >= COIN_RADIUS && pa.x < WORLD_WIDTH - COIN_RADIUS);
+        assert(pa.y >= COIN_RADIUS && pa.y < WORLD_HEIGHT - COIN_RADIUS);
+        assert(a.nextBounded(10) < 10u);
+        b.nextBounded(10);
+    }
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Determinism Tests ===" << std::endl;
+
+    testTraceRepeatable();
+    testTraceMatchesReference();
+    testStateRoundTrip();
+    testSeededRng();
+
+    std::cout << "\nAll determinism tests passed!" << std::endl;
+    return 0;
+}
@@ -4,6 +4,7 @@
 
 #include "../include/Shared.hpp"
 #include "../include/GameCommon.hpp"
+#include "../client/Interpolation.hpp"
 #include <iostream>
 #include <cassert>
 #include <cmath>
@@ -57,12 +58,244 @@ void testLerpSamePoints() {
     std::cout << "  PASSED" << std::endl;
 }
 
+// Feed one world state per broadcast interval with a fixed arrival latency
+static TimePoint feedSnapshots(InterpolationEngine& engine, TimePoint start,
+                               uint32_t firstTick, int count, float speed) {
+    TimePoint now = start;
+    for (int i = 0; i < count; ++i) {
+        uint32_t tick = firstTick + i * BROADCAST_INTERVAL_TICKS;
+        now = start + std::chrono::duration_cast<Duration>(
+            std::chrono::duration<double>(i * BROADCAST_INTERVAL_TICKS * FIXED_DT));
+        engine.observeServerTick(tick, now);
+
+        PlayerState state(7, Vec2(100.0f + speed * tick * FIXED_DT, 100.0f));
+        engine.addSnapshot(state, tick);
+        engine.advance(now);
+    }
+    return now;
+}
+
+void testTickTimeline() {
+    std::cout << "Test: Interpolation on server tick timeline..." << std::endl;
+
+    InterpolationEngine engine;
+    TimePoint start = std::chrono::steady_clock::now();
+    feedSnapshots(engine, start, 1000, 40, 60.0f);
+
+    // Render tick trails the newest tick by the adaptive delay
+    double newestTick = 1000 + 39 * BROADCAST_INTERVAL_TICKS;
+    double delayTicks = engine.getInterpolationDelay() / FIXED_DT;
+    assert(std::abs((newestTick - engine.getRenderTick()) - delayTicks) < 1.0);
+
+    // Interpolated position matches the linear motion at the render tick
+    PlayerState out;
+    assert(engine.getInterpolatedState(7, out));
+    float expectedX = 100.0f + 60.0f * static_cast<float>(engine.getRenderTick() * FIXED_DT);
+    assert(std::abs(out.position.x - expectedX) < 0.5f);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testTickRegressionResets() {
+    std::cout << "Test: A server restarted at an older tick is followed, not frozen..." << std::endl;
+
+    InterpolationEngine engine;
+    TimePoint start = std::chrono::steady_clock::now();
+    TimePoint end = feedSnapshots(engine, start, 1000, 40, 60.0f);
+
+    // Resumed after a restart from a checkpoint 250 ticks older
+    uint32_t newestTick = 1000 + 39 * BROADCAST_INTERVAL_TICKS;
+    uint32_t restartTick = newestTick - 250;
+    feedSnapshots(engine, end + std::chrono::milliseconds(500), restartTick, 20, 60.0f);
+
+    // The timeline follows the new ticks and remote players keep moving
+    double latestTick = restartTick + 19 * BROADCAST_INTERVAL_TICKS;
+    double delayTicks = engine.getInterpolationDelay() / FIXED_DT;
+    assert(std::abs((latestTick - engine.getRenderTick()) - delayTicks) < 1.0);
+
+    PlayerState out;
+    assert(engine.getInterpolatedState(7, out));
+    float expectedX = 100.0f + 60.0f * static_cast<float>(engine.getRenderTick() * FIXED_DT);
+    assert(std::abs(out.position.x - expectedX) < 0.5f);
+    assert(engine.getBufferSize(7) == 20);
+
+    // A repeated tick, as a resumed session's full snapshot may send, keeps the history
+    engine.observeServerTick(static_cast<uint32_t>(latestTick), end + std::chrono::seconds(2));
+    assert(engine.getBufferSize(7) == 20);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testJitterAdaptsDelay() {
+    std::cout << "Test: Interpolation delay adapts to jitter..." << std::endl;
+
+    InterpolationEngine steady;
+    feedSnapshots(steady, std::chrono::steady_clock::now(), 0, 60, 0.0f);
+
+    InterpolationEngine jittery;
+    TimePoint start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 60; ++i) {
+        uint32_t tick = i * BROADCAST_INTERVAL_TICKS;
+        double jitter = (i % 2 == 0) ? 0.0 : 0.03;
+        TimePoint now = start + std::chrono::duration_cast<Duration>(
+            std::chrono::duration<double>(tick * FIXED_DT + jitter));
+        jittery.observeServerTick(tick, now);
+    }
+
+    assert(jittery.getJitter() > steady.getJitter());
+    assert(jittery.getInterpolationDelay() > steady.getInterpolationDelay());
+    assert(jittery.getInterpolationDelay() <= MAX_INTERPOLATION_DELAY_MS / 1000.0 + 1e-9);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testBufferDrainSlowsPlayback() {
+    std::cout << "Test: Playback slows down when the buffer drains..." << std::endl;
+
+    InterpolationEngine engine;
+    TimePoint now = feedSnapshots(engine, std::chrono::steady_clock::now(), 0, 20, 0.0f);
+
+    // No new snapshots arrive; the render timeline must not snap forward
+    double before = engine.getRenderTick();
+    for (int i = 1; i <= 10; ++i) {
+        engine.advance(now + std::chrono::milliseconds(16 * i));
+    }
+    double advanced = (engine.getRenderTick() - before) * FIXED_DT;
+    assert(advanced > 0.0);
+    assert(advanced <= 0.160 * 1.05 + 1e-6);
+    assert(engine.getTimeScale() <= 1.0);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testBatchInterpolation() {
+    std::cout << "Test: Batch interpolation into caller array..." << std::endl;
+
+    InterpolationEngine engine;
+    TimePoint start = std::chrono::steady_clock::now();
+    const PlayerID count = 300;
+
+    // Overfill each ring to exercise wraparound
+    for (int i = 0; i < 100; ++i) {
+        uint32_t tick = i * BROADCAST_INTERVAL_TICKS;
+        TimePoint now = start + std::chrono::duration_cast<Duration>(
+            std::chrono::duration<double>(tick * FIXED_DT));
+        engine.observeServerTick(tick, now);
+        for (PlayerID id = 1; id <= count; ++id) {
+            engine.addSnapshot(PlayerState(id, Vec2(static_cast<float>(id), tick * 1.0f)), tick);
+        }
+        engine.advance(now);
+    }
+
+    assert(engine.entityCount() == count);
+    assert(engine.getBufferSize(1) == InterpolationEngine::SNAPSHOT_CAPACITY);
+
+    std::vector<PlayerState> out(count);
+    size_t written = engine.interpolateAll(out.data(), out.size());
+    assert(written == count);
+
+    // Each entity matches the single-entity query at the same render tick
+    for (const auto& state : out) {
+        PlayerState single;
+        assert(engine.getInterpolatedState(state.id, single));
+        assert(std::abs(single.position.y - state.position.y) < 0.001f);
+        assert(std::abs(state.position.y - engine.getRenderTick()) < 0.01f);
+    }
+
+    // Capacity is respected
+    assert(engine.interpolateAll(out.data(), 10) == 10);
+
+    // Removal keeps remaining entities addressable
+    engine.removePlayer(1);
+    assert(engine.entityCount() == count - 1);
+    assert(engine.getBufferSize(1) == 0);
+    assert(engine.getBufferSize(count) == InterpolationEngine::SNAPSHOT_CAPACITY);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testExtrapolationAndBlend() {
+    std::cout << "Test: Dead reckoning past the newest snapshot..." << std::endl;
+
+    InterpolationEngine engine;
+    engine.setExtrapolation(200, 100);
+    TimePoint start = std::chrono::steady_clock::now();
+
+    // Player moving right at 60 px/s, wire velocity matches
+    auto stateAt = [](uint32_t tick) {
+        PlayerState state(3, Vec2(100.0f + 60.0f * tick * FIXED_DT, 200.0f));
+        state.velocity = Vec2(60.0f, 0.0f);
+        return state;
+    };
+    auto timeAt = [start](double seconds) {
+        return start + std::chrono::duration_cast<Duration>(std::chrono::duration<double>(seconds));
+    };
+
+    uint32_t tick = 0;
+    for (; tick < 60; tick += BROADCAST_INTERVAL_TICKS) {
+        engine.observeServerTick(tick, timeAt(tick * FIXED_DT));
+        engine.addSnapshot(stateAt(tick), tick);
+        engine.advance(timeAt(tick * FIXED_DT));
+    }
+    uint32_t lastTick = tick - BROADCAST_INTERVAL_TICKS;
+
+    // Packets stop; render time runs past the newest snapshot
+    double t = lastTick * FIXED_DT;
+    PlayerState out;
+    for (int i = 0; i < 8; ++i) {
+        t += 0.016;
+        engine.advance(timeAt(t));
+        assert(engine.getInterpolatedState(3, out));
+    }
+    assert(engine.getRenderTick() > lastTick);
+    float expectedX = 100.0f + 60.0f * static_cast<float>(engine.getRenderTick() * FIXED_DT);
+    assert(std::abs(out.position.x - expectedX) < 0.5f);
+    assert(out.position.x > stateAt(lastTick).position.x);
+
+    // Extrapolation is bounded
+    for (int i = 0; i < 20; ++i) {
+        t += 0.016;
+        engine.advance(timeAt(t));
+    }
+    assert(engine.getInterpolatedState(3, out));
+    assert(out.position.x <= stateAt(lastTick).position.x + 60.0f * 0.2f + 0.01f);
+
+    // The real snapshot shows the player stopped; the correction blends in
+    Vec2 shown = out.position;
+    PlayerState stopped = stateAt(lastTick);
+    stopped.velocity = Vec2();
+    uint32_t lateTick = lastTick + BROADCAST_INTERVAL_TICKS;
+    engine.observeServerTick(lateTick, timeAt(t));
+    engine.addSnapshot(stopped, lateTick);
+    engine.addSnapshot(stopped, lateTick + BROADCAST_INTERVAL_TICKS);
+
+    t += 0.001;
+    engine.advance(timeAt(t));
+    assert(engine.getInterpolatedState(3, out));
+    assert(std::abs(out.position.x - shown.x) < 1.0f);
+
+    for (int i = 0; i < 10; ++i) {
+        t += 0.016;
+        engine.advance(timeAt(t));
+        assert(engine.getInterpolatedState(3, out));
+    }
+    assert(std::abs(out.position.x - stopped.position.x) < 0.01f);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
 int main() {
     std::cout << "=== Interpolation Tests ===" << std::endl;
 
     testLerpBasic();
     testLerpNegative();
     testLerpSamePoints();
+    testTickTimeline();
+    testTickRegressionResets();
+    testJitterAdaptsDelay();
+    testBufferDrainSlowsPlayback();
+    testBatchInterpolation();
+    testExtrapolationAndBlend();
 
     std::cout << "\nAll interpolation tests passed!" << std::endl;
     return 0;
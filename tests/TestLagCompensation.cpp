@@ -0,0 +1,223 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "../include/Shared.hpp"
+#include "../include/GameCommon.hpp"
+#include "../server/GameWorld.hpp"
+#include "../server/RewindHistory.hpp"
+#include "../server/ServerPlayer.hpp"
+#include <iostream>
+#include <cassert>
+#include <memory>
+
+using namespace CoinCollector;
+
+/**
+ * A spot that touches no active coin
+ */
+static Vec2 clearSpot(const std::vector<CoinState>& coins) {
+    for (float y = PLAYER_RADIUS; y < WORLD_HEIGHT; y += 10.0f) {
+        for (float x = PLAYER_RADIUS; x < WORLD_WIDTH; x += 10.0f) {
+            bool clear = true;
+            for (const auto& coin : coins) {
+                if (coin.active && GameCommon::checkCollision(Vec2(x, y), coin.position)) clear = false;
+            }
+            if (clear) return Vec2(x, y);
+        }
+    }
+    return Vec2(0.0f, 0.0f);
+}
+
+void testHistoryWindow() {
+    std::cout << "Test: History answers within the rewind window..." << std::endl;
+
+    std::vector<std::unique_ptr<ServerPlayer>> owned;
+    std::vector<ServerPlayer*> players;
+    for (PlayerID id = 1; id <= 3; ++id) {
+        owned.push_back(std::make_unique<ServerPlayer>(id));
+        players.push_back(owned.back().get());
+    }
+
+    RewindHistory history;
+    assert(history.getCapacity() == static_cast<uint32_t>(TICK_RATE));
+    history.setMaxRewindTicks(30);
+
+    std::vector<CoinState> coins;
+    std::vector<uint32_t> generations;
+    for (uint32_t tick = 0; tick < 200; ++tick) {
+        for (auto* player : players) {
+            player->getState().position = Vec2(static_cast<float>(tick), static_cast<float>(player->getId()));
+        }
+        history.record(tick, players, coins, generations);
+    }
+
+    Vec2 pos;
+    assert(history.positionAt(2, 190, pos));
+    assert(pos.x == 190.0f && pos.y == 2.0f);
+
+    // Older than the max rewind clamps to the oldest allowed tick
+    assert(history.clampTick(10) == 169);
+    assert(history.positionAt(3, 10, pos));
+    assert(pos.x == 169.0f);
+
+    // Future ticks clamp to the latest
+    assert(history.positionAt(1, 5000, pos));
+    assert(pos.x == 199.0f);
+
+    assert(!history.positionAt(42, 190, pos));
+
+    // The max rewind can never exceed what the ring holds
+    history.setMaxRewindTicks(100000);
+    assert(history.getMaxRewindTicks() == history.getCapacity() - 1);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testUnsortedPlayers() {
+    std::cout << "Test: Players out of id order are still found..." << std::endl;
+
+    std::vector<std::unique_ptr<ServerPlayer>> owned;
+    std::vector<ServerPlayer*> players;
+    for (PlayerID id : {7u, 3u, 9u, 1u}) {
+        owned.push_back(std::make_unique<ServerPlayer>(id));
+        owned.back()->getState().position = Vec2(static_cast<float>(id) * 10.0f, 0.0f);
+        players.push_back(owned.back().get());
+    }
+
+    RewindHistory history;
+    history.record(0, players, {}, {});
+
+    for (PlayerID id : {7u, 3u, 9u, 1u}) {
+        Vec2 pos;
+        assert(history.positionAt(id, 0, pos));
+        assert(pos.x == static_cast<float>(id) * 10.0f);
+    }
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testCompensatedPickup() {
+    std::cout << "Test: Client that still saw a taken coin gets the pickup once..." << std::endl;
+
+    for (uint32_t maxRewind : {30u, 0u}) {
+        GameWorld world(2024);
+        world.setLogPickups(false);
+        world.setMaxRewindTicks(maxRewind);
+
+        std::vector<std::unique_ptr<ServerPlayer>> owned;
+        std::vector<ServerPlayer*> players;
+        world.spawnCoins(players);
+
+        // A has seen everything, B is 5 ticks behind
+        Vec2 idle = clearSpot(world.getCoins());
+        for (PlayerID id = 1; id <= 2; ++id) {
+            owned.push_back(std::make_unique<ServerPlayer>(id));
+            owned.back()->getState().position = idle;
+            players.push_back(owned.back().get());
+        }
+
+        uint32_t tick = 0;
+        for (; tick < 10; ++tick) {
+            world.checkCollisions(players, tick);
+        }
+
+        // Both reach coin 0 on the same tick; A is processed first and takes it live,
+        // but B saw the coin earlier so the point goes to B when rewinding is on
+        Vec2 coin = world.getCoins()[0].position;
+        players[0]->getState().position = coin;
+        players[1]->getState().position = coin;
+        players[0]->setViewTick(tick - 1);
+        players[1]->setViewTick(tick - 5);
+        world.checkCollisions(players, tick++);
+
+        uint32_t expected = maxRewind > 0 ? 1 : 0;
+        assert(players[0]->getState().score == 1 - expected);
+        assert(players[1]->getState().score == expected);
+        assert(world.getCompensatedPickups() == expected);
+
+        // Standing there for more ticks never claims the same coin twice
+        for (int i = 0; i < 10; ++i) {
+            world.checkCollisions(players, tick++);
+        }
+        assert(players[0]->getState().score == 1 - expected);
+        assert(players[1]->getState().score == expected);
+    }
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testContestedCoin() {
+    std::cout << "Test: A contested coin is awarded once, to the earliest view..." << std::endl;
+
+    GameWorld world(77);
+    world.setLogPickups(false);
+    world.setMaxRewindTicks(30);
+
+    std::vector<std::unique_ptr<ServerPlayer>> owned;
+    std::vector<ServerPlayer*> players;
+    world.spawnCoins(players);
+
+    Vec2 idle = clearSpot(world.getCoins());
+    for (PlayerID id = 1; id <= 3; ++id) {
+        owned.push_back(std::make_unique<ServerPlayer>(id));
+        owned.back()->getState().position = idle;
+        players.push_back(owned.back().get());
+    }
+
+    uint32_t tick = 0;
+    for (; tick < 10; ++tick) {
+        world.checkCollisions(players, tick);
+    }
+
+    auto totalScore = [&players]() {
+        uint32_t total = 0;
+        for (auto* player : players) total += player->getState().score;
+        return total;
+    };
+
+    // A takes coin 0 live, looking at tick 9
+    Vec2 coin = world.getCoins()[0].position;
+    players[0]->getState().position = coin;
+    players[0]->setViewTick(tick - 1);
+    world.checkCollisions(players, tick++);
+    assert(players[0]->getState().score == 1);
+    players[0]->getState().position = idle;
+    world.checkCollisions(players, tick++);
+
+    // B arrives later but was looking at tick 7: the coin changes hands
+    players[1]->getState().position = coin;
+    players[1]->setViewTick(7);
+    world.checkCollisions(players, tick++);
+    assert(players[0]->getState().score == 0);
+    assert(players[1]->getState().score == 1);
+
+    // C was looking at tick 8, after B's view: nothing left to take
+    players[2]->getState().position = coin;
+    players[2]->setViewTick(8);
+    // A walks back with its old view and cannot reclaim it either
+    players[0]->getState().position = coin;
+    for (int i = 0; i < 10; ++i) {
+        world.checkCollisions(players, tick++);
+    }
+
+    assert(players[0]->getState().score == 0);
+    assert(players[1]->getState().score == 1);
+    assert(players[2]->getState().score == 0);
+    assert(totalScore() == 1);
+    assert(world.getCompensatedPickups() == 1);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Lag Compensation Tests ===" << std::endl;
+
+    testHistoryWindow();
+    testUnsortedPlayers();
+    testCompensatedPickup();
+    testContestedCoin();
+
+    std::cout << "\nAll lag compensation tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,139 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "../include/Shared.hpp"
+#include "../server/GameServer.hpp"
+#include "../server/MetricsExporter.hpp"
+#include "../server/ServerMetrics.hpp"
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace CoinCollector;
+
+static const uint16_t TEST_PORT = 39587;
+
+static bool near(uint64_t value, uint64_t expected, double tolerance) {
+    double diff = static_cast<double>(value) - static_cast<double>(expected);
+    return std::abs(diff) <= tolerance * static_cast<double>(expected);
+}
+
+void testHistogramAccuracy() {
+    std::cout << "Test: Histogram quantiles stay within bucket precision..." << std::endl;
+
+    // Every bucket round-trips and buckets never overlap
+    for (int i = 1; i < LatencyHistogram::BUCKET_COUNT; ++i) {
+        assert(LatencyHistogram::bucketOf(LatencyHistogram::bucketUpperBound(i)) == i);
+        assert(LatencyHistogram::bucketUpperBound(i) > LatencyHistogram::bucketUpperBound(i - 1));
+    }
+    assert(LatencyHistogram::bucketOf(~0ULL) == LatencyHistogram::BUCKET_COUNT - 1);
+
+    LatencyHistogram histogram;
+    assert(histogram.percentile(0.5) == 0);
+    for (uint64_t ns = 1; ns <= 100000; ++ns) {
+        histogram.record(ns * 1000);
+    }
+
+    assert(histogram.getCount() == 100000);
+    assert(histogram.getMax() == 100000000);
+    assert(near(histogram.percentile(0.5), 50000000, 0.035));
+    assert(near(histogram.percentile(0.99), 99000000, 0.035));
+    assert(histogram.percentile(1.0) == histogram.getMax());
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testConcurrentRecording() {
+    std::cout << "Test: Histograms take samples from many threads..." << std::endl;
+
+    LatencyHistogram histogram;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&histogram, t] {
+            for (int i = 0; i < 50000; ++i) histogram.record(static_cast<uint64_t>(t * 1000 + i % 7));
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    assert(histogram.getCount() == 200000);
+    assert(histogram.getMax() == 3006);
+
+    // A null histogram makes the timer a no-op
+    { ScopedTimer idle(nullptr); }
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+static std::string scrape(uint16_t port) {
+    SocketType sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    assert(connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+
+    std::string request = "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    send(sock, request.data(), request.size(), 0);
+
+    std::string response;
+    char buffer[4096];
+    ssize_t n;
+    while ((n = recv(sock, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, static_cast<size_t>(n));
+    }
+    close(sock);
+    return response;
+}
+
+void testServerEndpoint() {
+    std::cout << "Test: Running server exports tick timings over HTTP..." << std::endl;
+
+    GameServer server(TEST_PORT, 7);
+    assert(server.start());
+    assert(server.enableMetrics(TEST_PORT + 1));
+
+    std::atomic<bool> running(true);
+    std::thread loop([&] { server.run(running); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    std::string response = scrape(TEST_PORT + 1);
+    assert(response.compare(0, 15, "HTTP/1.1 200 OK") == 0);
+    assert(response.find("# TYPE coincollector_tick_phase_seconds summary") != std::string::npos);
+    assert(response.find("coincollector_tick_phase_seconds{phase=\"collisions\",quantile=\"0.99\"}") !=
+           std::string::npos);
+    assert(response.find("coincollector_sent_bytes_total") != std::string::npos);
+    assert(response.find("coincollector_rooms 1") != std::string::npos);
+
+    running = false;
+    loop.join();
+
+    const ServerMetrics& metrics = server.getMetrics();
+    uint64_t ticks = metrics.ticks.load();
+    assert(ticks > 0);
+    // A frame that caught up ran several ticks after one network pass
+    assert(metrics.phase(TickPhase::Tick).getCount() + metrics.catchUpTicks.load() == ticks);
+    assert(metrics.phase(TickPhase::Collisions).getCount() == ticks); // one room
+    assert(metrics.phase(TickPhase::Broadcast).getCount() > 0);
+    assert(metrics.phase(TickPhase::Shards).getCount() == 0);
+    assert(metrics.phase(TickPhase::Tick).getMax() >= metrics.phase(TickPhase::Rooms).getMax());
+
+    server.stop();
+    std::cout << "  PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Metrics Tests ===" << std::endl;
+
+    testHistogramAccuracy();
+    testConcurrentRecording();
+    testServerEndpoint();
+
+    std::cout << "\nAll metrics tests passed!" << std::endl;
+    return 0;
+}
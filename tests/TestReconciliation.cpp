@@ -4,6 +4,7 @@
 
 #include "../include/Shared.hpp"
 #include "../include/GameCommon.hpp"
+#include "../client/Prediction.hpp"
 #include <iostream>
 #include <cassert>
 #include <cmath>
@@ -76,12 +77,136 @@ void testBoundaryClamp() {
     std::cout << "  PASSED" << std::endl;
 }
 
+void testSmoothedCorrection() {
+    std::cout << "Test: Correction moves simulation but not the rendered position..." << std::endl;
+
+    PredictionEngine prediction;
+    PlayerState local(1, Vec2(100.0f, 100.0f));
+
+    InputState right; right.right = true;
+    SequenceID first = prediction.applyInput(local, right, FIXED_DT);
+    for (int i = 0; i < 5; ++i) {
+        prediction.applyInput(local, right, FIXED_DT);
+    }
+
+    // Server says we were pushed 30px down when it processed the first input
+    PlayerState server(1, Vec2(100.0f + MAX_PLAYER_SPEED * FIXED_DT, 130.0f));
+    Vec2 shownBefore = prediction.getRenderPosition(local);
+    prediction.reconcile(server, first, local, FIXED_DT);
+
+    // Simulation moved, render position stayed put
+    assert(std::abs(local.position.y - 130.0f) < 0.001f);
+    Vec2 shownAfter = prediction.getRenderPosition(local);
+    assert(std::abs(shownAfter.x - shownBefore.x) < 0.001f);
+    assert(std::abs(shownAfter.y - shownBefore.y) < 0.001f);
+
+    assert(prediction.getStats().corrections == 1);
+    assert(prediction.getStats().replayedInputs == 5);
+    assert(std::abs(prediction.getStats().lastError - 30.0f) < 0.01f);
+
+    // Offset decays exponentially toward the simulation
+    prediction.setErrorDecayRate(10.0f);
+    prediction.decayError(0.1f);
+    float expected = 30.0f * std::exp(-1.0f);
+    assert(std::abs(-prediction.getErrorOffset().y - expected) < 0.01f);
+    for (int i = 0; i < 100; ++i) {
+        prediction.decayError(0.1f);
+    }
+    assert(prediction.getErrorOffset().lengthSquared() == 0.0f);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testConfigurableThreshold() {
+    std::cout << "Test: Configurable reconciliation threshold..." << std::endl;
+
+    PredictionEngine prediction;
+    prediction.setReconciliationThreshold(50.0f);
+    PlayerState local(1, Vec2(100.0f, 100.0f));
+
+    InputState none;
+    SequenceID first = prediction.applyInput(local, none, FIXED_DT);
+    prediction.applyInput(local, none, FIXED_DT);
+
+    // 30px error is below the threshold: keep the prediction
+    PlayerState server(1, Vec2(100.0f, 130.0f));
+    prediction.reconcile(server, first, local, FIXED_DT);
+    assert(std::abs(local.position.y - 100.0f) < 0.001f);
+    assert(prediction.getStats().corrections == 0);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testReplayStopsAtConvergence() {
+    std::cout << "Test: Replay ends once it rejoins the prediction..." << std::endl;
+
+    PredictionEngine prediction;
+    float wallX = WORLD_WIDTH - PLAYER_RADIUS;
+    PlayerState local(1, Vec2(wallX, 200.0f));
+
+    // Pressing into the right wall: every prediction clamps to the wall
+    InputState right; right.right = true;
+    SequenceID first = prediction.applyInput(local, right, FIXED_DT);
+    for (int i = 0; i < 20; ++i) {
+        prediction.applyInput(local, right, FIXED_DT);
+    }
+
+    // Server has us 8px short of the wall; two replayed steps reach it again
+    PlayerState server(1, Vec2(wallX - 8.0f, 200.0f));
+    server.velocity = Vec2(MAX_PLAYER_SPEED, 0.0f);
+    prediction.reconcile(server, first, local, FIXED_DT);
+
+    const auto& stats = prediction.getStats();
+    assert(stats.corrections == 1);
+    assert(stats.lastReplayLength == 2);
+    assert(stats.convergedReplays == 1);
+    assert(std::abs(local.position.x - wallX) < 0.001f);
+    assert(prediction.historySize() == 20);
+
+    // Same ack again compares against the corrected prediction: no replay
+    prediction.reconcile(server, first, local, FIXED_DT);
+    assert(prediction.getStats().corrections == 1);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testHistoryRingBounds() {
+    std::cout << "Test: History ring is bounded and O(1) by sequence..." << std::endl;
+
+    PredictionEngine prediction;
+    PlayerState local(1, Vec2(100.0f, 100.0f));
+    InputState none;
+
+    const size_t total = PredictionEngine::HISTORY_CAPACITY + 50;
+    SequenceID last = 0;
+    for (size_t i = 0; i < total; ++i) {
+        last = prediction.applyInput(local, none, FIXED_DT);
+    }
+    assert(prediction.historySize() == PredictionEngine::HISTORY_CAPACITY);
+
+    // Acking recent input drops everything before it
+    prediction.reconcile(local, last - 10, local, FIXED_DT);
+    assert(prediction.historySize() == 10);
+
+    // Replay never exceeds the ring
+    PlayerState server(1, Vec2(300.0f, 300.0f));
+    prediction.reconcile(server, last - 10, local, FIXED_DT);
+    assert(prediction.getStats().lastReplayLength == 10);
+    assert(prediction.getStats().maxReplayLength <= PredictionEngine::HISTORY_CAPACITY);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
 int main() {
     std::cout << "=== Reconciliation Tests ===" << std::endl;
 
     testDeterministicPhysics();
     testInputReplay();
     testBoundaryClamp();
+    testSmoothedCorrection();
+    testConfigurableThreshold();
+    testReplayStopsAtConvergence();
+    testHistoryRingBounds();
 
     std::cout << "\nAll reconciliation tests passed!" << std::endl;
     return 0;
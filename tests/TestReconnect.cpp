@@ -0,0 +1,265 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "../include/Shared.hpp"
+#include "../include/GameProtocol.hpp"
+#include "../server/ServerNetwork.hpp"
+#include "../server/ServerPlayer.hpp"
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
+using namespace CoinCollector;
+
+static const uint16_t TEST_PORT = 39187;
+
+struct Welcome {
+    PlayerID playerId = 0;
+    uint64_t token = 0;
+    bool resumed = false;
+    uint32_t roomId = 0;
+};
+
+static SocketType connectClient(uint16_t port = TEST_PORT) {
+    SocketType sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    assert(connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+    return sock;
+}
+
+/**
+ * Handshake over a raw socket, pumping the server until the (latency
+ * delayed) response arrives
+ */
+static Welcome handshake(ServerNetwork& network, SocketType sock, uint64_t resumeToken) {
+    ByteBuffer request = GameProtocol::serializeHandshake(0, resumeToken, 0);
+    assert(send(sock, request.data(), request.size(), 0) == static_cast<ssize_t>(request.size()));
+
+    std::vector<uint8_t> received;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+    while (std::chrono::steady_clock::now() < deadline) {
+        network.update();
+
+        uint8_t buffer[512];
+        ssize_t n = recv(sock, buffer, sizeof(buffer), 0);
+        if (n > 0) received.insert(received.end(), buffer, buffer + n);
+
+        if (received.size() >= 7) {
+            ByteBuffer packet(received);
+            PacketHeader header = GameProtocol::deserializeHeader(packet);
+            assert(header.type == PacketType::Handshake);
+            if (received.size() >= 7u + header.payloadSize) {
+                Welcome welcome;
+                welcome.playerId = GameProtocol::deserializeHandshakeResponse(
+                    packet, welcome.token, welcome.resumed, welcome.roomId);
+                return welcome;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    assert(false && "no handshake response");
+    return Welcome();
+}
+
+static void pumpUntil(ServerNetwork& network, const std::function<bool()>& done) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+    while (!done() && std::chrono::steady_clock::now() < deadline) {
+        network.update();
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    assert(done());
+}
+
+void testResumeAfterDrop() {
+    std::cout << "Test: Dropped player resumes with its state..." << std::endl;
+
+    ServerNetwork network(TEST_PORT);
+    assert(network.initialize());
+
+    int connects = 0, resumes = 0, disconnects = 0;
+    network.setConnectionCallbacks(
+        [&](ServerPlayer&, bool resumed) { resumed ? resumes++ : connects++; },
+        [&](const ServerPlayer&) { disconnects++; });
+
+    SocketType first = connectClient();
+    Welcome welcome = handshake(network, first, 0);
+    assert(welcome.playerId == 1);
+    assert(welcome.token != 0);
+    assert(!welcome.resumed);
+    network.getPlayers()[0]->getState().score = 7;
+
+    // Network blip: the player is parked, not deleted
+    close(first);
+    pumpUntil(network, [&] { return disconnects == 1; });
+    assert(network.getPlayers().empty());
+    assert(network.getParkedPlayers().size() == 1);
+
+    SocketType second = connectClient();
+    Welcome resumed = handshake(network, second, welcome.token);
+    assert(resumed.playerId == welcome.playerId);
+    assert(resumed.token == welcome.token);
+    assert(resumed.resumed);
+    assert(network.getPlayers().size() == 1);
+    assert(network.getPlayers()[0]->getState().score == 7);
+    assert(network.getParkedPlayers().empty());
+
+    // An unknown token just gets a new player
+    SocketType third = connectClient();
+    Welcome stranger = handshake(network, third, 0x1234);
+    assert(stranger.playerId == 2);
+    assert(!stranger.resumed);
+    assert(connects == 2 && resumes == 1);
+
+    close(second);
+    close(third);
+    network.shutdown();
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testResumeBeforeDropNoticed() {
+    std::cout << "Test: Reconnecting before the drop is noticed takes over the session..." << std::endl;
+
+    ServerNetwork network(TEST_PORT + 4);
+    assert(network.initialize());
+
+    int connects = 0, resumes = 0, disconnects = 0;
+    network.setConnectionCallbacks(
+        [&](ServerPlayer&, bool resumed) { resumed ? resumes++ : connects++; },
+        [&](const ServerPlayer&) { disconnects++; });
+
+    SocketType first = connectClient(TEST_PORT + 4);
+    Welcome welcome = handshake(network, first, 0);
+    network.getPlayers()[0]->getState().score = 5;
+
+    // The old socket is still open as far as the server knows
+    SocketType second = connectClient(TEST_PORT + 4);
+    Welcome resumed = handshake(network, second, welcome.token);
+    assert(resumed.playerId == welcome.playerId);
+    assert(resumed.token == welcome.token);
+    assert(resumed.resumed);
+    assert(network.getPlayers().size() == 1);
+    assert(network.getPlayers()[0]->getState().score == 5);
+    assert(network.getParkedPlayers().empty());
+    assert(connects == 1 && resumes == 1 && disconnects == 1);
+
+    // The server hung up the old socket
+    uint8_t buffer[256];
+    ssize_t n;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while ((n = recv(first, buffer, sizeof(buffer), 0)) != 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    assert(n == 0);
+
+    // Its timer went with it: closing the old socket now drops no one
+    close(first);
+    for (int i = 0; i < 20; ++i) {
+        network.update();
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    assert(network.getPlayers().size() == 1);
+    assert(disconnects == 1);
+
+    close(second);
+    network.shutdown();
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testRestoredSession() {
+    std::cout << "Test: Session restored from a checkpoint can be claimed..." << std::endl;
+
+    ServerNetwork network(TEST_PORT + 1);
+    assert(network.initialize());
+    network.setSpawnPositionProvider([](uint32_t) { return Vec2(100.0f, 200.0f); });
+
+    network.parkSession(0xabcdef, 10, 3);
+
+    SocketType sock = connectClient(TEST_PORT + 1);
+    Welcome welcome = handshake(network, sock, 0xabcdef);
+    assert(welcome.playerId == 10);
+    assert(welcome.resumed);
+
+    // Restored sessions have no position, so they spawn fresh
+    const PlayerState& state = network.getPlayers()[0]->getState();
+    assert(state.score == 3);
+    assert(state.position.x == 100.0f && state.position.y == 200.0f);
+
+    // New players never reuse a restored id
+    SocketType other = connectClient(TEST_PORT + 1);
+    assert(handshake(network, other, 0).playerId == 11);
+
+    close(sock);
+    close(other);
+    network.shutdown();
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testReapSilentAndIdle() {
+    std::cout << "Test: Silent and idle connections are reaped..." << std::endl;
+
+    // Silent client that never answers pings
+    {
+        ServerNetwork network(TEST_PORT + 2);
+        assert(network.initialize());
+        network.setLivenessTimeouts(100, 3, 60000);
+
+        SocketType sock = connectClient(TEST_PORT + 2);
+        handshake(network, sock, 0);
+        pumpUntil(network, [&] { return network.getPlayers().empty(); });
+
+        assert(network.getReapStats().pingTimeouts == 1);
+        assert(network.getReapStats().idleTimeouts == 0);
+        assert(network.getParkedPlayers().size() == 1); // still resumable
+
+        close(sock);
+        network.shutdown();
+    }
+
+    // Answers pings but never plays
+    {
+        ServerNetwork network(TEST_PORT + 3);
+        assert(network.initialize());
+        network.setLivenessTimeouts(20, 1000, 500);
+
+        SocketType sock = connectClient(TEST_PORT + 3);
+        handshake(network, sock, 0);
+        pumpUntil(network, [&] {
+            uint8_t buffer[256];
+            ssize_t n = recv(sock, buffer, sizeof(buffer), 0);
+            for (ssize_t i = 0; i + 7 <= n; i += 7) {
+                ByteBuffer pong = GameProtocol::serializePong(0);
+                send(sock, pong.data(), pong.size(), 0);
+            }
+            return network.getPlayers().empty();
+        });
+
+        assert(network.getReapStats().idleTimeouts == 1);
+        assert(network.getReapStats().pingTimeouts == 0);
+
+        close(sock);
+        network.shutdown();
+    }
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Reconnect Tests ===" << std::endl;
+
+    testResumeAfterDrop();
+    testResumeBeforeDropNoticed();
+    testRestoredSession();
+    testReapSilentAndIdle();
+
+    std::cout << "\nAll reconnect tests passed!" << std::endl;
+    return 0;
+}
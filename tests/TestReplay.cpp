@@ -0,0 +1,209 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "../include/Shared.hpp"
+#include "../server/GameWorld.hpp"
+#include "../server/MatchLog.hpp"
+#include "../server/MatchReplay.hpp"
+#include "../server/WorldCheckpoint.hpp"
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+
+using namespace CoinCollector;
+
+static const char* LOG_PATH = "TestReplay.match.log";
+static const char* CHECKPOINT_PATH = "TestReplay.world.ckpt";
+
+/**
+ * Drive a GameWorld the way GameServer::gameLoop does and record it
+ */
+static uint64_t recordMatch(uint64_t seed, uint32_t ticks, uint32_t& pickups) {
+    GameWorld world(seed);
+    world.setLogPickups(false);
+    MatchRecorder recorder;
+    assert(recorder.open(LOG_PATH, seed, static_cast<uint16_t>(world.getMaxRewindTicks())));
+
+    std::vector<std::unique_ptr<ServerPlayer>> owned;
+    std::vector<ServerPlayer*> players;
+    world.spawnCoins(players);
+
+    uint32_t lcg = 99;
+    SequenceID seq = 1;
+    InputState input;
+
+    for (uint32_t tick = 0; tick < ticks; ++tick) {
+        // A player joins every 50 ticks, the second one drops at tick 400 and resumes at 700
+        if (tick % 50 == 0 && owned.size() < 6) {
+            PlayerID id = static_cast<PlayerID>(owned.size() + 1);
+            auto player = std::make_unique<ServerPlayer>(id);
+            player->getState().position = world.spawnPlayerPosition(players);
+            player->setViewTick(tick);
+            recorder.recordConnect(tick, id, player->getState().position);
+            players.push_back(player.get());
+            owned.push_back(std::move(player));
+        }
+        if (tick == 400) {
+            recorder.recordDisconnect(tick, players[1]->getId());
+            players.erase(players.begin() + 1);
+        }
+        if (tick == 700) {
+            ServerPlayer* parked = owned[1].get();
+            parked->setViewTick(tick);
+            recorder.recordResume(tick, parked->getState());
+            players.insert(std::upper_bound(players.begin(), players.end(), parked,
+                [](const ServerPlayer* a, const ServerPlayer* b) { return a->getId() < b->getId(); }),
+                parked);
+        }
+
+        for (auto* player : players) {
+            lcg = lcg * 1664525u + 1013904223u;
+            if ((lcg >> 28) < 3) {
+                input.up = (lcg >> 12) & 1;
+                input.down = (lcg >> 13) & 1;
+                input.left = (lcg >> 14) & 1;
+                input.right = (lcg >> 15) & 1;
+            }
+            InputPacket packet;
+            packet.sequenceId = seq++;
+            packet.input = input;
+            world.applyInput(*player, packet);
+            recorder.recordInput(tick, player->getId(), packet);
+        }
+
+        world.checkCollisions(players, tick);
+        if (tick % TICK_RATE == 0) {
+            recorder.recordChecksum(tick, world.stateHash(players));
+        }
+    }
+
+    pickups = 0;
+    for (auto* player : players) {
+        pickups += player->getState().score;
+    }
+
+    recorder.close();
+    return world.stateHash(players);
+}
+
+void testRecordAndReplay() {
+    std::cout << "Test: Recorded match replays to the same state..." << std::endl;
+
+    const uint32_t ticks = 3000;
+    uint32_t pickups = 0;
+    uint64_t liveHash = recordMatch(4242, ticks, pickups);
+    assert(pickups > 0); // exercise seeded coin respawns
+
+    MatchLogHeader header;
+    std::vector<MatchEvent> events;
+    assert(MatchLog::read(LOG_PATH, header, events));
+    assert(header.seed == 4242);
+    assert(header.tickRate == TICK_RATE);
+
+    ReplayResult result = MatchReplay::run(header, events);
+    assert(result.ticks == ticks);
+    assert(result.connects == 6);
+    assert(result.resumes == 1);
+    assert(result.spawnMismatches == 0);
+    assert(result.checksumMismatches == 0);
+    assert(result.checksumsVerified == ticks / TICK_RATE);
+    assert(result.finalHash == liveHash);
+
+    std::remove(LOG_PATH);
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testTruncatedLog() {
+    std::cout << "Test: Truncated log keeps complete records..." << std::endl;
+
+    uint32_t pickups = 0;
+    recordMatch(1, 200, pickups);
+
+    // Chop the last record in half
+    std::FILE* file = std::fopen(LOG_PATH, "rb");
+    std::vector<uint8_t> bytes;
+    int c;
+    while ((c = std::fgetc(file)) != EOF) bytes.push_back(static_cast<uint8_t>(c));
+    std::fclose(file);
+
+    MatchLogHeader header;
+    std::vector<MatchEvent> full;
+    assert(MatchLog::read(LOG_PATH, header, full));
+
+    file = std::fopen(LOG_PATH, "wb");
+    std::fwrite(bytes.data(), 1, bytes.size() - 3, file);
+    std::fclose(file);
+
+    std::vector<MatchEvent> truncated;
+    assert(MatchLog::read(LOG_PATH, header, truncated));
+    assert(truncated.size() == full.size() - 1);
+
+    std::remove(LOG_PATH);
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testCheckpointRoundTrip() {
+    std::cout << "Test: Checkpoint survives a restart, corruption is rejected..." << std::endl;
+
+    GameWorld world(77);
+    std::vector<ServerPlayer*> players;
+    world.spawnCoins(players);
+
+    WorldCheckpoint checkpoint;
+    checkpoint.tick = 12345;
+    checkpoint.coins = world.getCoins();
+    for (uint32_t i = 0; i < 100; ++i) {
+        WorldCheckpoint::Session session;
+        session.token = 0x9e3779b97f4a7c15ULL * (i + 1);
+        session.playerId = i + 1;
+        session.score = i * 3;
+        checkpoint.sessions.push_back(session);
+    }
+
+    CheckpointWriter writer;
+    writer.start(CHECKPOINT_PATH);
+    writer.submit(checkpoint);
+    writer.stop();
+    assert(writer.checkpointsWritten() == 1);
+
+    WorldCheckpoint loaded;
+    assert(WorldCheckpoint::load(CHECKPOINT_PATH, loaded));
+    assert(loaded.tick == checkpoint.tick);
+    assert(loaded.sessions.size() == checkpoint.sessions.size());
+    assert(loaded.sessions[42].token == checkpoint.sessions[42].token);
+    assert(loaded.sessions[42].score == checkpoint.sessions[42].score);
+    assert(loaded.coins.size() == checkpoint.coins.size());
+
+    GameWorld restored(1);
+    restored.restoreCoins(loaded.coins);
+    assert(restored.stateHash(players) == world.stateHash(players));
+
+    // Flip one byte in the middle: the trailer hash must catch it
+    std::FILE* file = std::fopen(CHECKPOINT_PATH, "r+b");
+    std::fseek(file, 40, SEEK_SET);
+    int c = std::fgetc(file);
+    std::fseek(file, 40, SEEK_SET);
+    std::fputc(c ^ 0xff, file);
+    std::fclose(file);
+
+    WorldCheckpoint corrupt;
+    assert(!WorldCheckpoint::load(CHECKPOINT_PATH, corrupt));
+    assert(!WorldCheckpoint::load("does-not-exist.ckpt", corrupt));
+
+    std::remove(CHECKPOINT_PATH);
+    std::cout << "  PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Replay Tests ===" << std::endl;
+
+    testRecordAndReplay();
+    testTruncatedLog();
+    testCheckpointRoundTrip();
+
+    std::cout << "\nAll replay tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,250 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "../include/Shared.hpp"
+#include "../include/GameProtocol.hpp"
+#include "../server/GameServer.hpp"
+#include "../server/ThreadPool.hpp"
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace CoinCollector;
+
+static const uint16_t TEST_PORT = 39287;
+
+struct Client {
+    SocketType socket = INVALID_SOCKET_VALUE;
+    std::vector<uint8_t> received;
+    PlayerID playerId = 0;
+    uint32_t roomId = 0;
+};
+
+/**
+ * Connect and handshake over a raw socket; playerId stays 0 when the
+ * server refuses the connection
+ */
+static Client join(uint32_t requestedRoom) {
+    Client client;
+    client.socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(TEST_PORT);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    assert(connect(client.socket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    fcntl(client.socket, F_SETFL, fcntl(client.socket, F_GETFL, 0) | O_NONBLOCK);
+
+    ByteBuffer request = GameProtocol::serializeHandshake(0, 0, requestedRoom);
+    assert(send(client.socket, request.data(), request.size(), 0) == static_cast<ssize_t>(request.size()));
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+    while (std::chrono::steady_clock::now() < deadline) {
+        uint8_t buffer[2048];
+        ssize_t n = recv(client.socket, buffer, sizeof(buffer), 0);
+        if (n == 0) return client; // refused
+        if (n > 0) client.received.insert(client.received.end(), buffer, buffer + n);
+
+        // A room broadcast queued earlier can arrive ahead of the response
+        while (client.received.size() >= 7) {
+            ByteBuffer packet(client.received);
+            PacketHeader header = GameProtocol::deserializeHeader(packet);
+            size_t total = 7u + header.payloadSize;
+            if (client.received.size() < total) break;
+
+            if (header.type == PacketType::Handshake) {
+                uint64_t token = 0;
+                bool resumed = false;
+                client.playerId = GameProtocol::deserializeHandshakeResponse(
+                    packet, token, resumed, client.roomId);
+            }
+            client.received.erase(client.received.begin(), client.received.begin() + total);
+            if (client.playerId != 0) return client;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    assert(false && "no handshake response");
+    return client;
+}
+
+/**
+ * Read until a world state with the given player count arrives and return its players
+ */
+static std::vector<PlayerState> awaitWorldState(Client& client, size_t playerCount) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+    while (std::chrono::steady_clock::now() < deadline) {
+        uint8_t buffer[4096];
+        ssize_t n = recv(client.socket, buffer, sizeof(buffer), 0);
+        if (n > 0) client.received.insert(client.received.end(), buffer, buffer + n);
+
+        while (client.received.size() >= 7) {
+            ByteBuffer packet(client.received);
+            PacketHeader header = GameProtocol::deserializeHeader(packet);
+            size_t total = 7u + header.payloadSize;
+            if (client.received.size() < total) break;
+
+            std::vector<PlayerState> players;
+            if (header.type == PacketType::WorldState) {
+                uint32_t tick = 0;
+                std::vector<CoinState> coins;
+                assert(GameProtocol::deserializeWorldState(packet, tick, players, coins));
+            }
+            client.received.erase(client.received.begin(), client.received.begin() + total);
+            if (header.type == PacketType::WorldState && players.size() == playerCount) {
+                return players;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    assert(false && "no world state");
+    return {};
+}
+
+void testParallelFor() {
+    std::cout << "Test: parallelFor visits every index exactly once..." << std::endl;
+
+    for (size_t workers : {0u, 1u, 3u}) {
+        ThreadPool pool(workers);
+        assert(pool.getWorkerCount() == workers);
+
+        std::vector<std::atomic<int>> hits(1000);
+        for (int round = 0; round < 200; ++round) {
+            size_t count = 1 + (round * 37) % hits.size();
+            pool.parallelFor(count, [&](size_t i) { hits[i].fetch_add(1); });
+        }
+
+        // Recount what each index should have seen
+        std::vector<int> expected(hits.size(), 0);
+        for (int round = 0; round < 200; ++round) {
+            size_t count = 1 + (round * 37) % hits.size();
+            for (size_t i = 0; i < count; ++i) expected[i]++;
+        }
+        for (size_t i = 0; i < hits.size(); ++i) {
+            assert(hits[i].load() == expected[i]);
+        }
+    }
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testRoomRouting() {
+    std::cout << "Test: Handshakes are routed to rooms by request and capacity..." << std::endl;
+
+    GameServer server(TEST_PORT, 99, 2, 2, 2);
+    assert(server.start());
+    assert(server.getRoomCount() == 1);
+
+    std::atomic<bool> running(true);
+    std::thread loop([&] { server.run(running); });
+
+    Client a = join(0);
+    Client b = join(0);
+    assert(a.roomId == 1 && b.roomId == 1);
+
+    // Room 1 is full: asking for it still lands in a new room
+    Client c = join(1);
+    assert(c.roomId == 2);
+    assert(server.getRoomCount() == 2);
+
+    Client d = join(2);
+    assert(d.roomId == 2);
+
+    // Every room is full and no more may open
+    Client e = join(0);
+    assert(e.playerId == 0);
+
+    // Each room only hears about its own players
+    std::vector<PlayerState> room1 = awaitWorldState(a, 2);
+    assert(room1[0].id == a.playerId && room1[1].id == b.playerId);
+    std::vector<PlayerState> room2 = awaitWorldState(c, 2);
+    assert(room2[0].id == c.playerId && room2[1].id == d.playerId);
+
+    running = false;
+    loop.join();
+    for (Client* client : {&a, &b, &c, &d, &e}) {
+        close(client->socket);
+    }
+    server.stop();
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testCatchUpSendsOneSnapshot() {
+    std::cout << "Test: Catch-up steps queue one snapshot per frame..." << std::endl;
+
+    ServerNetwork network(TEST_PORT);
+    Room room(1, 42, network);
+    room.start();
+
+    // On time: every broadcast tick queues its own snapshot
+    for (uint32_t i = 0; i < 3 * BROADCAST_INTERVAL_TICKS; ++i) {
+        room.tick();
+    }
+    assert(network.getOutgoingQueueDepth() == 3);
+
+    // Nine owed ticks run back to back: the snapshot waits for the last
+    for (uint32_t step = 1; step <= 9; ++step) {
+        room.tick(step == 9);
+        assert(network.getOutgoingQueueDepth() == (step == 9 ? 4u : 3u));
+    }
+    assert(room.getTick() == 3 * BROADCAST_INTERVAL_TICKS + 9);
+
+    room.stop();
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testSheddingDelaysCheckpointBoundedly() {
+    std::cout << "Test: Shedding postpones a checkpoint by at most one interval..." << std::endl;
+
+    const char* path = "test_rooms_shedding.ckpt";
+    const uint32_t interval = Room::CHECKPOINT_INTERVAL_TICKS;
+
+    ServerNetwork network(TEST_PORT);
+    Room room(1, 42, network);
+    room.enableCheckpoints(path);
+    room.start();
+    room.setShedding(true);
+
+    // Due at tick 0, held back while shedding...
+    for (uint32_t i = 0; i < interval; ++i) {
+        room.tick();
+    }
+    assert(room.getCheckpointsSubmitted() == 0);
+
+    // ...until it is one interval late, even though the overload never clears
+    room.tick();
+    assert(room.getCheckpointsSubmitted() == 1);
+    for (uint32_t i = 0; i < 2 * interval; ++i) {
+        room.tick();
+    }
+    assert(room.getCheckpointsSubmitted() == 2);
+
+    // Once the overload clears, a due checkpoint goes out on time again
+    room.setShedding(false);
+    while (room.getTick() % interval != 0) {
+        room.tick();
+    }
+    room.tick();
+    assert(room.getCheckpointsSubmitted() == 3);
+
+    room.stop();
+    std::remove(path);
+    std::cout << "  PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Room Tests ===" << std::endl;
+
+    testParallelFor();
+    testRoomRouting();
+    testCatchUpSendsOneSnapshot();
+    testSheddingDelaysCheckpointBoundedly();
+
+    std::cout << "\nAll room tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,415 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "../include/Shared.hpp"
+#include "../include/GameProtocol.hpp"
+#include "../server/GameServer.hpp"
+#include "../server/GameWorld.hpp"
+#include "../server/Room.hpp"
+#include "../server/ShardLink.hpp"
+#include "../client/ClientNetwork.hpp"
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace CoinCollector;
+
+static const uint16_t BASE_PORT = 39387;
+static const uint32_t SHARDS = 2;
+
+static std::atomic<bool> g_shardRunning(true);
+
+struct Client {
+    SocketType socket = INVALID_SOCKET_VALUE;
+    std::vector<uint8_t> received;
+    PlayerID playerId = 0;
+    uint64_t token = 0;
+    bool resumed = false;
+};
+
+static bool connectTo(Client& client, uint16_t port) {
+    client.socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (connect(client.socket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(client.socket);
+        client.socket = INVALID_SOCKET_VALUE;
+        return false;
+    }
+    fcntl(client.socket, F_SETFL, fcntl(client.socket, F_GETFL, 0) | O_NONBLOCK);
+    client.received.clear();
+    return true;
+}
+
+/**
+ * Pull complete packets off the socket, newest last
+ */
+static std::vector<std::pair<PacketHeader, ByteBuffer>> readPackets(Client& client) {
+    uint8_t buffer[4096];
+    ssize_t n;
+    while ((n = recv(client.socket, buffer, sizeof(buffer), 0)) > 0) {
+        client.received.insert(client.received.end(), buffer, buffer + n);
+    }
+
+    std::vector<std::pair<PacketHeader, ByteBuffer>> packets;
+    while (client.received.size() >= 7) {
+        ByteBuffer packet(client.received);
+        PacketHeader header = GameProtocol::deserializeHeader(packet);
+        size_t total = 7u + header.payloadSize;
+        if (client.received.size() < total) break;
+        packets.emplace_back(header, ByteBuffer(std::vector<uint8_t>(
+            client.received.begin() + 7, client.received.begin() + total)));
+        client.received.erase(client.received.begin(), client.received.begin() + total);
+    }
+    return packets;
+}
+
+static void handshake(Client& client) {
+    ByteBuffer request = GameProtocol::serializeHandshake(0, client.token, 0);
+    assert(send(client.socket, request.data(), request.size(), 0) == static_cast<ssize_t>(request.size()));
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+    while (std::chrono::steady_clock::now() < deadline) {
+        for (auto& packet : readPackets(client)) {
+            if (packet.first.type != PacketType::Handshake) continue;
+            uint32_t roomId = 0;
+            client.playerId = GameProtocol::deserializeHandshakeResponse(
+                packet.second, client.token, client.resumed, roomId);
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    assert(false && "no handshake response");
+}
+
+static void sendInput(Client& client, SequenceID seq, bool right) {
+    InputState input;
+    input.right = right;
+    ByteBuffer packet = GameProtocol::serializeInput(seq, input, 0);
+    send(client.socket, packet.data(), packet.size(), 0);
+}
+
+/**
+ * Child process body: one shard server until SIGTERM
+ */
+static void runShard(uint32_t index, const std::string& socketPrefix) {
+    std::signal(SIGTERM, [](int) { g_shardRunning = false; });
+    {
+        ShardMap map;
+        map.index = index;
+        map.count = SHARDS;
+        map.basePort = BASE_PORT;
+
+        GameServer server(map.portOf(index), 500 + index);
+        server.enableSharding(map, socketPrefix);
+        if (!server.start()) _exit(1);
+        server.run(g_shardRunning);
+        server.stop();
+    }
+    _exit(0);
+}
+
+static std::vector<pid_t> startShards(const std::string& socketPrefix) {
+    std::vector<pid_t> shards;
+    for (uint32_t i = 0; i < SHARDS; ++i) {
+        pid_t pid = fork();
+        assert(pid >= 0);
+        if (pid == 0) runShard(i, socketPrefix);
+        shards.push_back(pid);
+    }
+    return shards;
+}
+
+static void stopShards(const std::vector<pid_t>& shards) {
+    for (pid_t pid : shards) {
+        kill(pid, SIGTERM);
+        int status = 0;
+        assert(waitpid(pid, &status, 0) == pid);
+        assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+}
+
+void testShardMap() {
+    std::cout << "Test: Shard map cuts the world into strips..." << std::endl;
+
+    ShardMap map;
+    map.count = 3;
+    map.basePort = 9000;
+    assert(map.minX(0) == 0.0f && map.maxX(2) == WORLD_WIDTH);
+    assert(map.maxX(0) == map.minX(1));
+    assert(map.ownerOf(-5.0f) == 0);
+    assert(map.ownerOf(map.minX(1)) == 1);
+    assert(map.ownerOf(map.minX(1) - 0.5f) == 0);
+    assert(map.ownerOf(WORLD_WIDTH + 10.0f) == 2);
+    assert(map.portOf(2) == 9002);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testRegionAndClaims() {
+    std::cout << "Test: Shard world spawns in its strip and validates claims..." << std::endl;
+
+    GameWorld world(3);
+    world.setLogPickups(false);
+    world.setRegion(480.0f, 960.0f, 5, 10);
+    std::vector<ServerPlayer*> players;
+    world.spawnCoins(players);
+
+    assert(world.getCoins().size() == 5);
+    for (const auto& coin : world.getCoins()) {
+        assert(coin.id >= 10 && coin.id < 15);
+        assert(coin.position.x >= 480.0f + COIN_RADIUS && coin.position.x < 960.0f - COIN_RADIUS);
+    }
+
+    CoinState coin = world.getCoins()[2];
+    assert(!world.claimCoin(coin.id, Vec2(coin.position.x + 1.0f, coin.position.y), players));
+    assert(!world.claimCoin(99, coin.position, players));
+    assert(world.claimCoin(coin.id, coin.position, players));
+    // The coin moved, so a second claim on the old spot is stale
+    assert(!world.claimCoin(coin.id, coin.position, players));
+    assert(world.getCoins()[2].active);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testShardClocksOnlyMoveForward() {
+    std::cout << "Test: Shard clocks resync forward, never back..." << std::endl;
+
+    ShardMap map;
+    map.index = 1;
+    map.count = SHARDS;
+    map.basePort = BASE_PORT;
+    ShardLink link(map.index, map.count, "/tmp/coincollector-test-clock");
+
+    ServerNetwork network(BASE_PORT + 5);
+    Room room(1, 42, network);
+    room.enableSharding(map, link);
+    room.start();
+    for (int i = 0; i < 600; ++i) {
+        room.tick();
+    }
+
+    // A Ghosts payload as ShardLink hands it over: frame header already read
+    auto ghostsAt = [](uint32_t tick) {
+        ByteBuffer framed = ShardProtocol::serializeGhosts(tick, std::vector<PlayerState>(),
+                                                           std::vector<CoinState>());
+        framed.readUint8();
+        framed.readUint32();
+        return framed;
+    };
+
+    // Shard 0 restarted from an old checkpoint: this shard keeps its clock
+    ByteBuffer behind = ghostsAt(300);
+    room.onShardMessage(0, ShardMessage::Ghosts, behind);
+    assert(room.getTick() == 600);
+
+    // Small drift is left alone, a shard further ahead is followed
+    ByteBuffer close = ghostsAt(600 + SHARD_TICK_TOLERANCE);
+    room.onShardMessage(0, ShardMessage::Ghosts, close);
+    assert(room.getTick() == 600);
+    ByteBuffer ahead = ghostsAt(900);
+    room.onShardMessage(0, ShardMessage::Ghosts, ahead);
+    assert(room.getTick() == 900);
+
+    room.stop();
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testHandoffAcrossProcesses() {
+    std::cout << "Test: Player crossing the border moves to the next shard process..." << std::endl;
+
+    std::string socketPrefix = "/tmp/TestSharding-" + std::to_string(getpid());
+    std::vector<pid_t> shards = startShards(socketPrefix);
+
+    // Wait for both shards to take clients
+    Client watcher, runner;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!connectTo(watcher, BASE_PORT + 1)) {
+        assert(std::chrono::steady_clock::now() < deadline);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    while (!connectTo(runner, BASE_PORT)) {
+        assert(std::chrono::steady_clock::now() < deadline);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    handshake(watcher);
+    handshake(runner);
+    assert(watcher.playerId == SHARD_PLAYER_ID_BLOCK + 1);
+    assert(runner.playerId == 1);
+    PlayerID runnerId = runner.playerId;
+    uint64_t runnerToken = runner.token;
+
+    // Run right until shard 0 hands us over; meanwhile the world must look whole
+    bool sawWatcher = false, sawBothStrips = false;
+    uint16_t redirectPort = 0;
+    SequenceID seq = 1;
+    deadline = std::chrono::steady_clock::now() + std::chrono::seconds(8);
+    while (redirectPort == 0 && std::chrono::steady_clock::now() < deadline) {
+        sendInput(runner, seq++, true);
+        sendInput(watcher, seq, false);
+        readPackets(watcher);
+
+        for (auto& packet : readPackets(runner)) {
+            if (packet.first.type == PacketType::Redirect) {
+                redirectPort = GameProtocol::deserializeRedirect(packet.second);
+            } else if (packet.first.type == PacketType::WorldState) {
+                uint32_t tick = 0;
+                std::vector<PlayerState> players;
+                std::vector<CoinState> coins;
+                GameProtocol::deserializeWorldState(packet.second, tick, players, coins);
+                for (const auto& player : players) {
+                    if (player.id == watcher.playerId) sawWatcher = true;
+                }
+                bool low = false, high = false;
+                for (const auto& coin : coins) {
+                    (coin.id < MAX_COINS ? low : high) = true;
+                }
+                if (low && high) sawBothStrips = true;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(16));
+    }
+
+    assert(redirectPort == BASE_PORT + 1);
+    assert(sawWatcher);
+    assert(sawBothStrips);
+
+    // Resume on shard 1 as the same player
+    close(runner.socket);
+    assert(connectTo(runner, redirectPort));
+    handshake(runner);
+    assert(runner.resumed);
+    assert(runner.playerId == runnerId);
+    assert(runner.token == runnerToken);
+
+    // And shard 1 now simulates it, further right than shard 0 ever keeps a player
+    float shard0Limit = WORLD_WIDTH / SHARDS + SHARD_HANDOFF_MARGIN + MAX_PLAYER_SPEED * FIXED_DT;
+    bool ownedByShard1 = false;
+    deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+    while (!ownedByShard1 && std::chrono::steady_clock::now() < deadline) {
+        sendInput(runner, seq++, true);
+        sendInput(watcher, seq, false);
+        readPackets(runner);
+        for (auto& packet : readPackets(watcher)) {
+            if (packet.first.type != PacketType::WorldState) continue;
+            uint32_t tick = 0;
+            std::vector<PlayerState> players;
+            std::vector<CoinState> coins;
+            GameProtocol::deserializeWorldState(packet.second, tick, players, coins);
+            for (const auto& player : players) {
+                if (player.id == runnerId && player.position.x > shard0Limit) ownedByShard1 = true;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(16));
+    }
+    assert(ownedByShard1);
+
+    close(runner.socket);
+    close(watcher.socket);
+    stopShards(shards);
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testClientPlaysThroughHandoff() {
+    std::cout << "Test: Client keeps its frames and snapshots through a handoff..." << std::endl;
+
+    std::string socketPrefix = "/tmp/TestSharding-client-" + std::to_string(getpid());
+    std::vector<pid_t> shards = startShards(socketPrefix);
+
+    // The real client's network driven by a 60 Hz frame loop, running right
+    ClientNetwork network("127.0.0.1", BASE_PORT);
+    WorldStatePacket state;
+    PlayerID playerId = 0;
+    int joins = 0;
+    SequenceID seq = 1;
+    uint32_t lastTick = 0, largestTickGap = 0;
+    int snapshots = 0, snapshotsWhileJoining = 0, snapshotsAfterHandoff = 0;
+    auto slowestFrame = std::chrono::steady_clock::duration::zero();
+
+    const auto period = std::chrono::microseconds(16667);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    auto nextFrame = std::chrono::steady_clock::now();
+    while (snapshotsAfterHandoff < 10 && std::chrono::steady_clock::now() < deadline) {
+        auto frameStart = std::chrono::steady_clock::now();
+
+        if (network.getLink() == ClientNetwork::Link::Offline) {
+            assert(joins == 0); // only while the shards are still starting
+            network.join(0);
+        }
+        if (network.pollJoined()) {
+            joins++;
+            if (joins == 1) {
+                playerId = network.getPlayerId();
+            } else {
+                // Redirected and adopted by shard 1 as the same player
+                assert(network.wasResumed());
+                assert(network.getPlayerId() == playerId);
+                assert(network.getPort() == BASE_PORT + 1);
+            }
+        }
+
+        if (joins > 0) {
+            InputState input;
+            input.right = true;
+            network.send(GameProtocol::serializeInput(seq++, input, lastTick));
+        }
+        network.update();
+
+        while (network.popWorldState(state)) {
+            // The full snapshot sent on resume may repeat a broadcast's tick
+            assert(state.tick >= lastTick);
+            if (lastTick != 0) largestTickGap = std::max(largestTickGap, state.tick - lastTick);
+            lastTick = state.tick;
+            snapshots++;
+            if (network.getLink() == ClientNetwork::Link::Joining) snapshotsWhileJoining++;
+            if (joins >= 2) snapshotsAfterHandoff++;
+        }
+
+        slowestFrame = std::max(slowestFrame, std::chrono::steady_clock::now() - frameStart);
+        nextFrame += period;
+        std::this_thread::sleep_until(nextFrame);
+    }
+
+    auto slowestMs = std::chrono::duration_cast<std::chrono::milliseconds>(slowestFrame).count();
+    std::cout << "  " << snapshots << " snapshots, " << snapshotsWhileJoining << " while rejoining, largest gap "
+              << largestTickGap << " ticks, slowest frame " << slowestMs << " ms" << std::endl;
+
+    assert(joins == 2);
+    assert(snapshotsAfterHandoff >= 10);
+    // Frames never wait for the new shard; a blocking rejoin stalls one for a 400 ms round trip
+    assert(slowestMs < 100);
+    // Snapshots queued before the redirect keep playing while the client rejoins,
+    // so the stream pauses for less than the handshake's round trip
+    assert(snapshotsWhileJoining > 0);
+    uint32_t roundTripTicks = 2 * SIMULATED_LATENCY_MS * TICK_RATE / 1000;
+    assert(largestTickGap < roundTripTicks);
+
+    network.disconnect();
+    stopShards(shards);
+    std::cout << "  PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Sharding Tests ===" << std::endl;
+
+    testShardMap();
+    testRegionAndClaims();
+    testShardClocksOnlyMoveForward();
+    testHandoffAcrossProcesses();
+    testClientPlaysThroughHandoff();
+
+    std::cout << "\nAll sharding tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,223 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "../include/Shared.hpp"
+#include "../include/GameProtocol.hpp"
+#include "../include/ShmTransport.hpp"
+#include "../server/ServerNetwork.hpp"
+#include "../server/ServerPlayer.hpp"
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace CoinCollector;
+
+static const uint16_t TEST_PORT = 39487;
+
+void testRingWraparound() {
+    std::cout << "Test: Ring wraps around and never splits a packet..." << std::endl;
+
+    const uint32_t capacity = 64;
+    std::vector<uint64_t> memory(ShmRing::bytesFor(capacity) / sizeof(uint64_t) + 1);
+    ShmRing ring(memory.data(), capacity);
+    ring.reset();
+
+    // Odd-sized packets walk the offsets through every wrap position
+    uint8_t packet[23];
+    uint8_t out[64];
+    for (uint32_t round = 0; round < 100; ++round) {
+        for (size_t i = 0; i < sizeof(packet); ++i) packet[i] = static_cast<uint8_t>(round + i);
+        assert(ring.write(packet, sizeof(packet)));
+        assert(ring.read(out, sizeof(out)) == sizeof(packet));
+        for (size_t i = 0; i < sizeof(packet); ++i) assert(out[i] == packet[i]);
+    }
+
+    // Full ring: the packet that does not fit is dropped whole
+    assert(ring.write(packet, sizeof(packet)));
+    assert(ring.write(packet, sizeof(packet)));
+    assert(!ring.write(packet, sizeof(packet)));
+    assert(ring.write(packet, capacity - 2 * sizeof(packet)));
+    assert(ring.read(out, sizeof(out)) == capacity);
+    assert(ring.read(out, sizeof(out)) == 0);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testSlotLifecycle() {
+    std::cout << "Test: Slots are claimed, drained on close and reused..." << std::endl;
+
+    const std::string name = Shm::nameForPort(TEST_PORT);
+    assert(!Shm::connect(name)); // no server yet
+
+    Shm::Listener listener(name);
+    assert(listener.initialize(2, 1024));
+    assert(!listener.accept());
+
+    auto a = Shm::connect(name);
+    auto b = Shm::connect(name);
+    assert(a && b);
+    assert(!Shm::connect(name)); // both slots taken
+
+    auto serverA = listener.accept();
+    auto serverB = listener.accept();
+    assert(serverA && serverB);
+    assert(!listener.accept());
+
+    const uint8_t hello[] = {1, 2, 3, 4, 5};
+    uint8_t buffer[64];
+    assert(a->send(hello, sizeof(hello)));
+    assert(serverA->receive(buffer, sizeof(buffer)) == static_cast<int>(sizeof(hello)));
+    assert(serverB->receive(buffer, sizeof(buffer)) == 0);
+    assert(serverA->send(hello, 3));
+    assert(a->receive(buffer, sizeof(buffer)) == 3);
+
+    // Bytes sent before a close still arrive, then the reader sees -1
+    assert(b->send(hello, sizeof(hello)));
+    b->close();
+    assert(!b->send(hello, sizeof(hello)));
+    assert(serverB->receive(buffer, sizeof(buffer)) == static_cast<int>(sizeof(hello)));
+    assert(serverB->receive(buffer, sizeof(buffer)) == -1);
+    assert(!serverB->send(hello, sizeof(hello)));
+
+    // The slot frees only once both ends let go
+    assert(!Shm::connect(name));
+    serverB.reset();
+    auto c = Shm::connect(name);
+    assert(c);
+    assert(listener.accept());
+
+    // Open connections outlive the listener's name
+    listener.shutdown();
+    assert(!Shm::connect(name));
+    assert(a->send(hello, 1));
+    assert(serverA->receive(buffer, sizeof(buffer)) == 1);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testKilledClientFreesSlot() {
+    std::cout << "Test: A client that dies without closing gives its slot back..." << std::endl;
+
+    const std::string name = Shm::nameForPort(TEST_PORT + 2);
+    Shm::Listener listener(name);
+    assert(listener.initialize(1, 1024));
+
+    // The child claims the only slot and exits without close(), like a killed bot
+    pid_t child = fork();
+    assert(child >= 0);
+    if (child == 0) {
+        auto connection = Shm::connect(name);
+        if (!connection) _exit(1);
+        connection.release();
+        _exit(0);
+    }
+    int status = 0;
+    assert(waitpid(child, &status, 0) == child);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    auto orphan = listener.accept();
+    assert(orphan);
+    assert(!Shm::connect(name)); // still taken until the server lets go
+
+    // Reaping the silent connection frees the slot even though CLIENT_CLOSED was never set
+    orphan->close();
+    auto next = Shm::connect(name);
+    assert(next);
+    auto serverNext = listener.accept();
+    assert(serverNext);
+
+    // A live client keeps its slot until it closes too
+    serverNext.reset();
+    assert(!Shm::connect(name));
+    next.reset();
+    assert(Shm::connect(name));
+
+    listener.shutdown();
+    std::cout << "  PASSED" << std::endl;
+}
+
+static void pumpUntil(ServerNetwork& network, const std::function<bool()>& done) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+    while (!done() && std::chrono::steady_clock::now() < deadline) {
+        network.update();
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    assert(done());
+}
+
+void testServerOverSharedMemory() {
+    std::cout << "Test: Server plays a session over shared memory..." << std::endl;
+
+    ServerNetwork network(TEST_PORT + 1);
+    assert(network.initialize());
+    assert(network.enableSharedMemory());
+
+    int connects = 0, disconnects = 0;
+    network.setConnectionCallbacks(
+        [&](ServerPlayer&, bool) { connects++; },
+        [&](const ServerPlayer&) { disconnects++; });
+
+    auto client = Shm::connect(Shm::nameForPort(TEST_PORT + 1));
+    assert(client);
+    ByteBuffer request = GameProtocol::serializeHandshake(0, 0, 0);
+    assert(client->send(request.data(), request.size()));
+
+    std::vector<uint8_t> received;
+    auto collect = [&] {
+        uint8_t buffer[512];
+        int n = client->receive(buffer, sizeof(buffer));
+        if (n > 0) received.insert(received.end(), buffer, buffer + n);
+    };
+
+    pumpUntil(network, [&] { collect(); return received.size() >= 7; });
+    ByteBuffer response(received);
+    PacketHeader header = GameProtocol::deserializeHeader(response);
+    assert(header.type == PacketType::Handshake);
+    pumpUntil(network, [&] { collect(); return received.size() >= 7u + header.payloadSize; });
+
+    response = ByteBuffer(received);
+    GameProtocol::deserializeHeader(response);
+    uint64_t token = 0;
+    bool resumed = false;
+    uint32_t roomId = 0;
+    assert(GameProtocol::deserializeHandshakeResponse(response, token, resumed, roomId) == 1);
+    assert(connects == 1);
+    assert(network.getPlayers().size() == 1);
+
+    // Input goes up the ring and lands on the player
+    InputState input;
+    input.right = true;
+    ByteBuffer packet = GameProtocol::serializeInput(42, input, 0);
+    assert(client->send(packet.data(), packet.size()));
+    InputPacket applied;
+    applied.sequenceId = 0;
+    pumpUntil(network, [&] { return applied.sequenceId != 0 || network.getPlayers()[0]->popInput(applied); });
+    assert(applied.sequenceId == 42 && applied.input.right);
+
+    // Closing the client end parks the player like a dropped socket
+    client->close();
+    pumpUntil(network, [&] { return disconnects == 1; });
+    assert(network.getPlayers().empty());
+    assert(network.getParkedPlayers().size() == 1);
+
+    network.shutdown();
+    std::cout << "  PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Shared Memory Transport Tests ===" << std::endl;
+
+    testRingWraparound();
+    testSlotLifecycle();
+    testKilledClientFreesSlot();
+    testServerOverSharedMemory();
+
+    std::cout << "\nAll shared memory transport tests passed!" << std::endl;
+    return 0;
+}
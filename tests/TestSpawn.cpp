@@ -0,0 +1,138 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "../include/Shared.hpp"
+#include "../include/Random.hpp"
+#include "../server/ServerPlayer.hpp"
+#include "../server/SpawnGenerator.hpp"
+#include <algorithm>
+#include <iostream>
+#include <cassert>
+#include <limits>
+#include <memory>
+#include <vector>
+
+using namespace CoinCollector;
+
+/**
+ * A world crowded with players and coins, laid out from its own seed
+ */
+struct CrowdedWorld {
+    std::vector<std::unique_ptr<ServerPlayer>> owned;
+    std::vector<ServerPlayer*> players;
+    std::vector<CoinState> coins;
+
+    explicit CrowdedWorld(uint64_t seed) {
+        Pcg32 rng(seed);
+        for (PlayerID id = 1; id <= 48; ++id) {
+            owned.push_back(std::make_unique<ServerPlayer>(id));
+            owned.back()->getState().position =
+                Vec2(rng.nextRange(PLAYER_RADIUS, WORLD_WIDTH - PLAYER_RADIUS),
+                     rng.nextRange(PLAYER_RADIUS, WORLD_HEIGHT - PLAYER_RADIUS));
+            players.push_back(owned.back().get());
+        }
+        for (uint32_t id = 0; id < 24; ++id) {
+            CoinState coin;
+            coin.id = id;
+            coin.position = Vec2(rng.nextRange(COIN_RADIUS, WORLD_WIDTH - COIN_RADIUS),
+                                 rng.nextRange(COIN_RADIUS, WORLD_HEIGHT - COIN_RADIUS));
+            coin.active = true;
+            coins.push_back(coin);
+        }
+    }
+
+    // Gap between a spawn of this radius and the nearest player or coin edge
+    float clearance(const Vec2& at, float radius) const {
+        float gap = std::numeric_limits<float>::max();
+        for (const auto* player : players) {
+            gap = std::min(gap, (player->getState().position - at).length() - PLAYER_RADIUS - radius);
+        }
+        for (const auto& coin : coins) {
+            gap = std::min(gap, (coin.position - at).length() - COIN_RADIUS - radius);
+        }
+        return gap;
+    }
+};
+
+void testBeatsUniformSampling() {
+    std::cout << "Test: Spawns in a crowded world keep more room than uniform samples..." << std::endl;
+
+    const int SPAWNS = 500;
+    CrowdedWorld world(7);
+
+    for (float radius : {COIN_RADIUS, PLAYER_RADIUS}) {
+        SpawnGenerator spawner(99);
+        Pcg32 naive(99);
+
+        double spawnerTotal = 0.0, naiveTotal = 0.0;
+        int spawnerOverlaps = 0, naiveOverlaps = 0;
+        for (int i = 0; i < SPAWNS; ++i) {
+            Vec2 spawned = radius == COIN_RADIUS ? spawner.coinPosition(world.players, world.coins)
+                                                 : spawner.playerPosition(world.players, world.coins);
+            Vec2 uniform(naive.nextRange(radius, WORLD_WIDTH - radius),
+                         naive.nextRange(radius, WORLD_HEIGHT - radius));
+
+            float spawnedGap = world.clearance(spawned, radius);
+            float uniformGap = world.clearance(uniform, radius);
+            spawnerTotal += spawnedGap;
+            naiveTotal += uniformGap;
+            if (spawnedGap < 0.0f) spawnerOverlaps++;
+            if (uniformGap < 0.0f) naiveOverlaps++;
+        }
+
+        std::cout << "  radius " << radius << ": mean clearance " << spawnerTotal / SPAWNS
+                  << " vs " << naiveTotal / SPAWNS << " uniform; overlaps " << spawnerOverlaps
+                  << " vs " << naiveOverlaps << std::endl;
+
+        // Best of several candidates must be clearly roomier, and almost never overlap
+        assert(spawnerTotal > 2.0 * naiveTotal);
+        assert(naiveOverlaps > 0);
+        assert(spawnerOverlaps * 10 < naiveOverlaps);
+    }
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testSeededSpawnsRepeat() {
+    std::cout << "Test: Spawns repeat exactly for a fixed seed..." << std::endl;
+
+    CrowdedWorld world(7);
+    SpawnGenerator first(1234);
+    SpawnGenerator second(1234);
+    SpawnGenerator other(4321);
+
+    bool differs = false;
+    for (int i = 0; i < 200; ++i) {
+        Vec2 a = i % 2 ? first.coinPosition(world.players, world.coins)
+                       : first.playerPosition(world.players, world.coins);
+        Vec2 b = i % 2 ? second.coinPosition(world.players, world.coins)
+                       : second.playerPosition(world.players, world.coins);
+        Vec2 c = i % 2 ? other.coinPosition(world.players, world.coins)
+                       : other.playerPosition(world.players, world.coins);
+        assert(a.x == b.x && a.y == b.y);
+        if (a.x != c.x || a.y != c.y) differs = true;
+    }
+    assert(differs);
+
+    // Reseeding starts the same sequence over
+    first.reseed(1234);
+    SpawnGenerator fresh(1234);
+    for (int i = 0; i < 20; ++i) {
+        Vec2 a = first.coinPosition(world.players, world.coins);
+        Vec2 b = fresh.coinPosition(world.players, world.coins);
+        assert(a.x == b.x && a.y == b.y);
+    }
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Spawn Tests ===" << std::endl;
+
+    testBeatsUniformSampling();
+    testSeededSpawnsRepeat();
+
+    std::cout << "\nAll spawn tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,111 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "../include/Random.hpp"
+#include "../server/TimerWheel.hpp"
+#include <algorithm>
+#include <iostream>
+#include <cassert>
+#include <map>
+#include <vector>
+
+using namespace CoinCollector;
+
+void testFiresOnDeadline() {
+    std::cout << "Test: Timers fire exactly on their deadline at every level..." << std::endl;
+
+    TimerWheel wheel;
+    const std::vector<uint64_t> deadlines = {1, 63, 64, 65, 4095, 4096, 4097, 300000, 20000000};
+    for (size_t i = 0; i < deadlines.size(); ++i) {
+        wheel.schedule(i, deadlines[i]);
+    }
+    assert(wheel.size() == deadlines.size());
+
+    std::map<uint64_t, uint64_t> firedAt;
+    for (uint64_t now = 1; now <= 20000000; now += 1 + (now % 7)) {
+        wheel.advance(now, [&](uint64_t key) { firedAt[key] = wheel.getNow(); });
+    }
+    wheel.advance(20000000, [&](uint64_t key) { firedAt[key] = wheel.getNow(); });
+
+    assert(firedAt.size() == deadlines.size());
+    for (size_t i = 0; i < deadlines.size(); ++i) {
+        assert(firedAt[i] == deadlines[i]);
+    }
+    assert(wheel.size() == 0);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testMatchesReference() {
+    std::cout << "Test: Random schedule/cancel matches a naive reference..." << std::endl;
+
+    TimerWheel wheel;
+    std::map<uint64_t, uint64_t> reference; // key -> deadline
+    Pcg32 rng(99);
+
+    for (uint64_t now = 1; now <= 50000; ++now) {
+        for (int i = 0; i < 4; ++i) {
+            uint64_t key = rng.nextBounded(2000);
+            uint32_t action = rng.nextBounded(10);
+            if (action < 7) {
+                uint64_t deadline = now + rng.nextBounded(action < 5 ? 100 : 20000);
+                wheel.schedule(key, deadline);
+                reference[key] = deadline;
+            } else {
+                assert(wheel.cancel(key) == (reference.erase(key) == 1));
+            }
+        }
+
+        std::vector<uint64_t> fired;
+        wheel.advance(now, [&](uint64_t key) { fired.push_back(key); });
+
+        std::vector<uint64_t> due;
+        for (auto it = reference.begin(); it != reference.end();) {
+            if (it->second <= now) {
+                due.push_back(it->first);
+                it = reference.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        std::sort(fired.begin(), fired.end());
+        assert(fired == due);
+        assert(wheel.size() == reference.size());
+    }
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testRescheduleFromCallback() {
+    std::cout << "Test: Callback can re-arm and cancel timers..." << std::endl;
+
+    TimerWheel wheel;
+    wheel.schedule(1, 10);
+    wheel.schedule(2, 10);
+    int fires = 0;
+
+    wheel.advance(100, [&](uint64_t key) {
+        fires++;
+        if (key == 1) {
+            wheel.cancel(2);           // still queued in the same slot
+            if (fires < 5) wheel.schedule(1, wheel.getNow() + 10);
+        }
+    });
+
+    assert(fires == 5);
+    assert(wheel.size() == 0);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Timer Wheel Tests ===" << std::endl;
+
+    testFiresOnDeadline();
+    testMatchesReference();
+    testRescheduleFromCallback();
+
+    std::cout << "\nAll timer wheel tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,125 @@
+//
+// Created by bansal3112 on 29/11/25.
+//
+
+#include "../include/Trace.hpp"
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace CoinCollector;
+
+static const char* TRACE_PATH = "TestTrace.json";
+
+static std::string readFile(const char* path) {
+    std::ifstream file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+static size_t countOf(const std::string& text, const std::string& needle) {
+    size_t count = 0;
+    for (size_t at = text.find(needle); at != std::string::npos; at = text.find(needle, at + 1)) {
+        count++;
+    }
+    return count;
+}
+
+void testDisabledRecordsNothing() {
+    std::cout << "Test: Scopes outside a capture leave no events..." << std::endl;
+
+    assert(!Trace::enabled());
+    for (int i = 0; i < 1000; ++i) {
+        TRACE_SCOPE("test", "idle");
+    }
+
+    Trace::start();
+    assert(Trace::enabled());
+    assert(Trace::stop(TRACE_PATH));
+    assert(!Trace::enabled());
+
+    std::string json = readFile(TRACE_PATH);
+    assert(json.find("\"traceEvents\"") != std::string::npos);
+    assert(countOf(json, "\"idle\"") == 0);
+
+    std::remove(TRACE_PATH);
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testThreadsAndNesting() {
+    std::cout << "Test: Nested scopes on several threads land in Chrome trace JSON..." << std::endl;
+
+    Trace::setThreadName("main");
+    Trace::start();
+
+    {
+        TRACE_SCOPE("test", "outer");
+        for (int i = 0; i < 10; ++i) {
+            TRACE_SCOPE("test", "inner");
+        }
+    }
+
+    std::thread worker([] {
+        Trace::setThreadName("helper \"one\"");
+        for (int i = 0; i < 5; ++i) {
+            TRACE_SCOPE("test", "work");
+        }
+    });
+    worker.join();
+
+    assert(Trace::stop(TRACE_PATH));
+    std::string json = readFile(TRACE_PATH);
+
+    assert(countOf(json, "\"name\":\"outer\"") == 1);
+    assert(countOf(json, "\"name\":\"inner\"") == 10);
+    assert(countOf(json, "\"name\":\"work\"") == 5); // events of a finished thread survive
+    assert(countOf(json, "\"ph\":\"X\"") == 16);
+    assert(json.find("\"args\":{\"name\":\"main\"}") != std::string::npos);
+    assert(json.find("helper \\\"one\\\"") != std::string::npos);
+
+    // A second capture only holds its own events
+    Trace::start();
+    { TRACE_SCOPE("test", "again"); }
+    assert(Trace::stop(TRACE_PATH));
+    json = readFile(TRACE_PATH);
+    assert(countOf(json, "\"ph\":\"X\"") == 1);
+
+    std::remove(TRACE_PATH);
+    std::cout << "  PASSED" << std::endl;
+}
+
+void testRingKeepsNewest() {
+    std::cout << "Test: A full thread ring keeps the newest events..." << std::endl;
+
+    Trace::start();
+    std::thread busy([] {
+        for (size_t i = 0; i < Trace::THREAD_CAPACITY + 100; ++i) {
+            TRACE_SCOPE("test", i < 100 ? "old" : "new");
+        }
+    });
+    busy.join();
+
+    assert(Trace::stop(TRACE_PATH));
+    std::string json = readFile(TRACE_PATH);
+    assert(countOf(json, "\"name\":\"old\"") == 0);
+    assert(countOf(json, "\"name\":\"new\"") == Trace::THREAD_CAPACITY);
+
+    std::remove(TRACE_PATH);
+    std::cout << "  PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Trace Tests ===" << std::endl;
+
+    testDisabledRecordsNothing();
+    testThreadsAndNesting();
+    testRingKeepsNewest();
+
+    std::cout << "\nAll trace tests passed!" << std::endl;
+    return 0;
+}